@@ -5,6 +5,8 @@
 #ifndef _COMPARISONS_H
 #define _COMPARISONS_H
 
+#include <stdbool.h>
+
 // return values all comparison functions should use for standardizing
 // behavior
 typedef enum comp_rtns
@@ -23,6 +25,13 @@ typedef enum comp_rtns
  */
 typedef comp_rtns_t (*CMP_F)(void *, void *);
 
+/**
+ * @brief A pointer to a user-defined function that tests data against a
+ * condition, with a caller supplied context
+ *
+ */
+typedef bool (*PRED_F)(void * data, void * context);
+
 /**
  * @brief Fuction to compare integer data inside two void sources
  *
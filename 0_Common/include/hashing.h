@@ -0,0 +1,97 @@
+/** @file hashing.h
+ *
+ * @brief Module for hashing keys for the datastructures.
+ */
+#ifndef _HASHING_H
+#define _HASHING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A pointer to a user-defined hash function. Keys the compare
+ * function reports as equal must hash the same.
+ *
+ */
+typedef uint64_t (*HASH_F)(void *);
+
+/**
+ * @brief Hashes a run of bytes in the style of wyhash. Inputs up to 16 bytes
+ * take a single 128-bit multiply, longer ones are consumed 48 bytes at a time
+ * over three independent lanes. Every input bit affects every output bit
+ *
+ * @param data pointer to the bytes, may be NULL if length is 0
+ * @param length number of bytes to hash
+ * @param seed seed mixed into the hash. a secret random seed keeps callers
+ * from choosing keys that collide
+ * @return 64-bit hash of the bytes
+ */
+uint64_t hash_bytes(const void * data, size_t length, uint64_t seed);
+
+/**
+ * @brief Mixes a 32-bit integer into a well distributed 32-bit hash. the
+ * mixer is a bijection, so distinct inputs never collide
+ *
+ * @param value integer to mix
+ * @return 32-bit hash of the integer
+ */
+uint32_t hash_u32(uint32_t value);
+
+/**
+ * @brief Mixes a 64-bit integer into a well distributed 64-bit hash. the
+ * mixer is a bijection, so distinct inputs never collide
+ *
+ * @param value integer to mix
+ * @return 64-bit hash of the integer
+ */
+uint64_t hash_u64(uint64_t value);
+
+/**
+ * @brief Hashes a 64-bit integer under a seed, for keys an attacker may
+ * choose
+ *
+ * @param value integer to hash
+ * @param seed seed mixed into the hash
+ * @return 64-bit hash of the integer
+ */
+uint64_t hash_u64_seeded(uint64_t value, uint64_t seed);
+
+/**
+ * @brief Hashes a NUL terminated string under a seed
+ *
+ * @param string string to hash
+ * @param seed seed mixed into the hash
+ * @return 64-bit hash of the string, 0 on error
+ */
+uint64_t hash_string_seeded(const char * string, uint64_t seed);
+
+/**
+ * @brief Sets the seed used by hash_int() and hash_string(). it must be set
+ * before any container holds keys hashed with the old seed, normally once
+ * at start up from a random source
+ *
+ * @param seed new seed
+ */
+void hash_set_seed(uint64_t seed);
+
+/**
+ * @brief Function to hash integer data inside a void source with the seed
+ * from hash_set_seed(), consistent with int_comp(). usable as a HASH_F
+ *
+ * @param p_data pointer to the integer
+ * @return 64-bit hash of the integer, 0 on error
+ */
+uint64_t hash_int(void * p_data);
+
+/**
+ * @brief Function to hash a NUL terminated string inside a void source with
+ * the seed from hash_set_seed(). usable as a HASH_F
+ *
+ * @param p_data pointer to the string
+ * @return 64-bit hash of the string, 0 on error
+ */
+uint64_t hash_string(void * p_data);
+
+#endif /* _HASHING_H */
+
+/*** end of file ***/
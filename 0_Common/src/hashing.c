@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <string.h> // memcpy(), strlen()
+
+#include "hashing.h"
+#include "utilities.h"
+
+// Odd constants with balanced bits, one per input lane
+#define HASH_SECRET_0 0x2d358dccaa6c78a5ULL
+#define HASH_SECRET_1 0x8bb84b93962eacc9ULL
+#define HASH_SECRET_2 0x4b33a62ed433d4a3ULL
+#define HASH_SECRET_3 0x4d5a2da51de1aa47ULL
+
+static uint64_t hash_seed = 0;
+
+/**
+ * @brief Multiplies two 64-bit values into 128 bits, in place.
+ *
+ * @param left First value, receives the low half of the product.
+ * @param right Second value, receives the high half of the product.
+ */
+static void hash_multiply(uint64_t * left, uint64_t * right);
+
+/**
+ * @brief Multiplies two 64-bit values into 128 bits and folds the halves
+ * together, which spreads every input bit over the whole result.
+ *
+ * @param left First value.
+ * @param right Second value.
+ * @return High half of the product XORed with the low half.
+ */
+static uint64_t hash_mix(uint64_t left, uint64_t right);
+
+/**
+ * @brief Reads 8 bytes in native byte order, at any alignment.
+ *
+ * @param bytes Pointer to the bytes.
+ * @return The bytes as an integer.
+ */
+static uint64_t hash_read64(const uint8_t * bytes);
+
+/**
+ * @brief Reads 4 bytes in native byte order, at any alignment.
+ *
+ * @param bytes Pointer to the bytes.
+ * @return The bytes as an integer.
+ */
+static uint64_t hash_read32(const uint8_t * bytes);
+
+uint64_t hash_bytes(const void * data, size_t length, uint64_t seed)
+{
+    const uint8_t * bytes = data;
+    uint64_t        left  = 0;
+    uint64_t        right = 0;
+    uint64_t        lane1 = 0;
+    uint64_t        lane2 = 0;
+    size_t          rest  = length;
+
+    seed ^= hash_mix(seed ^ HASH_SECRET_0, HASH_SECRET_1);
+
+    if (16 >= length)
+    {
+        if (4 <= length)
+        {
+            // Two overlapping reads from each end cover 4 to 16 bytes
+            size_t step = (length >> 3) << 2;
+
+            left  = (hash_read32(bytes) << 32) | hash_read32(bytes + step);
+            right = (hash_read32(bytes + length - 4) << 32)
+                    | hash_read32(bytes + length - 4 - step);
+        }
+        else if (0 < length)
+        {
+            left = ((uint64_t)bytes[0] << 16)
+                   | ((uint64_t)bytes[length >> 1] << 8) | bytes[length - 1];
+        }
+    }
+    else
+    {
+        if (48 < rest)
+        {
+            lane1 = seed;
+            lane2 = seed;
+            do
+            {
+                seed  = hash_mix(hash_read64(bytes) ^ HASH_SECRET_1,
+                                hash_read64(bytes + 8) ^ seed);
+                lane1 = hash_mix(hash_read64(bytes + 16) ^ HASH_SECRET_2,
+                                 hash_read64(bytes + 24) ^ lane1);
+                lane2 = hash_mix(hash_read64(bytes + 32) ^ HASH_SECRET_3,
+                                 hash_read64(bytes + 40) ^ lane2);
+                bytes += 48;
+                rest -= 48;
+            } while (48 < rest);
+            seed ^= lane1 ^ lane2;
+        }
+
+        while (16 < rest)
+        {
+            seed = hash_mix(hash_read64(bytes) ^ HASH_SECRET_1,
+                            hash_read64(bytes + 8) ^ seed);
+            bytes += 16;
+            rest -= 16;
+        }
+
+        // The last 16 bytes, which may overlap ones already consumed
+        left  = hash_read64(bytes + rest - 16);
+        right = hash_read64(bytes + rest - 8);
+    }
+
+    left ^= HASH_SECRET_1;
+    right ^= seed;
+    hash_multiply(&left, &right);
+
+    return hash_mix(left ^ HASH_SECRET_0 ^ length, right ^ HASH_SECRET_1);
+}
+
+uint32_t hash_u32(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x7feb352dU;
+    value ^= value >> 15;
+    value *= 0x846ca68bU;
+    value ^= value >> 16;
+
+    return value;
+}
+
+uint64_t hash_u64(uint64_t value)
+{
+    value ^= value >> 27;
+    value *= 0x3c79ac492ba7b653ULL;
+    value ^= value >> 33;
+    value *= 0x1c69b3f74ac4ae35ULL;
+    value ^= value >> 27;
+
+    return value;
+}
+
+uint64_t hash_u64_seeded(uint64_t value, uint64_t seed)
+{
+    return hash_bytes(&value, sizeof(value), seed);
+}
+
+uint64_t hash_string_seeded(const char * string, uint64_t seed)
+{
+    uint64_t hash = 0;
+
+    if (NULL == string)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    hash = hash_bytes(string, strlen(string), seed);
+
+END:
+    return hash;
+}
+
+void hash_set_seed(uint64_t seed)
+{
+    hash_seed = seed;
+}
+
+uint64_t hash_int(void * p_data)
+{
+    uint64_t hash = 0;
+
+    if (NULL == p_data)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    hash = hash_u64_seeded((uint64_t)(int64_t)(*(int *)p_data), hash_seed);
+
+END:
+    return hash;
+}
+
+uint64_t hash_string(void * p_data)
+{
+    return hash_string_seeded(p_data, hash_seed);
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static void hash_multiply(uint64_t * left, uint64_t * right)
+{
+    __uint128_t product = (__uint128_t)*left * *right;
+
+    *left  = (uint64_t)product;
+    *right = (uint64_t)(product >> 64);
+}
+
+static uint64_t hash_mix(uint64_t left, uint64_t right)
+{
+    hash_multiply(&left, &right);
+    return left ^ right;
+}
+
+static uint64_t hash_read64(const uint8_t * bytes)
+{
+    uint64_t value = 0;
+
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static uint64_t hash_read32(const uint8_t * bytes)
+{
+    uint32_t value = 0;
+
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+/*** end of file ***/
@@ -0,0 +1,458 @@
+/** @file hash_table_bench.c
+ *
+ * @brief Measures hash table inserts and lookups against the linear scans of
+ * vector_find_first_occurrence() and list_find_first_occurrence(), from a
+ * thousand to ten million keys, then the slowest single insert with and
+ * without incremental rehashing.
+ *
+ * Usage: bench_hash_table [max_exponent]
+ *
+ * Key counts run over the powers of ten from 10^3 to 10^max_exponent, 10^7
+ * by default.
+ */
+#define _POSIX_C_SOURCE 200809L // clock_gettime()
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h> // clock_gettime()
+
+#include "hash_table.h"
+#include "hashing.h"
+#include "linked_list.h"
+#include "utilities.h"
+#include "vector.h"
+
+#define MIN_EXPONENT 3
+#define MAX_EXPONENT 7
+#define HASH_LOOKUPS 1000000   // Lookups timed on the hash table
+#define SCAN_BUDGET  100000000 // Keys compared per scan benchmark, roughly
+#define MIN_SCANS    10
+#define WORST_RUNS   3 // Runs per worst insert, the lowest is kept
+
+/**
+ * @brief Times inserting every key and then looking up random keys.
+ *
+ * @param keys Keys in insertion order.
+ * @param count Number of keys.
+ * @param queries Keys to look up.
+ * @param query_count Number of keys to look up.
+ * @param insert_ns Receives nanoseconds per insert.
+ * @return Nanoseconds per lookup, or -1 on failure.
+ */
+static double bench_hash_table(int **   keys,
+                               uint32_t count,
+                               int **   queries,
+                               uint32_t query_count,
+                               double * insert_ns);
+
+/**
+ * @brief Times vector_find_first_occurrence() on a pointer vector.
+ *
+ * @param keys Keys in insertion order.
+ * @param count Number of keys.
+ * @param queries Keys to look up.
+ * @param query_count Number of keys to look up.
+ * @return Nanoseconds per lookup, or -1 on failure.
+ */
+static double bench_vector(int **   keys,
+                           uint32_t count,
+                           int **   queries,
+                           uint32_t query_count);
+
+/**
+ * @brief Times list_find_first_occurrence() on a list without an index.
+ *
+ * @param keys Keys in insertion order.
+ * @param count Number of keys.
+ * @param queries Keys to look up.
+ * @param query_count Number of keys to look up.
+ * @return Nanoseconds per lookup, or -1 on failure.
+ */
+static double bench_list(int **   keys,
+                         uint32_t count,
+                         int **   queries,
+                         uint32_t query_count);
+
+/**
+ * @brief Times every insert into a new table on its own and finds the
+ * slowest, which in the default mode is the insert that rebuilds the table.
+ * Of WORST_RUNS runs the lowest result is kept, to filter out preemption.
+ *
+ * @param keys Keys in insertion order.
+ * @param count Number of keys.
+ * @param incremental Whether the table rehashes incrementally.
+ * @param run_ns Receives nanoseconds taken by the last run.
+ * @return Nanoseconds taken by the slowest insert, or -1 on failure.
+ */
+static double bench_worst_insert(int **   keys,
+                                 uint32_t count,
+                                 bool     incremental,
+                                 double * run_ns);
+
+/**
+ * @brief Times back to back empty intervals for as long as a run of inserts
+ * took and finds the longest, which is how far preemption and the clock
+ * alone push a worst case up on this machine.
+ *
+ * @param run_ns Nanoseconds to keep timing for.
+ * @return Nanoseconds of the longest interval.
+ */
+static double bench_worst_idle(double run_ns);
+
+/**
+ * @brief Leaves a key alone. Vectors and lists need a free function, and the
+ * keys all live in one array.
+ *
+ * @param data Unused.
+ */
+static void bench_keep(void * data);
+
+/**
+ * @brief Steps a xorshift generator.
+ *
+ * @param state Pointer to the generator state.
+ * @return Next pseudo-random number.
+ */
+static uint64_t bench_random(uint64_t * state);
+
+/**
+ * @brief Reads a monotonic clock.
+ *
+ * @return Nanoseconds since an arbitrary point.
+ */
+static double bench_now(void);
+
+int main(int argc, char ** argv)
+{
+    int      exit_code    = EXIT_FAILURE;
+    int      max_exponent = MAX_EXPONENT;
+    uint32_t max_count    = 1;
+    int *    values       = NULL;
+    int **   keys         = NULL;
+    int **   queries      = NULL;
+    uint64_t random       = 0x9e3779b97f4a7c15ULL;
+
+    if (1 < argc)
+    {
+        max_exponent = atoi(argv[1]);
+    }
+    if ((MIN_EXPONENT > max_exponent) || (9 < max_exponent))
+    {
+        fprintf(stderr, "usage: %s [max_exponent, 3 to 9]\n", argv[0]);
+        goto END;
+    }
+    for (int exponent = 0; exponent < max_exponent; exponent++)
+    {
+        max_count *= 10;
+    }
+
+    values  = malloc(max_count * sizeof(int));
+    keys    = malloc(max_count * sizeof(int *));
+    queries = malloc(HASH_LOOKUPS * sizeof(int *));
+    if ((NULL == values) || (NULL == keys) || (NULL == queries))
+    {
+        fprintf(stderr, "out of memory\n");
+        goto END;
+    }
+
+    printf("nanoseconds per operation\n");
+    printf("%10s %12s %12s %12s %12s\n",
+           "keys",
+           "table add",
+           "table find",
+           "vector scan",
+           "list scan");
+
+    for (uint32_t count = 1000; count <= max_count; count *= 10)
+    {
+        double   insert_ns = 0;
+        double   table_ns  = 0;
+        uint32_t scans     = SCAN_BUDGET / count;
+
+        // Keys are inserted in random order so no structure sees them sorted
+        for (uint32_t idx = 0; idx < count; idx++)
+        {
+            values[idx] = (int)idx;
+            keys[idx]   = &values[idx];
+        }
+        for (uint32_t idx = count - 1; idx > 0; idx--)
+        {
+            uint32_t other = (uint32_t)(bench_random(&random) % (idx + 1));
+            int *    swap  = keys[idx];
+            keys[idx]      = keys[other];
+            keys[other]    = swap;
+        }
+        for (uint32_t idx = 0; idx < HASH_LOOKUPS; idx++)
+        {
+            queries[idx] = &values[bench_random(&random) % count];
+        }
+
+        scans = (MIN_SCANS > scans) ? MIN_SCANS : scans;
+        scans = (HASH_LOOKUPS < scans) ? HASH_LOOKUPS : scans;
+        table_ns
+            = bench_hash_table(keys, count, queries, HASH_LOOKUPS, &insert_ns);
+        printf("%10u %12.1f %12.1f %12.1f %12.1f\n",
+               count,
+               insert_ns,
+               table_ns,
+               bench_vector(keys, count, queries, scans),
+               bench_list(keys, count, queries, scans));
+        fflush(stdout);
+    }
+
+    // The keys of the largest count are still shuffled; smaller counts take
+    // a prefix of them
+    printf("\nslowest single insert, nanoseconds\n");
+    printf("%10s %12s %12s %12s\n",
+           "keys",
+           "at once",
+           "incremental",
+           "timer noise");
+    for (uint32_t count = 1000; count <= max_count; count *= 10)
+    {
+        double run_ns = 0;
+
+        printf("%10u %12.0f",
+               count,
+               bench_worst_insert(keys, count, false, &run_ns));
+        printf(" %12.0f", bench_worst_insert(keys, count, true, &run_ns));
+        printf(" %12.0f\n", bench_worst_idle(run_ns));
+        fflush(stdout);
+    }
+
+    exit_code = EXIT_SUCCESS;
+END:
+    free(values);
+    free(keys);
+    free(queries);
+    return exit_code;
+}
+
+/****************************************************************************/
+/*                 NOTE: STATIC FUNCTIONS LISTED BELOW                      */
+/****************************************************************************/
+
+static double bench_hash_table(int **   keys,
+                               uint32_t count,
+                               int **   queries,
+                               uint32_t query_count,
+                               double * insert_ns)
+{
+    double         result = -1;
+    hash_table_t * table  = hash_table_new(hash_int, int_comp, NULL, NULL);
+    uint32_t       found  = 0;
+    double         start  = 0;
+
+    if (NULL == table)
+    {
+        goto END;
+    }
+
+    start = bench_now();
+    for (uint32_t idx = 0; idx < count; idx++)
+    {
+        if (E_SUCCESS != hash_table_insert(table, keys[idx], keys[idx]))
+        {
+            goto END;
+        }
+    }
+    *insert_ns = (bench_now() - start) / count;
+
+    start = bench_now();
+    for (uint32_t idx = 0; idx < query_count; idx++)
+    {
+        found += (NULL != hash_table_lookup(table, queries[idx]));
+    }
+    result = (bench_now() - start) / query_count;
+
+    if (query_count != found)
+    {
+        fprintf(stderr, "hash table lost keys\n");
+        result = -1;
+    }
+
+END:
+    hash_table_delete(&table);
+    return result;
+}
+
+static double bench_vector(int **   keys,
+                           uint32_t count,
+                           int **   queries,
+                           uint32_t query_count)
+{
+    double     result = -1;
+    vector_t * vector = vector_new(bench_keep, int_comp, (int)count);
+    uint32_t   found  = 0;
+    double     start  = 0;
+
+    if (NULL == vector)
+    {
+        goto END;
+    }
+
+    for (uint32_t idx = 0; idx < count; idx++)
+    {
+        if (E_SUCCESS != vector_append(vector, keys[idx]))
+        {
+            goto END;
+        }
+    }
+
+    start = bench_now();
+    for (uint32_t idx = 0; idx < query_count; idx++)
+    {
+        found += (NULL
+                  != vector_find_first_occurrence(vector,
+                                                  (void **)queries[idx]));
+    }
+    result = (bench_now() - start) / query_count;
+
+    if (query_count != found)
+    {
+        fprintf(stderr, "vector lost keys\n");
+        result = -1;
+    }
+
+END:
+    vector_delete(&vector);
+    return result;
+}
+
+static double bench_list(int **   keys,
+                         uint32_t count,
+                         int **   queries,
+                         uint32_t query_count)
+{
+    double   result = -1;
+    list_t * list   = list_new(bench_keep, int_comp);
+    uint32_t found  = 0;
+    double   start  = 0;
+
+    if (NULL == list)
+    {
+        goto END;
+    }
+
+    for (uint32_t idx = 0; idx < count; idx++)
+    {
+        if (E_SUCCESS != list_push_tail(list, keys[idx]))
+        {
+            goto END;
+        }
+    }
+
+    start = bench_now();
+    for (uint32_t idx = 0; idx < query_count; idx++)
+    {
+        found += (NULL
+                  != list_find_first_occurrence(list,
+                                                (void **)&queries[idx]));
+    }
+    result = (bench_now() - start) / query_count;
+
+    if (query_count != found)
+    {
+        fprintf(stderr, "list lost keys\n");
+        result = -1;
+    }
+
+END:
+    list_delete(&list);
+    return result;
+}
+
+static double bench_worst_insert(int **   keys,
+                                 uint32_t count,
+                                 bool     incremental,
+                                 double * run_ns)
+{
+    double         result  = -1;
+    double         worst   = 0;
+    double         start   = 0;
+    double         elapsed = 0;
+    hash_table_t * table   = NULL;
+
+    for (int run = 0; run < WORST_RUNS; run++)
+    {
+        *run_ns = bench_now();
+        table = hash_table_new(hash_int, int_comp, NULL, NULL);
+        if ((NULL == table)
+            || (E_SUCCESS != hash_table_set_incremental(table, incremental)))
+        {
+            result = -1;
+            goto END;
+        }
+
+        worst = 0;
+        for (uint32_t idx = 0; idx < count; idx++)
+        {
+            start = bench_now();
+            if (E_SUCCESS != hash_table_insert(table, keys[idx], keys[idx]))
+            {
+                result = -1;
+                goto END;
+            }
+            elapsed = bench_now() - start;
+            worst   = (elapsed > worst) ? elapsed : worst;
+        }
+        *run_ns = bench_now() - *run_ns;
+        result  = ((0 > result) || (worst < result)) ? worst : result;
+        hash_table_delete(&table);
+    }
+
+END:
+    if (NULL != table)
+    {
+        hash_table_delete(&table);
+    }
+    return result;
+}
+
+static double bench_worst_idle(double run_ns)
+{
+    double result  = -1;
+    double worst   = 0;
+    double begin   = 0;
+    double start   = 0;
+    double elapsed = 0;
+
+    for (int run = 0; run < WORST_RUNS; run++)
+    {
+        worst = 0;
+        begin = bench_now();
+        do
+        {
+            start   = bench_now();
+            elapsed = bench_now() - start;
+            worst   = (elapsed > worst) ? elapsed : worst;
+        } while (start - begin < run_ns);
+        result = ((0 > result) || (worst < result)) ? worst : result;
+    }
+
+    return result;
+}
+
+static void bench_keep(void * data)
+{
+    (void)data;
+}
+
+static uint64_t bench_random(uint64_t * state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static double bench_now(void)
+{
+    struct timespec now = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((double)now.tv_sec * 1e9) + (double)now.tv_nsec;
+}
+
+/*** end of file ***/
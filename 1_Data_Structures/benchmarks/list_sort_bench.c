@@ -0,0 +1,328 @@
+/** @file list_sort_bench.c
+ *
+ * @brief Measures list_sort() on million-node lists in the orders lists are
+ * usually re-sorted in, from fully random to already sorted, next to qsort()
+ * on an array of the same pointers.
+ *
+ * Usage: bench_list_sort [nodes]
+ */
+#define _POSIX_C_SOURCE 200809L // clock_gettime()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> // memcpy()
+#include <time.h>   // clock_gettime()
+
+#include "linked_list.h"
+#include "utilities.h"
+
+#define DEFAULT_NODES 1000000 // Nodes in each list
+#define BENCH_RUNS    3       // Runs per measurement, the fastest is kept
+#define SAWTOOTH_RUN  1000    // Length of each ascending run in a sawtooth
+
+/**
+ * @brief Orders the nodes are pushed in before sorting.
+ */
+typedef enum
+{
+    ORDER_RANDOM,   // Shuffled
+    ORDER_SORTED,   // Already in order
+    ORDER_REVERSED, // Descending
+    ORDER_MOSTLY,   // Sorted, then 1% of the nodes swapped at random
+    ORDER_APPENDED, // Sorted, then 1% random values pushed on the end
+    ORDER_SAWTOOTH, // Ascending runs of SAWTOOTH_RUN
+    ORDER_COUNT,
+} bench_order_t;
+
+/**
+ * @brief Arranges pointers to ascending values in one of the orders.
+ *
+ * @param order Order to arrange them in.
+ * @param values Ascending values.
+ * @param pointers Receives the pointers.
+ * @param count Number of values.
+ */
+static void bench_arrange(bench_order_t order,
+                          int *         values,
+                          int **        pointers,
+                          int           count);
+
+/**
+ * @brief Times list_sort() on a list built from the pointers.
+ *
+ * @param pointers Data to push, in order.
+ * @param count Number of pointers.
+ * @return Fastest time in seconds, or -1 on failure or a wrong result.
+ */
+static double bench_list_sort(int ** pointers, int count);
+
+/**
+ * @brief Times qsort() on a copy of the pointers.
+ *
+ * @param pointers Pointers to sort.
+ * @param scratch Array the copy is sorted in.
+ * @param count Number of pointers.
+ * @return Fastest time in seconds.
+ */
+static double bench_qsort(int ** pointers, int ** scratch, int count);
+
+/**
+ * @brief Compares two int pointers by the ints they point to, for qsort().
+ *
+ * @param left Pointer to the first pointer.
+ * @param right Pointer to the second pointer.
+ * @return Negative, zero or positive as the first int is smaller, equal or
+ * larger.
+ */
+static int bench_compare(const void * left, const void * right);
+
+/**
+ * @brief Leaves a node's data alone; the data lives in one array.
+ *
+ * @param data Unused.
+ */
+static void bench_keep(void * data);
+
+/**
+ * @brief Steps a xorshift generator.
+ *
+ * @return Next pseudo-random number.
+ */
+static uint64_t bench_random(void);
+
+/**
+ * @brief Reads a monotonic clock.
+ *
+ * @return Seconds since an arbitrary point.
+ */
+static double bench_now(void);
+
+static uint64_t bench_state = 0x853c49e6748fea9bULL;
+
+int main(int argc, char ** argv)
+{
+    static const char * names[ORDER_COUNT] = {
+        "random", "sorted", "reversed", "1% swapped", "1% appended",
+        "sawtooth",
+    };
+    int    exit_code = EXIT_FAILURE;
+    int    count     = DEFAULT_NODES;
+    int *  values    = NULL;
+    int ** pointers  = NULL;
+    int ** scratch   = NULL;
+    double list_time = 0;
+
+    if (1 < argc)
+    {
+        count = atoi(argv[1]);
+    }
+    if (2 > count)
+    {
+        fprintf(stderr, "usage: %s [nodes]\n", argv[0]);
+        goto END;
+    }
+
+    values   = malloc((size_t)count * sizeof(int));
+    pointers = malloc((size_t)count * sizeof(int *));
+    scratch  = malloc((size_t)count * sizeof(int *));
+    if ((NULL == values) || (NULL == pointers) || (NULL == scratch))
+    {
+        fprintf(stderr, "out of memory\n");
+        goto END;
+    }
+
+    printf("%d nodes, milliseconds\n", count);
+    printf("%-12s %10s %10s %12s\n", "order", "list_sort", "ns/node", "qsort");
+    for (int order = 0; order < ORDER_COUNT; order++)
+    {
+        bench_arrange((bench_order_t)order, values, pointers, count);
+        list_time = bench_list_sort(pointers, count);
+        printf("%-12s %10.1f %10.1f %12.1f\n",
+               names[order],
+               list_time * 1e3,
+               list_time * 1e9 / count,
+               bench_qsort(pointers, scratch, count) * 1e3);
+        fflush(stdout);
+    }
+
+    exit_code = EXIT_SUCCESS;
+END:
+    free(values);
+    free(pointers);
+    free(scratch);
+    return exit_code;
+}
+
+/****************************************************************************/
+/*                 NOTE: STATIC FUNCTIONS LISTED BELOW                      */
+/****************************************************************************/
+
+static void bench_arrange(bench_order_t order,
+                          int *         values,
+                          int **        pointers,
+                          int           count)
+{
+    int * swap  = NULL;
+    int   other = 0;
+
+    for (int idx = 0; idx < count; idx++)
+    {
+        values[idx]   = idx;
+        pointers[idx] = &values[idx];
+    }
+
+    switch (order)
+    {
+        case ORDER_RANDOM:
+            for (int idx = count - 1; idx > 0; idx--)
+            {
+                other           = (int)(bench_random() % (uint64_t)(idx + 1));
+                swap            = pointers[idx];
+                pointers[idx]   = pointers[other];
+                pointers[other] = swap;
+            }
+            break;
+
+        case ORDER_REVERSED:
+            for (int idx = 0; idx < count; idx++)
+            {
+                pointers[idx] = &values[count - 1 - idx];
+            }
+            break;
+
+        case ORDER_MOSTLY:
+            for (int swaps = 0; swaps < count / 200; swaps++)
+            {
+                int idx         = (int)(bench_random() % (uint64_t)count);
+                other           = (int)(bench_random() % (uint64_t)count);
+                swap            = pointers[idx];
+                pointers[idx]   = pointers[other];
+                pointers[other] = swap;
+            }
+            break;
+
+        case ORDER_APPENDED:
+            // The last 1% are new values scattered across the whole range
+            for (int idx = count - (count / 100); idx < count; idx++)
+            {
+                values[idx] = (int)(bench_random() % (uint64_t)count);
+            }
+            break;
+
+        case ORDER_SAWTOOTH:
+            for (int idx = 0; idx < count; idx++)
+            {
+                values[idx] = idx % SAWTOOTH_RUN;
+            }
+            break;
+
+        case ORDER_SORTED:
+        case ORDER_COUNT:
+            break;
+    }
+}
+
+static double bench_list_sort(int ** pointers, int count)
+{
+    double        best    = -1;
+    double        start   = 0;
+    double        elapsed = 0;
+    list_t *      list    = NULL;
+    list_node_t * node    = NULL;
+
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        list = list_new(bench_keep, int_comp);
+        if (NULL == list)
+        {
+            goto FAIL;
+        }
+        for (int idx = 0; idx < count; idx++)
+        {
+            if (E_SUCCESS != list_push_tail(list, pointers[idx]))
+            {
+                goto FAIL;
+            }
+        }
+
+        start = bench_now();
+        if (E_SUCCESS != list_sort(list))
+        {
+            goto FAIL;
+        }
+        elapsed = bench_now() - start;
+        best    = ((0 > best) || (elapsed < best)) ? elapsed : best;
+
+        // Check the order both ways, so broken prev links or tail show up
+        for (node = list->head; node->next != NULL; node = node->next)
+        {
+            if (*(int *)node->data > *(int *)node->next->data)
+            {
+                fprintf(stderr, "list not sorted\n");
+                goto FAIL;
+            }
+        }
+        if ((list->tail != node) || (NULL != list->head->prev))
+        {
+            fprintf(stderr, "list ends not fixed up\n");
+            goto FAIL;
+        }
+        list_delete(&list);
+    }
+    goto END;
+
+FAIL:
+    best = -1;
+    list_delete(&list);
+END:
+    return best;
+}
+
+static double bench_qsort(int ** pointers, int ** scratch, int count)
+{
+    double best    = -1;
+    double start   = 0;
+    double elapsed = 0;
+
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        memcpy(scratch, pointers, (size_t)count * sizeof(int *));
+        start = bench_now();
+        qsort(scratch, (size_t)count, sizeof(int *), bench_compare);
+        elapsed = bench_now() - start;
+        best    = ((0 > best) || (elapsed < best)) ? elapsed : best;
+    }
+
+    return best;
+}
+
+static int bench_compare(const void * left, const void * right)
+{
+    int first  = **(int * const *)left;
+    int second = **(int * const *)right;
+
+    return (first > second) - (first < second);
+}
+
+static void bench_keep(void * data)
+{
+    (void)data;
+}
+
+static uint64_t bench_random(void)
+{
+    bench_state ^= bench_state << 13;
+    bench_state ^= bench_state >> 7;
+    bench_state ^= bench_state << 17;
+    return bench_state;
+}
+
+static double bench_now(void)
+{
+    struct timespec now = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+/*** end of file ***/
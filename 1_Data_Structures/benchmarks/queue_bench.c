@@ -0,0 +1,269 @@
+/** @file queue_bench.c
+ *
+ * @brief Measures multi-producer, multi-consumer throughput of the lock-free
+ * queue, with single and batch operations, against a linked list behind a
+ * mutex.
+ *
+ * Usage: bench_queue [items] [max_pairs]
+ *
+ * Producer and consumer pairs double from one up to `max_pairs`, by default
+ * the number of cores.
+ */
+#define _POSIX_C_SOURCE 200809L // clock_gettime(), sysconf()
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>   // clock_gettime()
+#include <unistd.h> // sysconf()
+
+#include "linked_list.h"
+#include "queue.h"
+
+#define DEFAULT_ITEMS 4000000 // Items passed through the queue per run
+#define BATCH_SIZE    32
+
+/**
+ * @brief The ways items are passed between threads.
+ */
+typedef enum
+{
+    MODE_SINGLE, // queue_enqueue() and queue_dequeue()
+    MODE_BATCH,  // queue_enqueue_batch() and queue_dequeue_batch()
+    MODE_MUTEX,  // list_push_tail() and list_pop_head() under a mutex
+} bench_mode_t;
+
+/**
+ * @brief State shared by the threads of one run.
+ *
+ * @param mode how items are passed
+ * @param queue queue for the lock-free modes
+ * @param list list for the mutex mode
+ * @param lock mutex guarding the list
+ * @param per_producer items each producer enqueues
+ * @param total items all producers enqueue
+ * @param consumed items dequeued so far
+ */
+typedef struct
+{
+    bench_mode_t         mode;
+    queue_t *            queue;
+    list_t *             list;
+    pthread_mutex_t      lock;
+    uint64_t             per_producer;
+    uint64_t             total;
+    atomic_uint_fast64_t consumed;
+} bench_t;
+
+/**
+ * @brief Runs one measurement.
+ *
+ * @param mode How items are passed.
+ * @param pairs Number of producers, and of consumers.
+ * @param items Number of items passed in total.
+ * @return Millions of items passed per second, or -1 on failure.
+ */
+static double bench_run(bench_mode_t mode, uint32_t pairs, uint64_t items);
+
+/**
+ * @brief Enqueues the thread's share of items.
+ *
+ * @param arg Pointer to the shared state.
+ * @return NULL.
+ */
+static void * bench_producer(void * arg);
+
+/**
+ * @brief Dequeues until every item has been consumed.
+ *
+ * @param arg Pointer to the shared state.
+ * @return NULL.
+ */
+static void * bench_consumer(void * arg);
+
+/**
+ * @brief Reads a monotonic clock.
+ *
+ * @return Seconds since an arbitrary point.
+ */
+static double bench_now(void);
+
+int main(int argc, char ** argv)
+{
+    uint64_t items     = DEFAULT_ITEMS;
+    long     max_pairs = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (1 < argc)
+    {
+        items = strtoull(argv[1], NULL, 10);
+    }
+    if (2 < argc)
+    {
+        max_pairs = strtol(argv[2], NULL, 10);
+    }
+    if ((0 == items) || (1 > max_pairs))
+    {
+        fprintf(stderr, "usage: %s [items] [max_pairs]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%llu items per run, Mitems/s\n", (unsigned long long)items);
+    printf("%8s %12s %12s %12s\n", "threads", "lock-free", "batch", "mutex");
+    // Each pair is one producer and one consumer
+    for (uint32_t pairs = 1; pairs <= (uint32_t)max_pairs; pairs *= 2)
+    {
+        printf("%4u+%-3u %12.2f %12.2f %12.2f\n",
+               pairs,
+               pairs,
+               bench_run(MODE_SINGLE, pairs, items),
+               bench_run(MODE_BATCH, pairs, items),
+               bench_run(MODE_MUTEX, pairs, items));
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/****************************************************************************/
+/*                 NOTE: STATIC FUNCTIONS LISTED BELOW                      */
+/****************************************************************************/
+
+static double bench_run(bench_mode_t mode, uint32_t pairs, uint64_t items)
+{
+    double      result = -1;
+    bench_t     bench  = { .mode = mode };
+    pthread_t * threads = calloc(2 * (size_t)pairs, sizeof(pthread_t));
+    uint32_t    started = 0;
+    double      start   = 0;
+
+    bench.per_producer = items / pairs;
+    bench.total        = bench.per_producer * pairs;
+    atomic_init(&bench.consumed, 0);
+    pthread_mutex_init(&bench.lock, NULL);
+    bench.queue = queue_new(NULL);
+    bench.list  = list_new(NULL, NULL);
+    if ((NULL == threads) || (NULL == bench.queue) || (NULL == bench.list))
+    {
+        goto END;
+    }
+
+    start = bench_now();
+    for (; started < 2 * pairs; started++)
+    {
+        if (0 != pthread_create(&threads[started],
+                                NULL,
+                                (started % 2) ? bench_consumer : bench_producer,
+                                &bench))
+        {
+            break;
+        }
+    }
+    for (uint32_t idx = 0; idx < started; idx++)
+    {
+        pthread_join(threads[idx], NULL);
+    }
+    if (2 * pairs == started)
+    {
+        result = (double)bench.total / (bench_now() - start) / 1e6;
+    }
+
+END:
+    queue_delete(&bench.queue);
+    list_delete(&bench.list);
+    pthread_mutex_destroy(&bench.lock);
+    free(threads);
+    return result;
+}
+
+static void * bench_producer(void * arg)
+{
+    bench_t * bench = arg;
+    void *    batch[BATCH_SIZE];
+    uint64_t  item  = 0;
+
+    while (item < bench->per_producer)
+    {
+        switch (bench->mode)
+        {
+            case MODE_SINGLE:
+                // Items only need to be non-NULL
+                queue_enqueue(bench->queue, (void *)(uintptr_t)(++item));
+                break;
+
+            case MODE_BATCH:
+            {
+                uint32_t count = 0;
+                for (; (count < BATCH_SIZE) && (item < bench->per_producer);
+                     count++)
+                {
+                    batch[count] = (void *)(uintptr_t)(++item);
+                }
+                queue_enqueue_batch(bench->queue, batch, count);
+                break;
+            }
+
+            case MODE_MUTEX:
+                pthread_mutex_lock(&bench->lock);
+                list_push_tail(bench->list, (void *)(uintptr_t)(++item));
+                pthread_mutex_unlock(&bench->lock);
+                break;
+        }
+    }
+
+    return NULL;
+}
+
+static void * bench_consumer(void * arg)
+{
+    bench_t *     bench   = arg;
+    void *        batch[BATCH_SIZE];
+    list_node_t * node    = NULL;
+    int           removed = 0;
+    uint64_t      count   = 0;
+
+    while (bench->total > atomic_load(&bench->consumed))
+    {
+        count = 0;
+        switch (bench->mode)
+        {
+            case MODE_SINGLE:
+                count = (NULL != queue_dequeue(bench->queue));
+                break;
+
+            case MODE_BATCH:
+                removed = queue_dequeue_batch(bench->queue, batch, BATCH_SIZE);
+                count   = (0 < removed) ? (uint64_t)removed : 0;
+                break;
+
+            case MODE_MUTEX:
+                pthread_mutex_lock(&bench->lock);
+                // list_pop_head() reports an empty list as an error
+                node = (0 < bench->list->size) ? list_pop_head(bench->list)
+                                               : NULL;
+                if (NULL != node)
+                {
+                    list_node_release(bench->list, node);
+                    count = 1;
+                }
+                pthread_mutex_unlock(&bench->lock);
+                break;
+        }
+
+        if (0 < count)
+        {
+            atomic_fetch_add(&bench->consumed, count);
+        }
+    }
+
+    return NULL;
+}
+
+static double bench_now(void)
+{
+    struct timespec now = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+/*** end of file ***/
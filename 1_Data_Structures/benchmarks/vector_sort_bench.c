@@ -0,0 +1,218 @@
+/** @file vector_sort_bench.c
+ *
+ * @brief Measures how vector_sort_parallel() scales from one thread up to
+ * the core count, on a typed vector of ints and on a pointer vector whose
+ * compare function has to follow each pointer, next to vector_sort().
+ *
+ * Usage: bench_vector_sort [count] [max_threads]
+ */
+#define _POSIX_C_SOURCE 200809L // clock_gettime(), sysconf()
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>   // clock_gettime()
+#include <unistd.h> // sysconf()
+
+#include "utilities.h"
+#include "vector.h"
+
+#define DEFAULT_COUNT 10000000 // Elements sorted per run
+#define BENCH_RUNS    3        // Runs per measurement, the fastest is kept
+
+/**
+ * @brief Times one way of sorting a vector, refilling it before every run.
+ *
+ * @param vector Vector to sort.
+ * @param source Elements to refill the vector with, as vector_append_many()
+ * takes them.
+ * @param count Number of elements.
+ * @param nthreads Threads to sort with, or -1 for vector_sort().
+ * @return Fastest time in seconds, or -1 on failure or a wrong result.
+ */
+static double bench_sort(vector_t * vector,
+                         void *     source,
+                         int        count,
+                         int        nthreads);
+
+/**
+ * @brief Prints one row of timings for a vector.
+ *
+ * @param name Name of the vector mode.
+ * @param vector Vector to sort.
+ * @param source Elements to refill the vector with.
+ * @param count Number of elements.
+ * @param max_threads Most threads to try.
+ */
+static void bench_mode(const char * name,
+                       vector_t *   vector,
+                       void *       source,
+                       int          count,
+                       int          max_threads);
+
+/**
+ * @brief Leaves an element alone; the pointer vector points into one array.
+ *
+ * @param data Unused.
+ */
+static void bench_keep(void * data);
+
+/**
+ * @brief Reads a monotonic clock.
+ *
+ * @return Seconds since an arbitrary point.
+ */
+static double bench_now(void);
+
+int main(int argc, char ** argv)
+{
+    int        exit_code   = EXIT_FAILURE;
+    int        count       = DEFAULT_COUNT;
+    int        max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int *      values      = NULL;
+    int **     pointers    = NULL;
+    vector_t * typed       = NULL;
+    vector_t * indirect    = NULL;
+    uint64_t   random      = 0x2545f4914f6cdd1dULL;
+
+    if (1 < argc)
+    {
+        count = atoi(argv[1]);
+    }
+    if (2 < argc)
+    {
+        max_threads = atoi(argv[2]);
+    }
+    if ((1 > count) || (1 > max_threads))
+    {
+        fprintf(stderr, "usage: %s [count] [max_threads]\n", argv[0]);
+        goto END;
+    }
+
+    values   = malloc((size_t)count * sizeof(int));
+    pointers = malloc((size_t)count * sizeof(int *));
+    typed    = vector_new_typed(sizeof(int), NULL, int_comp, count);
+    indirect = vector_new(bench_keep, int_comp, count);
+    if ((NULL == values) || (NULL == pointers) || (NULL == typed)
+        || (NULL == indirect))
+    {
+        fprintf(stderr, "out of memory\n");
+        goto END;
+    }
+
+    for (int idx = 0; idx < count; idx++)
+    {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        values[idx]   = (int)(random >> 33);
+        pointers[idx] = &values[idx];
+    }
+
+    printf("%d elements, seconds (speedup over one thread)\n", count);
+    printf("%-8s %10s", "vector", "sort");
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        printf(" %10d thr", threads);
+    }
+    printf("\n");
+
+    bench_mode("typed", typed, values, count, max_threads);
+    bench_mode("pointer", indirect, pointers, count, max_threads);
+
+    exit_code = EXIT_SUCCESS;
+END:
+    vector_delete(&typed);
+    vector_delete(&indirect);
+    free(values);
+    free(pointers);
+    return exit_code;
+}
+
+/****************************************************************************/
+/*                 NOTE: STATIC FUNCTIONS LISTED BELOW                      */
+/****************************************************************************/
+
+static double bench_sort(vector_t * vector,
+                         void *     source,
+                         int        count,
+                         int        nthreads)
+{
+    double best    = -1;
+    double start   = 0;
+    double elapsed = 0;
+    int    check   = E_FAILURE;
+
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        if ((E_SUCCESS != vector_clear(vector))
+            || (E_SUCCESS != vector_append_many(vector, source, count)))
+        {
+            goto FAIL;
+        }
+
+        start = bench_now();
+        check = (0 > nthreads) ? vector_sort(vector)
+                               : vector_sort_parallel(vector, nthreads);
+        if (E_SUCCESS != check)
+        {
+            goto FAIL;
+        }
+        elapsed = bench_now() - start;
+        best    = ((0 > best) || (elapsed < best)) ? elapsed : best;
+    }
+
+    for (int idx = 1; idx < count; idx++)
+    {
+        if (*(int *)vector_get_element(vector, idx - 1)
+            > *(int *)vector_get_element(vector, idx))
+        {
+            fprintf(stderr, "not sorted at %d\n", idx);
+            goto FAIL;
+        }
+    }
+    goto END;
+
+FAIL:
+    best = -1;
+END:
+    return best;
+}
+
+static void bench_mode(const char * name,
+                       vector_t *   vector,
+                       void *       source,
+                       int          count,
+                       int          max_threads)
+{
+    double one_thread = 0;
+    double elapsed    = 0;
+
+    printf("%-8s %10.3f", name, bench_sort(vector, source, count, -1));
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        elapsed = bench_sort(vector, source, count, threads);
+        if (1 == threads)
+        {
+            one_thread = elapsed;
+        }
+        printf(" %6.3f (%4.1fx)", elapsed, one_thread / elapsed);
+        fflush(stdout);
+    }
+    printf("\n");
+}
+
+static void bench_keep(void * data)
+{
+    (void)data;
+}
+
+static double bench_now(void)
+{
+    struct timespec now = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+/*** end of file ***/
@@ -0,0 +1,162 @@
+#ifndef _BLOOM_FILTER_H
+#define _BLOOM_FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hashing.h"
+
+#define BLOOM_BLOCK_BYTES  64 // One cache line per block
+#define BLOOM_BLOCK_WORDS  (BLOOM_BLOCK_BYTES / sizeof(uint64_t))
+#define BLOOM_BLOCK_BITS   (BLOOM_BLOCK_BYTES * 8)
+#define BLOOM_MAX_HASHES   16
+#define BLOOM_FILTER_MAGIC 0x4d4f4f4cU // "LOOM" in the serialized header
+
+/**
+ * @brief A blocked Bloom filter: a set that answers "definitely absent" or
+ * "probably present" in a fraction of the memory the keys would take.
+ *
+ * The filter is an array of 512-bit blocks, each one cache line. A key's
+ * hash picks one block and sets `hash_count` bits inside it, so an insert
+ * or query touches a single cache line instead of `hash_count` random ones.
+ * The hash is remixed before the block is picked, so a hash function that
+ * fills only part of the 64 bits still reaches every block. Keys can not be
+ * removed.
+ *
+ * @param blocks the bit array, `block_count` cache line aligned blocks
+ * @param block_count number of blocks
+ * @param hash_count number of bits set per key
+ * @param count number of keys inserted
+ * @param hash_func function hashing keys
+ */
+typedef struct bloom_filter_t
+{
+    uint64_t * blocks;
+    uint64_t   block_count;
+    uint32_t   hash_count;
+    uint64_t   count;
+    HASH_F     hash_func;
+} bloom_filter_t;
+
+/**
+ * @brief creates a new bloom filter sized for a number of keys and a false
+ *        positive rate. a blocked filter needs a few percent more bits than
+ *        a classic one for the same rate, which the sizing allows for
+ *
+ * @param hash_func function hashing keys
+ * @param expected_items number of keys the filter is sized for
+ * @param false_positive_rate wanted rate of false positives once
+ * `expected_items` keys are in, between 0 and 1 exclusive
+ * @return pointer to the new filter on success, NULL on failure
+ */
+bloom_filter_t * bloom_filter_new(HASH_F   hash_func,
+                                  uint64_t expected_items,
+                                  double   false_positive_rate);
+
+/**
+ * @brief adds a key to the filter. the key itself is not stored
+ *
+ * @param filter filter to add to
+ * @param key key to add
+ * @return 0 on success, non-zero value on failure
+ */
+int bloom_filter_insert(bloom_filter_t * filter, void * key);
+
+/**
+ * @brief checks whether a key may be in the filter
+ *
+ * @param filter filter to query
+ * @param key key to look for
+ * @return false if the key was never added, true if it probably was
+ */
+bool bloom_filter_contains(bloom_filter_t * filter, void * key);
+
+/**
+ * @brief adds many keys. the keys are hashed and their blocks prefetched a
+ *        few keys ahead, so cache misses overlap instead of running one after
+ *        another
+ *
+ * @param filter filter to add to
+ * @param keys array of keys
+ * @param count number of keys
+ * @return 0 on success, non-zero value on failure
+ */
+int bloom_filter_insert_batch(bloom_filter_t * filter,
+                              void **          keys,
+                              uint32_t         count);
+
+/**
+ * @brief checks many keys, prefetching as bloom_filter_insert_batch() does
+ *
+ * @param filter filter to query
+ * @param keys array of keys
+ * @param count number of keys
+ * @param results receives, for each key, whether it may be in the filter
+ * @return 0 on success, non-zero value on failure
+ */
+int bloom_filter_contains_batch(bloom_filter_t * filter,
+                                void **          keys,
+                                uint32_t         count,
+                                bool *           results);
+
+/**
+ * @brief get the false positive rate expected with the keys inserted so far
+ *
+ * @param filter filter to measure
+ * @return expected false positive rate, or -1 on failure
+ */
+double bloom_filter_estimate_fpr(bloom_filter_t * filter);
+
+/**
+ * @brief get the number of bytes bloom_filter_serialize() writes
+ *
+ * @param filter filter to measure
+ * @return number of bytes, or 0 on failure
+ */
+size_t bloom_filter_serialized_size(bloom_filter_t * filter);
+
+/**
+ * @brief writes the filter to a buffer: a small header and the blocks, in
+ *        host byte order
+ *
+ * @param filter filter to write
+ * @param buffer buffer to write into
+ * @param size size of the buffer, at least bloom_filter_serialized_size()
+ * @return 0 on success, non-zero value on failure
+ */
+int bloom_filter_serialize(bloom_filter_t * filter, void * buffer, size_t size);
+
+/**
+ * @brief creates a filter from bytes written by bloom_filter_serialize()
+ *
+ * @param hash_func function hashing keys, the one the filter was built with
+ * @param buffer buffer to read from
+ * @param size size of the buffer
+ * @return pointer to the new filter on success, NULL on failure
+ */
+bloom_filter_t * bloom_filter_deserialize(HASH_F       hash_func,
+                                          const void * buffer,
+                                          size_t       size);
+
+/**
+ * @brief removes every key from the filter
+ *
+ * @param filter filter to clear out
+ * @return 0 on success, non-zero value on failure
+ */
+int bloom_filter_clear(bloom_filter_t * filter);
+
+/**
+ * @brief deletes a filter
+ *
+ * @param filter_address pointer to filter pointer
+ * @return 0 on success, non-zero value on failure
+ */
+int bloom_filter_delete(bloom_filter_t ** filter_address);
+
+#endif
+
+/*** end of file ***/
@@ -0,0 +1,362 @@
+#ifndef _COMPACT_LIST_H
+#define _COMPACT_LIST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "comparisons.h"
+
+#define CLIST_NIL          UINT32_MAX      // Index that links to no node
+#define CLIST_MIN_CAPACITY 16              // Smallest node array allocated
+#define CLIST_MAX_CAPACITY (CLIST_NIL - 1) // Every index but CLIST_NIL
+
+/**
+ * @brief A pointer to a user-defined free function. This is used to free
+ * memory allocated for list data.
+ */
+typedef void (*FREE_F)(void *);
+
+/**
+ * @brief A pointer to a user-defined function that gets called in the
+ * foreach_call on each item in the list.
+ */
+typedef void (*ACT_F)(void *);
+
+/**
+ * @brief structure of a compact list node. nodes link to each other by their
+ *        index in the list's node array, so a node takes 16 bytes instead of
+ *        the 24 of a list_node_t plus its allocation header
+ *
+ * @param data pointer to the data it holds, NULL while the node is free
+ * @param prev index of the node before it, or CLIST_NIL
+ * @param next index of the node after it, or CLIST_NIL. free nodes use it to
+ * chain to the next free node
+ */
+typedef struct clist_node_t
+{
+    void *   data;
+    uint32_t prev;
+    uint32_t next;
+} clist_node_t;
+
+/**
+ * @brief structure of a compact list object. every node lives in one
+ *        growable array and nodes are named by their index in it. the array
+ *        holds no pointers into itself, so it can be moved or copied with a
+ *        single memcpy and stays valid when it is reallocated. removed nodes
+ *        go onto a free chain and are reused before the array grows
+ *
+ * node indices stay valid until the node is removed, except across
+ * clist_sort() and clist_compact(), which renumber every node
+ *
+ * @param nodes the node array
+ * @param capacity number of nodes the array holds
+ * @param used number of nodes at the front of the array ever handed out
+ * @param size number of nodes in the list
+ * @param head index of the head node, or CLIST_NIL
+ * @param tail index of the tail node, or CLIST_NIL
+ * @param free_head index of the first free node below `used`, or CLIST_NIL
+ * @param custom_free pointer to the user defined free function
+ * @param compare_func pointer to the user defined compare function
+ */
+typedef struct clist_t
+{
+    clist_node_t * nodes;
+    uint32_t       capacity;
+    uint32_t       used;
+    uint32_t       size;
+    uint32_t       head;
+    uint32_t       tail;
+    uint32_t       free_head;
+    FREE_F         custom_free;
+    CMP_F          compare_func;
+} clist_t;
+
+/**
+ * @brief creates a new compact list
+ *
+ * @param custom_free pointer to the free function to be used with that list
+ * @param compare_func pointer to the compare function to be used with that
+ * list
+ * @param capacity number of nodes to allocate up front, or 0 to allocate on
+ * first use
+ * @returns pointer to allocated list on success or NULL on failure
+ */
+clist_t * clist_new(FREE_F custom_free, CMP_F compare_func, uint32_t capacity);
+
+/**
+ * @brief grows the node array so it holds at least `capacity` nodes
+ *
+ * @param list list to grow
+ * @param capacity number of nodes the array must hold
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_reserve(clist_t * list, uint32_t capacity);
+
+/**
+ * @brief pushes an item onto the head of the list
+ *
+ * @param list list to push the item into
+ * @param data data to be pushed
+ * @returns 0 on success, non-zero value on failure
+ */
+int clist_push_head(clist_t * list, void * data);
+
+/**
+ * @brief pushes an item onto the tail of the list
+ *
+ * @param list list to push the item into
+ * @param data data to be pushed
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_push_tail(clist_t * list, void * data);
+
+/**
+ * @brief pushes an item into the list at a specific position
+ *
+ * @param list list to push the item into
+ * @param data data to be pushed
+ * @param position the position to insert at, from 0 to the list size
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_push_position(clist_t * list, void * data, uint32_t position);
+
+/**
+ * @brief inserts an item directly after a node in O(1)
+ *
+ * @param list list holding the node
+ * @param node index of a node in the list
+ * @param data data to be inserted
+ * @return index of the new node on success, CLIST_NIL on failure
+ */
+uint32_t clist_insert_after(clist_t * list, uint32_t node, void * data);
+
+/**
+ * @brief inserts an item directly before a node in O(1)
+ *
+ * @param list list holding the node
+ * @param node index of a node in the list
+ * @param data data to be inserted
+ * @return index of the new node on success, CLIST_NIL on failure
+ */
+uint32_t clist_insert_before(clist_t * list, uint32_t node, void * data);
+
+/**
+ * @brief checks if the list object is empty
+ *
+ * @param list pointer to list object to be checked
+ * @returns 0 if list is empty, non-zero value if not empty
+ */
+int clist_emptycheck(clist_t * list);
+
+/**
+ * @brief pops the head item out of the list
+ *
+ * @param list list to pop the item out of
+ * @return pointer to the popped data on success, NULL on failure
+ */
+void * clist_pop_head(clist_t * list);
+
+/**
+ * @brief pops the tail item out of the list
+ *
+ * @param list list to pop the item out of
+ * @return pointer to the popped data on success, NULL on failure
+ */
+void * clist_pop_tail(clist_t * list);
+
+/**
+ * @brief pops an item out of the list at a specific position
+ *
+ * @param list list to pop the item out of
+ * @param position position of the item
+ * @return pointer to the popped data on success, NULL on failure
+ */
+void * clist_pop_position(clist_t * list, uint32_t position);
+
+/**
+ * @brief pops the item of a node out of the list in O(1)
+ *
+ * @param list list holding the node
+ * @param node index of a node in the list
+ * @return pointer to the popped data on success, NULL on failure
+ */
+void * clist_pop_node(clist_t * list, uint32_t node);
+
+/**
+ * @brief removes the head item of the list and frees its data
+ *
+ * @param list list to remove the item from
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_remove_head(clist_t * list);
+
+/**
+ * @brief removes the tail item of the list and frees its data
+ *
+ * @param list list to remove the item from
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_remove_tail(clist_t * list);
+
+/**
+ * @brief removes the item at a specific position and frees its data
+ *
+ * @param list list to remove the item from
+ * @param position position of the item
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_remove_position(clist_t * list, uint32_t position);
+
+/**
+ * @brief removes a node in O(1) and frees its data
+ *
+ * @param list list holding the node
+ * @param node index of a node in the list
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_remove_node(clist_t * list, uint32_t node);
+
+/**
+ * @brief get the index of the head node
+ *
+ * @param list list to look into
+ * @return index of the head node, CLIST_NIL if the list is empty or on
+ * failure
+ */
+uint32_t clist_head(clist_t * list);
+
+/**
+ * @brief get the index of the tail node
+ *
+ * @param list list to look into
+ * @return index of the tail node, CLIST_NIL if the list is empty or on
+ * failure
+ */
+uint32_t clist_tail(clist_t * list);
+
+/**
+ * @brief get the index of the node after a node
+ *
+ * @param list list holding the node
+ * @param node index of a node in the list
+ * @return index of the next node, CLIST_NIL at the tail or on failure
+ */
+uint32_t clist_next(clist_t * list, uint32_t node);
+
+/**
+ * @brief get the index of the node before a node
+ *
+ * @param list list holding the node
+ * @param node index of a node in the list
+ * @return index of the previous node, CLIST_NIL at the head or on failure
+ */
+uint32_t clist_prev(clist_t * list, uint32_t node);
+
+/**
+ * @brief get the data of a node
+ *
+ * @param list list holding the node
+ * @param node index of a node in the list
+ * @return pointer to the data on success, NULL on failure
+ */
+void * clist_get(clist_t * list, uint32_t node);
+
+/**
+ * @brief get the head item of the list without popping
+ *
+ * @param list list to peek into
+ * @return pointer to the data on success, NULL on failure
+ */
+void * clist_peek_head(clist_t * list);
+
+/**
+ * @brief get the tail item of the list without popping
+ *
+ * @param list list to peek into
+ * @return pointer to the data on success, NULL on failure
+ */
+void * clist_peek_tail(clist_t * list);
+
+/**
+ * @brief get the item at a specific position without popping, walking from
+ *        whichever end is nearer
+ *
+ * @param list list to peek into
+ * @param position position of the item
+ * @return pointer to the data on success, NULL on failure
+ */
+void * clist_peek_position(clist_t * list, uint32_t position);
+
+/**
+ * @brief remove the first item the compare function reports as equal to
+ *        the given data, freeing it
+ *
+ * @param list list to remove the item from
+ * @param item_to_remove the data to search for
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_remove_data(clist_t * list, void * item_to_remove);
+
+/**
+ * @brief perform a user defined action on the data of every item, from head
+ *        to tail
+ *
+ * @param list list to perform actions on
+ * @param action_function pointer to user defined action function
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_foreach_call(clist_t * list, ACT_F action_function);
+
+/**
+ * @brief find the first item the compare function reports as equal to the
+ *        search data
+ *
+ * @param list list to search through
+ * @param search_data pointer to the data to search for
+ * @return pointer to the data found on success, NULL on failure
+ */
+void * clist_find_first_occurrence(clist_t * list, void * search_data);
+
+/**
+ * @brief sort list as per user defined compare function. the sort is stable
+ *        and leaves the nodes numbered in list order, as clist_compact()
+ *        does
+ *
+ * @param list pointer to list to be sorted
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_sort(clist_t * list);
+
+/**
+ * @brief renumbers the nodes so the list runs through the front of the
+ *        array in order, then shrinks the array to fit. a traversal then
+ *        reads memory sequentially. every node index changes
+ *
+ * @param list list to compact
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_compact(clist_t * list);
+
+/**
+ * @brief clear all items out of a list, freeing their data. the node array
+ *        is kept for reuse
+ *
+ * @param list list to clear out
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_clear(clist_t * list);
+
+/**
+ * @brief delete a list
+ *
+ * @param list_address pointer to list pointer
+ * @return 0 on success, non-zero value on failure
+ */
+int clist_delete(clist_t ** list_address);
+
+#endif
+
+/*** end of file ***/
@@ -0,0 +1,185 @@
+#ifndef _CONCURRENT_MAP_H
+#define _CONCURRENT_MAP_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "comparisons.h"
+#include "hash_table.h"
+
+#define CMAP_CACHE_LINE     64 // Shards never share a cache line
+#define CMAP_DEFAULT_SHARDS 64 // Shards used when none are requested
+#define CMAP_MAX_SHARDS     (1U << 16)
+
+/**
+ * @brief One slice of the key space: a hash table and the lock guarding it.
+ * The table header is stored in the shard rather than allocated apart, and
+ * each shard starts on its own cache line and is padded to a whole number
+ * of them, so the lock and the size and control pointers every update
+ * writes never share a line with another shard's.
+ *
+ * @param lock reader-writer lock guarding the table
+ * @param table the shard's entries
+ */
+typedef struct cmap_shard_t
+{
+    _Alignas(CMAP_CACHE_LINE) pthread_rwlock_t lock;
+    hash_table_t table;
+} cmap_shard_t;
+
+/**
+ * @brief A hash map that many threads can read and update at once.
+ *
+ * The key space is split into a power of two number of shards, picked by
+ * the top bits of the key's hash after remixing it with hash_u64(), and each
+ * shard is a hash_table_t behind its own reader-writer lock. Lookups in a
+ * shard run in parallel, and writers only block threads that use the same
+ * shard. The remix spreads keys over the shards even when the hash function
+ * only fills the low 32 bits, and keys sharing a shard still differ in the
+ * low bits the shard tables place them with. Each key is hashed once, and
+ * the unmixed hash is handed to the shard's table.
+ *
+ * @param shards array of shards
+ * @param shard_count number of shards, a power of two
+ * @param shard_shift right shift that turns a remixed hash into a shard
+ * number
+ * @param hash_func function hashing keys
+ */
+typedef struct cmap_t
+{
+    cmap_shard_t * shards;
+    uint32_t       shard_count;
+    uint32_t       shard_shift;
+    HASH_F         hash_func;
+} cmap_t;
+
+/**
+ * @brief creates a new concurrent map
+ *
+ * @param hash_func function hashing keys
+ * @param compare_func function comparing keys, consistent with hash_func
+ * @param key_free function freeing keys the map owns, or NULL
+ * @param value_free function freeing values the map owns, or NULL
+ * @param shard_count number of shards, rounded up to a power of two, or 0
+ * for CMAP_DEFAULT_SHARDS. a few times the number of threads works well
+ * @return pointer to the new map on success, NULL on failure
+ */
+cmap_t * cmap_new(HASH_F   hash_func,
+                  CMP_F    compare_func,
+                  FREE_F   key_free,
+                  FREE_F   value_free,
+                  uint32_t shard_count);
+
+/**
+ * @brief inserts a key and value, or replaces the value stored for an equal
+ *        key, with the ownership rules of hash_table_insert(). safe to call
+ *        from any number of threads at once
+ *
+ * @param map map to insert into
+ * @param key key to insert, not NULL
+ * @param value value to store, not NULL
+ * @return 0 on success, non-zero value on failure
+ */
+int cmap_insert(cmap_t * map, void * key, void * value);
+
+/**
+ * @brief looks up the value stored for a key. the value is returned after
+ *        the shard is unlocked, so it is only safe to use if no other thread
+ *        can remove or replace it meanwhile. use cmap_visit() otherwise
+ *
+ * @param map map to search
+ * @param key key to look for
+ * @return pointer to the value, NULL if the key is not in the map
+ */
+void * cmap_lookup(cmap_t * map, void * key);
+
+/**
+ * @brief calls a function on the entry for a key while its shard is read
+ *        locked, so the entry cannot be removed or replaced during the call.
+ *        the function must not modify the map
+ *
+ * @param map map to search
+ * @param key key to look for
+ * @param action_function function called with the key passed in and the
+ * stored value
+ * @param context caller data passed to the action, may be NULL
+ * @return 0 if the key was found, non-zero value otherwise
+ */
+int cmap_visit(cmap_t *   map,
+               void *     key,
+               PAIR_ACT_F action_function,
+               void *     context);
+
+/**
+ * @brief checks whether a key is in the map
+ *
+ * @param map map to search
+ * @param key key to look for
+ * @return true if the key is in the map, false otherwise
+ */
+bool cmap_contains(cmap_t * map, void * key);
+
+/**
+ * @brief removes a key and hands its stored key and value back without
+ *        freeing them
+ *
+ * @param map map to remove from
+ * @param key key to look for
+ * @param stored_key receives the stored key, may be NULL
+ * @param value receives the stored value, may be NULL
+ * @return 0 on success, non-zero value on failure or if the key is absent
+ */
+int cmap_extract(cmap_t * map, void * key, void ** stored_key, void ** value);
+
+/**
+ * @brief removes a key, freeing its stored key and value
+ *
+ * @param map map to remove from
+ * @param key key to look for
+ * @return 0 on success, non-zero value on failure or if the key is absent
+ */
+int cmap_remove(cmap_t * map, void * key);
+
+/**
+ * @brief perform a user defined action on every entry. shards are read
+ *        locked one at a time, so the walk is not a snapshot of the whole
+ *        map. the function must not modify the map
+ *
+ * @param map map to walk
+ * @param action_function function called with each key and value
+ * @param context caller data passed to the action, may be NULL
+ * @return 0 on success, non-zero value on failure
+ */
+int cmap_foreach_call(cmap_t * map, PAIR_ACT_F action_function, void * context);
+
+/**
+ * @brief get the number of entries, summed over the shards one at a time
+ *
+ * @param map map to measure
+ * @return number of entries, or -1 on failure
+ */
+int64_t cmap_size(cmap_t * map);
+
+/**
+ * @brief removes every entry, freeing the keys and values
+ *
+ * @param map map to clear out
+ * @return 0 on success, non-zero value on failure
+ */
+int cmap_clear(cmap_t * map);
+
+/**
+ * @brief clears and deletes a map. no other thread may use the map during
+ *        or after the call
+ *
+ * @param map_address pointer to map pointer
+ * @return 0 on success, non-zero value on failure
+ */
+int cmap_delete(cmap_t ** map_address);
+
+#endif
+
+/*** end of file ***/
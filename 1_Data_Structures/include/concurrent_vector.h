@@ -0,0 +1,156 @@
+#ifndef _CONCURRENT_VECTOR_H
+#define _CONCURRENT_VECTOR_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "comparisons.h"
+
+#define CVECTOR_FIRST_SEGMENT_BITS 6  // First segment holds 64 elements
+#define CVECTOR_SEGMENT_COUNT      25 // Enough segments for INT_MAX elements
+
+/**
+ * @brief Most elements a concurrent vector can hold, the total size of all
+ * its segments.
+ */
+#define CVECTOR_MAX_SIZE                                                       \
+    ((int)(((1U << CVECTOR_SEGMENT_COUNT) - 1U) << CVECTOR_FIRST_SEGMENT_BITS))
+
+/**
+ * @brief A pointer to a user-defined function that gets called in the
+ * foreach_call on each item in the vector.
+ */
+typedef void (*ACT_F)(void *);
+
+/**
+ * @brief A pointer to a user-defined free function. This is used to free
+ * memory allocated for vector data.
+ */
+typedef void (*FREE_F)(void *);
+
+/**
+ * @brief One element slot, written once by the appending thread.
+ */
+typedef _Atomic(void *) cvector_slot_t;
+
+/**
+ * @brief A growable array of element pointers that many threads can append to
+ * and read from at once.
+ *
+ * Elements live in segments that are never moved or freed while the vector
+ * exists: segment k holds 64 << k slots, so an element keeps its address for
+ * the life of the vector. Appends reserve an index with an atomic fetch-add
+ * on the size and install missing segments with a compare-and-swap. Indexed
+ * reads take no locks.
+ *
+ * An index is reserved before its element is published, so a reader can see
+ * a slot inside the size that is still empty; the read functions treat it as
+ * NULL. Because of this, NULL cannot be stored. Clearing and deleting are not
+ * safe while other threads use the vector.
+ *
+ * @param segments lazily allocated segments of slots
+ * @param size number of indices reserved by appends
+ * @param custom_free function that releases an element
+ * @param compare_func function used to compare elements
+ */
+typedef struct cvector
+{
+    _Atomic(cvector_slot_t *) segments[CVECTOR_SEGMENT_COUNT];
+    atomic_int                size;
+    FREE_F                    custom_free;
+    CMP_F                     compare_func;
+} cvector_t;
+
+/**
+ * @brief Initializes a new concurrent vector.
+ * @param custom_free Function pointer to a custom free function for the
+ * elements.
+ * @param compare_func Function pointer to a comparison function for the
+ * elements.
+ * @return A pointer to the newly created vector, or NULL on failure.
+ */
+cvector_t * cvector_new(FREE_F custom_free, CMP_F compare_func);
+
+/**
+ * @brief Appends an element to the vector. Safe to call from any number of
+ * threads at once.
+ * @param vector Pointer to the vector.
+ * @param data Pointer to the data to append, must not be NULL.
+ * @return Index the element was stored at, or -1 on failure.
+ */
+int cvector_append(cvector_t * vector, void * data);
+
+/**
+ * @brief Allocates the segments needed to hold `capacity` elements up front,
+ * so that appends below it never allocate.
+ * @param vector Pointer to the vector.
+ * @param capacity Number of elements to make room for.
+ * @return Status code indicating success or failure.
+ */
+int cvector_reserve(cvector_t * vector, int capacity);
+
+/**
+ * @brief Retrieves the element at an index without locking.
+ * @param vector Pointer to the vector.
+ * @param index Index of the element.
+ * @return Pointer to the element, or NULL if the index is out of bounds or its
+ * append has not finished yet.
+ */
+void * cvector_get_element(cvector_t * vector, int index);
+
+/**
+ * @brief Replaces the element at an index. The previous element is not freed.
+ * @param vector Pointer to the vector.
+ * @param data Pointer to the new data, must not be NULL.
+ * @param index Index of the element.
+ * @return Status code indicating success or failure.
+ */
+int cvector_set_element(cvector_t * vector, void * data, int index);
+
+/**
+ * @brief Retrieves the number of indices reserved so far, including appends
+ * still in progress.
+ * @param vector Pointer to the vector.
+ * @return Size of the vector, or -1 on failure.
+ */
+int cvector_size(cvector_t * vector);
+
+/**
+ * @brief Calls a user-provided function on each published element in index
+ * order, skipping appends still in progress.
+ * @param vector Pointer to the vector.
+ * @param action_function Function to call on each element.
+ * @return Status code indicating success or failure.
+ */
+int cvector_iterate(cvector_t * vector, ACT_F action_function);
+
+/**
+ * @brief Finds the first published element that compares equal to the search
+ * data.
+ * @param vector Pointer to the vector.
+ * @param search_data Pointer to the data to search for.
+ * @return Pointer to the first occurrence, or NULL if not found.
+ */
+void * cvector_find_first_occurrence(cvector_t * vector, void * search_data);
+
+/**
+ * @brief Clears all elements from the vector, freeing each of them. The
+ * segments are kept for reuse. Not safe while other threads use the vector.
+ * @param vector Pointer to the vector.
+ * @return Status code indicating success or failure.
+ */
+int cvector_clear(cvector_t * vector);
+
+/**
+ * @brief Deletes the vector and frees all associated memory. Not safe while
+ * other threads use the vector.
+ * @param vector Pointer to a pointer to the vector.
+ */
+void cvector_delete(cvector_t ** vector);
+
+#endif
+
+/*** end of file ***/
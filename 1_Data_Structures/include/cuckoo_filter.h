@@ -0,0 +1,185 @@
+#ifndef _CUCKOO_FILTER_H
+#define _CUCKOO_FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hashing.h"
+
+#define CUCKOO_BUCKET_SLOTS  4   // Fingerprints per bucket
+#define CUCKOO_MAX_KICKS     500 // Relocations tried before the filter is full
+#define CUCKOO_MAX_BUCKETS   (1ULL << 32)
+#define CUCKOO_FILTER_MAGIC  0x4b435543U // "CUCK" in the serialized header
+
+/**
+ * @brief A cuckoo filter: a set that answers "definitely absent" or
+ * "probably present" like a Bloom filter, but also supports removing keys.
+ *
+ * Each key is reduced to a small fingerprint that may live in one of two
+ * buckets of four slots. The second bucket is the first XORed with a hash
+ * of the fingerprint, so either bucket can be found from the other without
+ * the key. An insert into two full buckets evicts a fingerprint to its
+ * other bucket, and so on, up to CUCKOO_MAX_KICKS times. If that fails the
+ * last evicted fingerprint is kept aside as the victim and the filter
+ * reports itself full. Fingerprints are 8 bits when the false positive
+ * rate allows it and 16 bits otherwise. Both the bucket and the fingerprint
+ * are cut from the hash after a hash_u64() remix, so 32-bit hash functions
+ * work as well as full width ones.
+ *
+ * @param slots the fingerprints, `bucket_count` buckets of
+ * CUCKOO_BUCKET_SLOTS. 0 marks an empty slot
+ * @param bucket_count number of buckets, a power of two
+ * @param fingerprint_bits width of a fingerprint, 8 or 16
+ * @param count number of keys held
+ * @param victim fingerprint that found no slot, or 0
+ * @param victim_index bucket the victim was last evicted from
+ * @param random state of the generator choosing which slot to evict
+ * @param hash_func function hashing keys
+ */
+typedef struct cuckoo_filter_t
+{
+    uint8_t * slots;
+    uint64_t  bucket_count;
+    uint32_t  fingerprint_bits;
+    uint64_t  count;
+    uint32_t  victim;
+    uint64_t  victim_index;
+    uint64_t  random;
+    HASH_F    hash_func;
+} cuckoo_filter_t;
+
+/**
+ * @brief creates a new cuckoo filter sized for a number of keys and a false
+ *        positive rate. the rate can be as low as about 0.012%; from about
+ *        3% up fingerprints take half the memory
+ *
+ * @param hash_func function hashing keys
+ * @param expected_items number of keys the filter is sized for
+ * @param false_positive_rate wanted rate of false positives once
+ * `expected_items` keys are in, between 0 and 1 exclusive
+ * @return pointer to the new filter on success, NULL on failure
+ */
+cuckoo_filter_t * cuckoo_filter_new(HASH_F   hash_func,
+                                    uint64_t expected_items,
+                                    double   false_positive_rate);
+
+/**
+ * @brief adds a key to the filter. the key itself is not stored, and adding
+ *        a key twice stores it twice
+ *
+ * @param filter filter to add to
+ * @param key key to add
+ * @return 0 on success, non-zero value on failure or if the filter is full
+ */
+int cuckoo_filter_insert(cuckoo_filter_t * filter, void * key);
+
+/**
+ * @brief checks whether a key may be in the filter
+ *
+ * @param filter filter to query
+ * @param key key to look for
+ * @return false if the key is not in the filter, true if it probably is
+ */
+bool cuckoo_filter_contains(cuckoo_filter_t * filter, void * key);
+
+/**
+ * @brief removes one copy of a key. only keys that were added may be
+ *        removed: removing any other key can drop the fingerprint of a key
+ *        that shares it
+ *
+ * @param filter filter to remove from
+ * @param key key to remove
+ * @return 0 on success, non-zero value on failure or if the key is absent
+ */
+int cuckoo_filter_remove(cuckoo_filter_t * filter, void * key);
+
+/**
+ * @brief adds many keys, prefetching the buckets of a few keys ahead so
+ *        cache misses overlap. stops at the first key that does not fit
+ *
+ * @param filter filter to add to
+ * @param keys array of keys
+ * @param count number of keys
+ * @return number of keys added, or -1 on failure
+ */
+int64_t cuckoo_filter_insert_batch(cuckoo_filter_t * filter,
+                                   void **           keys,
+                                   uint32_t          count);
+
+/**
+ * @brief checks many keys, prefetching as cuckoo_filter_insert_batch() does
+ *
+ * @param filter filter to query
+ * @param keys array of keys
+ * @param count number of keys
+ * @param results receives, for each key, whether it may be in the filter
+ * @return 0 on success, non-zero value on failure
+ */
+int cuckoo_filter_contains_batch(cuckoo_filter_t * filter,
+                                 void **           keys,
+                                 uint32_t          count,
+                                 bool *            results);
+
+/**
+ * @brief get the number of keys in the filter
+ *
+ * @param filter filter to measure
+ * @return number of keys, or -1 on failure
+ */
+int64_t cuckoo_filter_size(cuckoo_filter_t * filter);
+
+/**
+ * @brief get the number of bytes cuckoo_filter_serialize() writes
+ *
+ * @param filter filter to measure
+ * @return number of bytes, or 0 on failure
+ */
+size_t cuckoo_filter_serialized_size(cuckoo_filter_t * filter);
+
+/**
+ * @brief writes the filter to a buffer: a small header and the slots, in
+ *        host byte order
+ *
+ * @param filter filter to write
+ * @param buffer buffer to write into
+ * @param size size of the buffer, at least cuckoo_filter_serialized_size()
+ * @return 0 on success, non-zero value on failure
+ */
+int cuckoo_filter_serialize(cuckoo_filter_t * filter,
+                            void *            buffer,
+                            size_t            size);
+
+/**
+ * @brief creates a filter from bytes written by cuckoo_filter_serialize()
+ *
+ * @param hash_func function hashing keys, the one the filter was built with
+ * @param buffer buffer to read from
+ * @param size size of the buffer
+ * @return pointer to the new filter on success, NULL on failure
+ */
+cuckoo_filter_t * cuckoo_filter_deserialize(HASH_F       hash_func,
+                                            const void * buffer,
+                                            size_t       size);
+
+/**
+ * @brief removes every key from the filter
+ *
+ * @param filter filter to clear out
+ * @return 0 on success, non-zero value on failure
+ */
+int cuckoo_filter_clear(cuckoo_filter_t * filter);
+
+/**
+ * @brief deletes a filter
+ *
+ * @param filter_address pointer to filter pointer
+ * @return 0 on success, non-zero value on failure
+ */
+int cuckoo_filter_delete(cuckoo_filter_t ** filter_address);
+
+#endif
+
+/*** end of file ***/
@@ -0,0 +1,173 @@
+#ifndef _DEQUE_H
+#define _DEQUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "comparisons.h"
+
+/**
+ * @brief A pointer to a user-defined function that gets called in the
+ * foreach_call on each item in the deque.
+ */
+typedef void (*ACT_F)(void *);
+
+/**
+ * @brief A pointer to a user-defined free function. This is used to free
+ * memory allocated for deque data.
+ */
+typedef void (*FREE_F)(void *);
+
+/**
+ * @brief A double-ended queue backed by a circular buffer.
+ *
+ * Elements are addressed by their logical index, 0 being the front. The
+ * buffer capacity is always a power of two so that a logical index maps to a
+ * physical slot with a single mask.
+ *
+ * @param elements circular buffer of element pointers
+ * @param head physical slot of the front element
+ * @param size number of elements currently stored
+ * @param capacity number of slots in the buffer
+ * @param custom_free function that releases an element
+ * @param compare_func function used to compare elements
+ */
+typedef struct deque
+{
+    void ** elements;
+    int     head;
+    int     size;
+    int     capacity;
+    FREE_F  custom_free;
+    CMP_F   compare_func;
+} deque_t;
+
+/**
+ * @brief Initializes a new deque.
+ * @param custom_free Function pointer to a custom free function for the
+ * elements.
+ * @param compare_func Function pointer to a comparison function for the
+ * elements.
+ * @param initial_capacity Initial capacity, rounded up to a power of two.
+ * @return A pointer to the newly created deque, or NULL on failure.
+ */
+deque_t * deque_new(FREE_F custom_free,
+                    CMP_F  compare_func,
+                    int    initial_capacity);
+
+/**
+ * @brief Pushes an element onto the front of the deque in amortized O(1).
+ * @param deque Pointer to the deque.
+ * @param data Pointer to the data to push.
+ * @return Status code indicating success or failure.
+ */
+int deque_push_front(deque_t * deque, void * data);
+
+/**
+ * @brief Pushes an element onto the back of the deque in amortized O(1).
+ * @param deque Pointer to the deque.
+ * @param data Pointer to the data to push.
+ * @return Status code indicating success or failure.
+ */
+int deque_push_back(deque_t * deque, void * data);
+
+/**
+ * @brief Removes and returns the front element of the deque in O(1).
+ * @param deque Pointer to the deque.
+ * @return Pointer to the popped element, or NULL if the deque is empty.
+ */
+void * deque_pop_front(deque_t * deque);
+
+/**
+ * @brief Removes and returns the back element of the deque in O(1).
+ * @param deque Pointer to the deque.
+ * @return Pointer to the popped element, or NULL if the deque is empty.
+ */
+void * deque_pop_back(deque_t * deque);
+
+/**
+ * @brief Returns the front element without removing it.
+ * @param deque Pointer to the deque.
+ * @return Pointer to the front element, or NULL if the deque is empty.
+ */
+void * deque_peek_front(deque_t * deque);
+
+/**
+ * @brief Returns the back element without removing it.
+ * @param deque Pointer to the deque.
+ * @return Pointer to the back element, or NULL if the deque is empty.
+ */
+void * deque_peek_back(deque_t * deque);
+
+/**
+ * @brief Retrieves the element at a logical index.
+ * @param deque Pointer to the deque.
+ * @param index Logical index of the element, 0 being the front.
+ * @return Pointer to the element, or NULL on failure.
+ */
+void * deque_get_element(deque_t * deque, int index);
+
+/**
+ * @brief Replaces the element at a logical index. The previous element is not
+ * freed.
+ * @param deque Pointer to the deque.
+ * @param data Pointer to the data to set.
+ * @param index Logical index of the element, 0 being the front.
+ * @return Status code indicating success or failure.
+ */
+int deque_set_element(deque_t * deque, void * data, int index);
+
+/**
+ * @brief Checks if the deque is empty.
+ * @param deque Pointer to the deque.
+ * @return 'true' if the deque is empty, 'false' otherwise.
+ */
+bool deque_is_empty(deque_t * deque);
+
+/**
+ * @brief Retrieves the current size of the deque.
+ * @param deque Pointer to the deque.
+ * @return Current size of the deque, or -1 on failure.
+ */
+int deque_size(deque_t * deque);
+
+/**
+ * @brief Retrieves the current capacity of the deque.
+ * @param deque Pointer to the deque.
+ * @return Current capacity of the deque, or -1 on failure.
+ */
+int deque_capacity(deque_t * deque);
+
+/**
+ * @brief Calls a user-provided function on each element from front to back.
+ * @param deque Pointer to the deque.
+ * @param action_function Function to call on each element.
+ * @return Status code indicating success or failure.
+ */
+int deque_iterate(deque_t * deque, ACT_F action_function);
+
+/**
+ * @brief Finds the first element, from the front, that compares equal to the
+ * search data.
+ * @param deque Pointer to the deque.
+ * @param search_data Pointer to the data to search for.
+ * @return Pointer to the first occurrence, or NULL if not found.
+ */
+void * deque_find_first_occurrence(deque_t * deque, void * search_data);
+
+/**
+ * @brief Clears all elements from the deque, freeing each of them.
+ * @param deque Pointer to the deque.
+ * @return Status code indicating success or failure.
+ */
+int deque_clear(deque_t * deque);
+
+/**
+ * @brief Deletes the deque and frees all associated memory.
+ * @param deque Pointer to a pointer to the deque.
+ */
+void deque_delete(deque_t ** deque);
+
+#endif
@@ -0,0 +1,315 @@
+#ifndef _HASH_TABLE_H
+#define _HASH_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "comparisons.h"
+#include "hashing.h"
+
+#define HASH_TABLE_GROUP_WIDTH  16         // Control bytes matched at once
+#define HASH_TABLE_MIN_CAPACITY 16         // Smallest slot table allocated
+#define HASH_TABLE_MAX_CAPACITY (1U << 31) // Largest power of two in 32 bits
+#define HASH_TABLE_MIGRATE_STEP 32         // Old slots moved per update
+#define HASH_TABLE_SPARE_STEP   512        // Spare control bytes set per update
+#define HASH_TABLE_RELEASE_STEP 4096       // Drained slots released per update
+
+/**
+ * @brief A pointer to a user-defined free function. This is used to free
+ * keys and values owned by the table.
+ */
+typedef void (*FREE_F)(void *);
+
+/**
+ * @brief A pointer to a user-defined function that gets called in the
+ * foreach_call on each entry, with a caller supplied context.
+ */
+typedef void (*PAIR_ACT_F)(void * key, void * value, void * context);
+
+/**
+ * @brief One key and value stored in the table.
+ *
+ * @param key pointer to the key
+ * @param value pointer to the value
+ */
+typedef struct hash_table_slot_t
+{
+    void * key;
+    void * value;
+} hash_table_slot_t;
+
+/**
+ * @brief A map from keys to values using open addressing with one control
+ * byte per slot, in the style of a Swiss table.
+ *
+ * A key's 64-bit hash is split in two: the high bits pick where probing
+ * starts and the low 7 bits are stored in the slot's control byte. A lookup
+ * loads the control bytes of 16 slots at once and compares all of them with
+ * the 7-bit tag in a couple of SSE2 instructions, so the compare function
+ * only runs on the few slots whose tag matches. Control bytes of empty and
+ * deleted slots have their top bit set, which also makes finding a free slot
+ * one instruction. Removed slots become tombstones unless no probe could
+ * have passed over them. The table grows at 7/8 full, or is rebuilt in place
+ * when tombstones fill it.
+ *
+ * By default a rebuild moves every entry at once, inside the insert that
+ * needs it. In incremental mode the full slot table is kept aside as `old`
+ * and new slot arrays are allocated empty; each insert or removal then moves
+ * the entries of HASH_TABLE_MIGRATE_STEP old slots across, and lookups
+ * search both tables until the old one is drained. The new table is at
+ * most half full when migration starts, so it always finishes before the
+ * new table needs rebuilding in turn. Setting the new control bytes to empty
+ * is spread out as well: once the table is close to needing a rebuild, a
+ * spare control array big enough for double the capacity is allocated and
+ * each update sets HASH_TABLE_SPARE_STEP more of its bytes, so it is ready
+ * by the time the rebuild starts. Freeing the drained old arrays costs time
+ * in proportion to their size too, so they are kept as `retired` and each
+ * update shrinks them by HASH_TABLE_RELEASE_STEP slots.
+ *
+ * @param ctrl control bytes, `capacity` of them followed by a copy of the
+ * first group so groups can be loaded across the end
+ * @param slots the key and value slots
+ * @param capacity number of slots, a power of two
+ * @param size number of entries stored
+ * @param growth_left number of empty slots that can be filled before the
+ * table must be rebuilt
+ * @param hash_func function hashing keys
+ * @param compare_func function comparing keys
+ * @param key_free function releasing keys, or NULL if they are not owned
+ * @param value_free function releasing values, or NULL if they are not owned
+ * @param old slot table still being migrated from in incremental mode, or
+ * NULL. its `size` counts the entries left in it
+ * @param migrate_pos index of the next old slot to migrate
+ * @param incremental whether rebuilds are spread over later updates
+ * @param spare_ctrl control bytes being readied for the next rebuild, or
+ * NULL
+ * @param spare_size number of spare control bytes allocated
+ * @param spare_ready number of spare control bytes already set to empty
+ * @param retired drained old table whose arrays are being released, or NULL.
+ * its `capacity` counts the slots left to release
+ */
+typedef struct hash_table_t
+{
+    int8_t *              ctrl;
+    hash_table_slot_t *   slots;
+    uint32_t              capacity;
+    uint32_t              size;
+    uint32_t              growth_left;
+    HASH_F                hash_func;
+    CMP_F                 compare_func;
+    FREE_F                key_free;
+    FREE_F                value_free;
+    struct hash_table_t * old;
+    uint32_t              migrate_pos;
+    bool                  incremental;
+    int8_t *              spare_ctrl;
+    size_t                spare_size;
+    size_t                spare_ready;
+    struct hash_table_t * retired;
+} hash_table_t;
+
+/**
+ * @brief creates a new hash table
+ *
+ * @param hash_func function hashing keys
+ * @param compare_func function comparing keys, consistent with hash_func
+ * @param key_free function freeing keys the table owns, or NULL
+ * @param value_free function freeing values the table owns, or NULL
+ * @return pointer to the new table on success, NULL on failure
+ */
+hash_table_t * hash_table_new(HASH_F hash_func,
+                              CMP_F  compare_func,
+                              FREE_F key_free,
+                              FREE_F value_free);
+
+/**
+ * @brief sets up an empty hash table in storage the caller provides, such
+ *        as a field of a larger structure. release it with
+ *        hash_table_destroy() rather than hash_table_delete()
+ *
+ * @param table storage for the table
+ * @param hash_func function hashing keys
+ * @param compare_func function comparing keys, consistent with hash_func
+ * @param key_free function freeing keys the table owns, or NULL
+ * @param value_free function freeing values the table owns, or NULL
+ * @return 0 on success, non-zero value on failure
+ */
+int hash_table_init(hash_table_t * table,
+                    HASH_F         hash_func,
+                    CMP_F          compare_func,
+                    FREE_F         key_free,
+                    FREE_F         value_free);
+
+/**
+ * @brief switches incremental rehashing on or off. with it on, no insert or
+ *        removal moves more than HASH_TABLE_MIGRATE_STEP old slots, sets
+ *        more than HASH_TABLE_SPARE_STEP control bytes or releases more than
+ *        HASH_TABLE_RELEASE_STEP drained slots, at the cost of lookups
+ *        searching two tables while a migration is under way. switching it
+ *        off finishes any migration at once
+ *
+ * @param table table to configure
+ * @param incremental true to spread rebuilds over later updates
+ * @return 0 on success, non-zero value on failure
+ */
+int hash_table_set_incremental(hash_table_t * table, bool incremental);
+
+/**
+ * @brief makes room for `count` entries so no rebuild happens until then.
+ *        the rebuild, if any, is done at once even in incremental mode
+ *
+ * @param table table to grow
+ * @param count number of entries the table must hold
+ * @return 0 on success, non-zero value on failure
+ */
+int hash_table_reserve(hash_table_t * table, uint32_t count);
+
+/**
+ * @brief inserts a key and value, or replaces the value stored for an equal
+ *        key. the table owns both afterwards: on replacement the old value
+ *        and the passed key are freed, unless they are the very pointers
+ *        already stored
+ *
+ * @param table table to insert into
+ * @param key key to insert, not NULL
+ * @param value value to store, not NULL
+ * @return 0 on success, non-zero value on failure
+ */
+int hash_table_insert(hash_table_t * table, void * key, void * value);
+
+/**
+ * @brief hash_table_insert() for a caller that has already hashed the key,
+ *        so it is not hashed again
+ *
+ * @param table table to insert into
+ * @param key key to insert, not NULL
+ * @param value value to store, not NULL
+ * @param hash the table's hash function applied to the key
+ * @return 0 on success, non-zero value on failure
+ */
+int hash_table_insert_hashed(hash_table_t * table,
+                             void *         key,
+                             void *         value,
+                             uint64_t       hash);
+
+/**
+ * @brief looks up the value stored for a key
+ *
+ * @param table table to search
+ * @param key key to look for
+ * @return pointer to the value, NULL if the key is not in the table
+ */
+void * hash_table_lookup(hash_table_t * table, void * key);
+
+/**
+ * @brief hash_table_lookup() for a caller that has already hashed the key
+ *
+ * @param table table to search
+ * @param key key to look for
+ * @param hash the table's hash function applied to the key
+ * @return pointer to the value, NULL if the key is not in the table
+ */
+void * hash_table_lookup_hashed(hash_table_t * table,
+                                void *         key,
+                                uint64_t       hash);
+
+/**
+ * @brief checks whether a key is in the table
+ *
+ * @param table table to search
+ * @param key key to look for
+ * @return true if the key is in the table, false otherwise
+ */
+bool hash_table_contains(hash_table_t * table, void * key);
+
+/**
+ * @brief removes a key and hands its stored key and value back without
+ *        freeing them
+ *
+ * @param table table to remove from
+ * @param key key to look for
+ * @param stored_key receives the stored key, may be NULL
+ * @param value receives the stored value, may be NULL
+ * @return 0 on success, non-zero value on failure or if the key is absent
+ */
+int hash_table_extract(hash_table_t * table,
+                       void *         key,
+                       void **        stored_key,
+                       void **        value);
+
+/**
+ * @brief hash_table_extract() for a caller that has already hashed the key
+ *
+ * @param table table to remove from
+ * @param key key to look for
+ * @param hash the table's hash function applied to the key
+ * @param stored_key receives the stored key, may be NULL
+ * @param value receives the stored value, may be NULL
+ * @return 0 on success, non-zero value on failure or if the key is absent
+ */
+int hash_table_extract_hashed(hash_table_t * table,
+                              void *         key,
+                              uint64_t       hash,
+                              void **        stored_key,
+                              void **        value);
+
+/**
+ * @brief removes a key, freeing its stored key and value
+ *
+ * @param table table to remove from
+ * @param key key to look for
+ * @return 0 on success, non-zero value on failure or if the key is absent
+ */
+int hash_table_remove(hash_table_t * table, void * key);
+
+/**
+ * @brief perform a user defined action on every entry, in no set order
+ *
+ * @param table table to walk
+ * @param action_function function called with each key and value
+ * @param context caller data passed to the action, may be NULL
+ * @return 0 on success, non-zero value on failure
+ */
+int hash_table_foreach_call(hash_table_t * table,
+                            PAIR_ACT_F     action_function,
+                            void *         context);
+
+/**
+ * @brief get the number of entries in the table
+ *
+ * @param table table to measure
+ * @return number of entries, or -1 on failure
+ */
+int hash_table_size(hash_table_t * table);
+
+/**
+ * @brief removes every entry, freeing the keys and values. the slot table is
+ *        kept for reuse
+ *
+ * @param table table to clear out
+ * @return 0 on success, non-zero value on failure
+ */
+int hash_table_clear(hash_table_t * table);
+
+/**
+ * @brief clears a table set up with hash_table_init() and frees its slot
+ *        arrays, leaving the storage to the caller
+ *
+ * @param table table to release
+ * @return 0 on success, non-zero value on failure
+ */
+int hash_table_destroy(hash_table_t * table);
+
+/**
+ * @brief clears and deletes a table
+ *
+ * @param table_address pointer to table pointer
+ * @return 0 on success, non-zero value on failure
+ */
+int hash_table_delete(hash_table_t ** table_address);
+
+#endif
+
+/*** end of file ***/
@@ -0,0 +1,230 @@
+#ifndef _INTRUSIVE_LIST_H
+#define _INTRUSIVE_LIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "comparisons.h"
+
+/**
+ * @brief A pointer to a user-defined free function. This is used to free
+ * objects that are removed from the list.
+ */
+typedef void (*FREE_F)(void *);
+
+/**
+ * @brief A pointer to a user-defined function that gets called in the
+ * foreach_call on each object in the list.
+ */
+typedef void (*ACT_F)(void *);
+
+/**
+ * @brief Links embedded in a user struct so it can sit in an intrusive list.
+ * An object can be in as many lists at once as it has links. A link must be
+ * zeroed before its first push; unlinking zeroes it again.
+ *
+ * @param prev pointer to the link before it
+ * @param next pointer to the link after it
+ */
+typedef struct list_link_t
+{
+    struct list_link_t * prev;
+    struct list_link_t * next;
+} list_link_t;
+
+/**
+ * @brief Returns the struct of type `type` whose member `member` is the link
+ * `link`.
+ */
+#define ILIST_CONTAINER(link, type, member)                                    \
+    ((type *)(void *)((char *)(link) - offsetof(type, member)))
+
+/**
+ * @brief A doubly linked list of objects that embed a list_link_t.
+ *
+ * The list never allocates: pushing an object links its embedded link, and
+ * an object can be unlinked in O(1) given only its address. Every function
+ * takes and returns object pointers; the list converts between objects and
+ * links with the link's offset inside the object.
+ *
+ * @param size number of objects in the list
+ * @param head link of the first object
+ * @param tail link of the last object
+ * @param link_offset offset of the link inside each object
+ * @param custom_free function that releases a removed object, may be NULL
+ * @param compare_func function used to compare objects
+ */
+typedef struct ilist_t
+{
+    uint32_t      size;
+    list_link_t * head;
+    list_link_t * tail;
+    size_t        link_offset;
+    FREE_F        custom_free;
+    CMP_F         compare_func;
+} ilist_t;
+
+/**
+ * @brief creates a new intrusive list
+ *
+ * @param link_offset offset of the list_link_t inside the objects, as given by
+ * offsetof()
+ * @param custom_free function called on objects removed with the remove
+ * functions and list_clear(), or NULL if the list does not own its objects
+ * @param compare_func function used to compare objects
+ * @returns pointer to allocated list on success or NULL on failure
+ */
+ilist_t * ilist_new(size_t link_offset, FREE_F custom_free, CMP_F compare_func);
+
+/**
+ * @brief links an object at the head of the list in O(1)
+ *
+ * @param list list to push the object into
+ * @param object object to push, which must not already be in the list
+ * @return 0 on success, non-zero value on failure
+ */
+int ilist_push_head(ilist_t * list, void * object);
+
+/**
+ * @brief links an object at the tail of the list in O(1)
+ *
+ * @param list list to push the object into
+ * @param object object to push, which must not already be in the list
+ * @return 0 on success, non-zero value on failure
+ */
+int ilist_push_tail(ilist_t * list, void * object);
+
+/**
+ * @brief links an object directly after another one in O(1)
+ *
+ * @param list list holding `position`
+ * @param position object already in the list
+ * @param object object to insert, which must not already be in the list
+ * @return 0 on success, non-zero value on failure
+ */
+int ilist_insert_after(ilist_t * list, void * position, void * object);
+
+/**
+ * @brief unlinks and returns the object at the head of the list
+ *
+ * @param list list to pop the object out of
+ * @return pointer to the popped object on success, NULL on failure
+ */
+void * ilist_pop_head(ilist_t * list);
+
+/**
+ * @brief unlinks and returns the object at the tail of the list
+ *
+ * @param list list to pop the object out of
+ * @return pointer to the popped object on success, NULL on failure
+ */
+void * ilist_pop_tail(ilist_t * list);
+
+/**
+ * @brief returns the object at the head of the list without unlinking it
+ *
+ * @param list list to peek into
+ * @return pointer to the head object, NULL if the list is empty
+ */
+void * ilist_peek_head(ilist_t * list);
+
+/**
+ * @brief returns the object at the tail of the list without unlinking it
+ *
+ * @param list list to peek into
+ * @return pointer to the tail object, NULL if the list is empty
+ */
+void * ilist_peek_tail(ilist_t * list);
+
+/**
+ * @brief returns the object after another one
+ *
+ * @param list list holding the object
+ * @param object object in the list
+ * @return pointer to the next object, NULL at the tail
+ */
+void * ilist_next(ilist_t * list, void * object);
+
+/**
+ * @brief returns the object before another one
+ *
+ * @param list list holding the object
+ * @param object object in the list
+ * @return pointer to the previous object, NULL at the head
+ */
+void * ilist_prev(ilist_t * list, void * object);
+
+/**
+ * @brief unlinks an object from the list in O(1) without freeing it. an
+ *        object that is not linked, because it was already unlinked or its
+ *        zeroed link was never pushed, is refused instead of corrupting the
+ *        list. an object in the middle of a different list can not be told
+ *        apart in O(1) and must not be passed
+ *
+ * @param list list holding the object
+ * @param object object to unlink
+ * @return 0 on success, non-zero value on failure or if the object is not
+ * linked
+ */
+int ilist_unlink(ilist_t * list, void * object);
+
+/**
+ * @brief unlinks an object from the list in O(1) and frees it with the
+ *        list's free function. an object ilist_unlink() refuses is not freed
+ *
+ * @param list list holding the object
+ * @param object object to remove
+ * @return 0 on success, non-zero value on failure
+ */
+int ilist_remove(ilist_t * list, void * object);
+
+/**
+ * @brief perform a user defined action on every object from head to tail.
+ *        the action may unlink or free the object it is called with
+ *
+ * @param list list to perform actions on
+ * @param action_function pointer to user defined action function
+ * @return 0 on success, non-zero value on failure
+ */
+int ilist_foreach_call(ilist_t * list, ACT_F action_function);
+
+/**
+ * @brief find the first object the compare function reports as equal to the
+ *        search data
+ *
+ * @param list list to search through
+ * @param search_data pointer to the data to search for
+ * @return pointer to the object found on success, NULL on failure
+ */
+void * ilist_find_first_occurrence(ilist_t * list, void * search_data);
+
+/**
+ * @brief sort the list with a stable bottom-up merge sort that relinks the
+ *        objects in place, using no extra memory
+ *
+ * @param list pointer to list to be sorted
+ * @return 0 on success, non-zero value on failure
+ */
+int ilist_sort(ilist_t * list);
+
+/**
+ * @brief unlink every object, freeing each with the list's free function
+ *
+ * @param list list to clear out
+ * @return 0 on success, non-zero value on failure
+ */
+int ilist_clear(ilist_t * list);
+
+/**
+ * @brief clear and delete a list
+ *
+ * @param list_address pointer to list pointer
+ * @return 0 on success, non-zero value on failure
+ */
+int ilist_delete(ilist_t ** list_address);
+
+#endif
+
+/*** end of file ***/
@@ -3,11 +3,13 @@
 
 #include <errno.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include "comparisons.h"
+#include "hashing.h"
 
 /**
  * @brief structure of a list node
@@ -50,6 +52,26 @@ typedef void (*FREE_F)(void *);
  */
 typedef void (*ACT_F)(void *);
 
+#define LIST_POOL_DEFAULT_SLAB_NODES 128 // Nodes carved from each slab
+#define LIST_INDEX_MIN_SLOTS         16  // Smallest hash index table
+
+/**
+ * @brief structure of a node pool. nodes are carved out of large slabs and
+ *        recycled through an intrusive free list threaded through their
+ *        `next` pointers, so pushes and removals rarely reach the allocator.
+ *        a pool may be shared by several lists, but not between threads
+ *
+ * @param free_nodes first node of the free list
+ * @param slabs chain of every slab the pool has allocated
+ * @param slab_nodes number of nodes in each slab
+ */
+typedef struct list_node_pool_t
+{
+    list_node_t *           free_nodes;
+    struct list_node_slab * slabs;
+    uint32_t                slab_nodes;
+} list_node_pool_t;
+
 /**
  * @brief structure of a list object
  *
@@ -58,16 +80,57 @@ typedef void (*ACT_F)(void *);
  * @param tail pointer to the tail node
  * @param customfree pointer to the user defined free function
  * @param compare_function pointer to the user defined compare function
+ * @param pool pool the nodes come from, NULL if they are allocated one by one
+ * @param owns_pool whether the pool was created by, and dies with, the list
+ * @param finger node last reached by a positional operation, or NULL
+ * @param finger_index position of the finger node
+ * @param index hash index from values to nodes, NULL unless enabled
  */
 typedef struct list_t
 {
-    uint32_t      size;
-    list_node_t * head;
-    list_node_t * tail;
-    FREE_F        custom_free;
-    CMP_F         compare_func;
+    uint32_t            size;
+    list_node_t *       head;
+    list_node_t *       tail;
+    FREE_F              custom_free;
+    CMP_F               compare_func;
+    list_node_pool_t *  pool;
+    bool                owns_pool;
+    list_node_t *       finger;
+    uint32_t            finger_index;
+    struct list_index * index;
 } list_t;
 
+/**
+ * @brief a position in a list that can move in both directions and edit the
+ *        list where it stands. a cursor whose node is NULL has moved past
+ *        either end of the list
+ *
+ * @param list list the cursor walks
+ * @param node node the cursor is on, or NULL
+ */
+typedef struct list_cursor_t
+{
+    list_t *      list;
+    list_node_t * node;
+} list_cursor_t;
+
+/**
+ * @brief creates a node pool that can be shared between lists
+ *
+ * @param slab_nodes number of nodes to allocate at a time, 0 for the default
+ * @returns pointer to allocated pool on success or NULL on failure
+ */
+list_node_pool_t * list_node_pool_new(uint32_t slab_nodes);
+
+/**
+ * @brief deletes a node pool, releasing all of its slabs at once. every list
+ *        using the pool must be deleted first
+ *
+ * @param pool_address pointer to pool pointer
+ * @return 0 on success, non-zero value on failure
+ */
+int list_node_pool_delete(list_node_pool_t ** pool_address);
+
 /**
  * @brief creates a new list
  *
@@ -78,6 +141,52 @@ typedef struct list_t
  */
 list_t * list_new(FREE_F, CMP_F);
 
+/**
+ * @brief creates a new list whose nodes come from a slab pool. nodes popped
+ *        from the list must be handed back with list_node_release() instead
+ *        of being freed
+ *
+ * @param customfree pointer to the free function to be used with that list
+ * @param compare_function pointer to the compare function to be used with
+ * that list
+ * @param pool pool to share with other lists, or NULL for the list to create
+ * its own, which list_clear() then releases in one go
+ * @returns pointer to allocated list on success or NULL on failure
+ */
+list_t * list_new_pooled(FREE_F, CMP_F, list_node_pool_t * pool);
+
+/**
+ * @brief releases a node popped from a list, returning it to the list's pool
+ *        or freeing it. the node's data is not freed
+ *
+ * @param list list the node was popped from
+ * @param node node to release
+ * @return 0 on success, non-zero value on failure
+ */
+int list_node_release(list_t * list, list_node_t * node);
+
+/**
+ * @brief builds a hash index over the list that maps each value to its node,
+ *        so list_find_first_occurrence(), list_remove_data() and
+ *        list_move_to_front() no longer scan the list. the index is kept up
+ *        to date by every later insert and removal. if the list holds equal
+ *        values, a lookup may return any one of them
+ *
+ * @param list list to index
+ * @param hash_func function hashing the list's data consistently with its
+ * compare function
+ * @return 0 on success, non-zero value on failure
+ */
+int list_enable_index(list_t * list, HASH_F hash_func);
+
+/**
+ * @brief drops the list's hash index, if it has one
+ *
+ * @param list list to stop indexing
+ * @return 0 on success, non-zero value on failure
+ */
+int list_disable_index(list_t * list);
+
 /**
  * @brief pushes a new node onto the head of list
  *
@@ -101,7 +210,8 @@ int list_push_tail(list_t * list, void * data);
  *
  * @param list list to push the node into
  * @param data data to be pushed into node
- * @param position the position in which to insert the node
+ * @param position the position the new node will have, from 0 to the list
+ *        size
  * @return 0 on success, non-zero value on failure
  */
 int list_push_position(list_t * list, void * data, uint32_t position);
@@ -184,7 +294,9 @@ list_node_t * list_peek_tail(list_t * list);
 
 /**
  * @brief get the data from the node at a specific position of the list without
- *        popping
+ *        popping. positional calls walk from the head, the tail or the node
+ *        the previous positional call stopped at, whichever is closest, so
+ *        stepping through a list by position costs O(1) per step
  *
  * @param list list to pop the node out of
  * @param position position of the node
@@ -202,6 +314,16 @@ list_node_t * list_peek_position(list_t * list, uint32_t position);
  */
 int list_remove_data(list_t * list, void ** item_to_remove);
 
+/**
+ * @brief moves the node holding the search data to the head of the list
+ *
+ * @param list list to search through
+ * @param search_data is the pointer to the address of the data to be searched
+ *                    for
+ * @return 0 on success, non-zero value on failure or if no node matches
+ */
+int list_move_to_front(list_t * list, void ** search_data);
+
 /**
  * @brief perform a user defined action on the data contained in all of the
  *        nodes in list
@@ -236,7 +358,139 @@ list_node_t * list_find_first_occurrence(list_t * list, void ** search_data);
 list_t * list_find_all_occurrences(list_t * list, void ** search_data);
 
 /**
- * @brief sort list as per user defined compare function
+ * @brief places a cursor on the head of a list
+ *
+ * @param list list to walk
+ * @param cursor cursor to initialize
+ * @return data of the head node, NULL if the list is empty or on failure
+ */
+void * list_cursor_begin(list_t * list, list_cursor_t * cursor);
+
+/**
+ * @brief places a cursor on the tail of a list
+ *
+ * @param list list to walk
+ * @param cursor cursor to initialize
+ * @return data of the tail node, NULL if the list is empty or on failure
+ */
+void * list_cursor_end(list_t * list, list_cursor_t * cursor);
+
+/**
+ * @brief moves a cursor to the next node
+ *
+ * @param cursor cursor to move
+ * @return data of the new node, NULL once the cursor moves past the tail
+ */
+void * list_cursor_next(list_cursor_t * cursor);
+
+/**
+ * @brief moves a cursor to the previous node
+ *
+ * @param cursor cursor to move
+ * @return data of the new node, NULL once the cursor moves past the head
+ */
+void * list_cursor_prev(list_cursor_t * cursor);
+
+/**
+ * @brief get the data of the node a cursor is on
+ *
+ * @param cursor cursor to read
+ * @return data of the node, NULL if the cursor is past either end
+ */
+void * list_cursor_get(list_cursor_t * cursor);
+
+/**
+ * @brief inserts a new node in front of the cursor in O(1). a cursor past
+ *        either end inserts at the tail. the cursor stays where it is
+ *
+ * @param cursor cursor to insert at
+ * @param data data to be pushed into node
+ * @return 0 on success, non-zero value on failure
+ */
+int list_cursor_insert_before(list_cursor_t * cursor, void * data);
+
+/**
+ * @brief inserts a new node after the cursor in O(1). the cursor stays
+ *        where it is
+ *
+ * @param cursor cursor on a node
+ * @param data data to be pushed into node
+ * @return 0 on success, non-zero value on failure
+ */
+int list_cursor_insert_after(list_cursor_t * cursor, void * data);
+
+/**
+ * @brief removes the node under the cursor in O(1), freeing its data, and
+ *        moves the cursor to the following node
+ *
+ * @param cursor cursor on a node
+ * @return 0 on success, non-zero value on failure
+ */
+int list_cursor_erase(list_cursor_t * cursor);
+
+/**
+ * @brief removes every node whose data the predicate returns true for, in a
+ *        single pass, freeing the data
+ *
+ * @param list list to filter
+ * @param predicate function called with each node's data and the context
+ * @param context caller data passed to the predicate, may be NULL
+ * @return number of nodes removed, or -1 on failure
+ */
+int list_remove_if(list_t * list, PRED_F predicate, void * context);
+
+/**
+ * @brief moves every node of one list onto the tail of another without
+ *        copying or allocating. `src` is left empty
+ *
+ * @param dst list to append to
+ * @param src list whose nodes are moved, which must use the same node pool
+ * as `dst` without either list owning it
+ * @return 0 on success, non-zero value on failure
+ */
+int list_concat(list_t * dst, list_t * src);
+
+/**
+ * @brief moves the nodes from `first` to `last` out of `src` and links them
+ *        in front of `position` in `dst`, without copying or allocating.
+ *        relinking is O(1); keeping the sizes right costs a walk of the
+ *        range or of the rest of `src`, whichever is shorter, and nothing
+ *        when `dst` and `src` are the same list
+ *
+ * @param dst list to move the nodes into
+ * @param position node of `dst` to insert in front of, or NULL for the tail
+ * @param src list holding the range, which must use the same node pool as
+ * `dst`, and neither list may own that pool unless they are the same list.
+ * it may be `dst` itself if `position` lies outside the range. the
+ * range is also walked when moving it between lists that are indexed
+ * @param first first node of the range
+ * @param last last node of the range, `first` itself or a node after it
+ * @return 0 on success, non-zero value on failure
+ */
+int list_splice(list_t *      dst,
+                list_node_t * position,
+                list_t *      src,
+                list_node_t * first,
+                list_node_t * last);
+
+/**
+ * @brief splits a list in two in front of a node. the node and every node
+ *        after it move to a new list, which shares the original's free and
+ *        compare functions and node pool. a list that owns its pool cannot
+ *        be split, since clearing or deleting it releases every node of the
+ *        pool. the new list is not indexed
+ *
+ * @param list list to split
+ * @param node node of the list that becomes the head of the new list
+ * @return pointer to the new list on success, NULL on failure
+ */
+list_t * list_split_at(list_t * list, list_node_t * node);
+
+/**
+ * @brief sort list as per user defined compare function. the sort is a
+ *        stable, iterative merge of the list's natural runs that relinks the
+ *        nodes in place without allocating, so an already ordered list sorts
+ *        in O(n) and a reversed one in O(n) as well
  *
  * @param list pointer to list to be sorted
  * @return 0 on success, non-zero value on failure
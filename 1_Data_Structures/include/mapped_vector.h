@@ -0,0 +1,115 @@
+#ifndef _MAPPED_VECTOR_H
+#define _MAPPED_VECTOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "comparisons.h"
+#include "vector.h"
+
+#define MAPPED_VECTOR_HEADER_SIZE 64 // Bytes before the first value in a file
+
+/**
+ * @brief A typed vector whose values live in a memory-mapped file.
+ *
+ * The file starts with a MAPPED_VECTOR_HEADER_SIZE byte header recording the
+ * element size, element count and capacity, followed by the values exactly as
+ * they sit in memory. Opening a file maps it without parsing or copying, so
+ * another process sees a saved vector as soon as it opens it. Values must be
+ * plain data: pointers stored in them are meaningless to another process.
+ *
+ * Growing the vector extends the file with ftruncate() and remaps it, with
+ * mremap() on Linux. All other operations go through `vector`, a typed
+ * vector_t whose buffer is the mapping, so every vector.h call that does not
+ * need more room works on it unchanged. Calls that would reallocate the
+ * buffer, such as vector_append() on a full view or vector_shrink_to_fit(),
+ * fail instead. The view must never be passed to vector_delete().
+ *
+ * The header is only rewritten by mapped_vector_sync() and
+ * mapped_vector_close(), which also persist the sorted flag and key type.
+ *
+ * @param vector typed vector over the mapped values
+ * @param fd descriptor of the backing file
+ * @param map start of the mapping, where the header lives
+ * @param map_size length of the mapping in bytes
+ * @param read_only whether the file was opened read-only; changes are then
+ * private to this process and the vector cannot grow
+ */
+typedef struct mapped_vector
+{
+    vector_t vector;
+    int      fd;
+    void *   map;
+    size_t   map_size;
+    bool     read_only;
+} mapped_vector_t;
+
+/**
+ * @brief Opens a mapped vector, creating an empty one if the file does not
+ * exist and `read_only` is false.
+ * @param path Path of the backing file.
+ * @param elem_size Size in bytes of one element. Must match the size the file
+ * was created with.
+ * @param compare_func Function pointer to a comparison function, called with
+ * the addresses of two values.
+ * @param read_only Maps the file privately without write access to it.
+ * @return A pointer to the opened vector, or NULL on failure.
+ */
+mapped_vector_t * mapped_vector_open(const char * path,
+                                     size_t       elem_size,
+                                     CMP_F        compare_func,
+                                     bool         read_only);
+
+/**
+ * @brief Returns the vector_t over the mapped values, for use with the
+ * vector.h functions. It stays valid until the next call that grows the
+ * mapped vector.
+ * @param mapped Pointer to the mapped vector.
+ * @return Pointer to the view, or NULL on failure.
+ */
+vector_t * mapped_vector_view(mapped_vector_t * mapped);
+
+/**
+ * @brief Grows the backing file so that it holds at least `capacity` values.
+ * @param mapped Pointer to the mapped vector.
+ * @param capacity Minimum capacity required.
+ * @return Status code indicating success or failure.
+ */
+int mapped_vector_reserve(mapped_vector_t * mapped, int capacity);
+
+/**
+ * @brief Appends a value, growing the backing file by the vector's growth
+ * factor when it is full.
+ * @param mapped Pointer to the mapped vector.
+ * @param data Pointer to the value to append.
+ * @return Status code indicating success or failure.
+ */
+int mapped_vector_append(mapped_vector_t * mapped, void * data);
+
+/**
+ * @brief Appends `count` consecutive values with a single copy.
+ * @param mapped Pointer to the mapped vector.
+ * @param data Pointer to the first of the values.
+ * @param count Number of values to append.
+ * @return Status code indicating success or failure.
+ */
+int mapped_vector_append_many(mapped_vector_t * mapped, void * data, int count);
+
+/**
+ * @brief Writes the header and flushes the mapping to the file, as a
+ * checkpoint that survives a crash of the process.
+ * @param mapped Pointer to the mapped vector.
+ * @return Status code indicating success or failure.
+ */
+int mapped_vector_sync(mapped_vector_t * mapped);
+
+/**
+ * @brief Syncs a writable vector, then unmaps and closes it.
+ * @param mapped Pointer to a pointer to the mapped vector.
+ * @return Status code indicating success or failure.
+ */
+int mapped_vector_close(mapped_vector_t ** mapped);
+
+#endif
+
+/*** end of file ***/
@@ -0,0 +1,170 @@
+#ifndef _QUEUE_H
+#define _QUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define QUEUE_CACHE_LINE       64 // Head and tail are kept on separate lines
+#define QUEUE_HAZARDS          2  // Hazard pointers each operation needs
+#define QUEUE_RETIRE_THRESHOLD 64 // Retired nodes held past the hazard count
+
+/**
+ * @brief A pointer to a user-defined free function. This is used to free
+ * memory allocated for queue data.
+ */
+typedef void (*FREE_F)(void *);
+
+/**
+ * @brief structure of a queue node. the node at the head of the queue is a
+ *        dummy whose data has already been dequeued
+ *
+ * @param next pointer to the node after it
+ * @param data pointer to the data it holds
+ */
+typedef struct queue_node_t
+{
+    _Atomic(struct queue_node_t *) next;
+    void *                         data;
+} queue_node_t;
+
+/**
+ * @brief hazard pointers of one thread working on a queue. a node published
+ *        in a hazard slot is not freed until the slot is cleared. records
+ *        are claimed for the length of one operation and are never freed
+ *        before the queue is deleted
+ *
+ * @param hazards nodes the owning thread is about to read
+ * @param active set while a thread holds the record
+ * @param next pointer to the next record of the queue
+ * @param retired nodes removed by the holder that are waiting to be freed.
+ * the array grows instead of waiting for hazards to clear, so a stalled
+ * thread never holds up the others
+ * @param retired_count number of retired nodes
+ * @param retired_capacity number of nodes the retired array holds
+ */
+typedef struct queue_hazard_t
+{
+    _Atomic(queue_node_t *) hazards[QUEUE_HAZARDS];
+    atomic_bool             active;
+    struct queue_hazard_t * next;
+    queue_node_t **         retired;
+    uint32_t                retired_count;
+    uint32_t                retired_capacity;
+} queue_hazard_t;
+
+/**
+ * @brief A first in, first out queue that any number of threads can enqueue
+ * to and dequeue from at once without locks.
+ *
+ * This is the Michael-Scott queue: enqueues link a node after the tail with
+ * a compare-and-swap and dequeues swing the head to the next node, so
+ * producers and consumers only contend with each other when the queue is
+ * nearly empty. Removed nodes are reclaimed with hazard pointers: a thread
+ * publishes the nodes it is about to read, and a node is only freed once no
+ * thread has it published.
+ *
+ * NULL cannot be stored, because a dequeue from an empty queue returns it.
+ *
+ * @param head pointer to the dummy node before the first item
+ * @param tail pointer to the last node, or one behind it mid-enqueue
+ * @param hazards list of hazard records of threads using the queue
+ * @param record_count number of records in the list
+ * @param id number that tells a thread's cached record apart from one of a
+ * deleted queue that shared this address
+ * @param custom_free function that releases items left in the queue, may be
+ * NULL if the queue does not own its items
+ */
+typedef struct queue_t
+{
+    _Alignas(QUEUE_CACHE_LINE) _Atomic(queue_node_t *) head;
+    _Alignas(QUEUE_CACHE_LINE) _Atomic(queue_node_t *) tail;
+    _Alignas(QUEUE_CACHE_LINE) _Atomic(queue_hazard_t *) hazards;
+    atomic_uint record_count;
+    uint64_t    id;
+    FREE_F      custom_free;
+} queue_t;
+
+/**
+ * @brief creates a new queue
+ *
+ * @param custom_free function called on items still in the queue when it is
+ * cleared or deleted, or NULL if the queue does not own its items
+ * @returns pointer to allocated queue on success or NULL on failure
+ */
+queue_t * queue_new(FREE_F custom_free);
+
+/**
+ * @brief adds an item to the back of the queue. safe to call from any number
+ *        of threads at once
+ *
+ * @param queue queue to add the item to
+ * @param data item to add, which must not be NULL
+ * @return 0 on success, non-zero value on failure
+ */
+int queue_enqueue(queue_t * queue, void * data);
+
+/**
+ * @brief adds several items to the back of the queue in order. the items are
+ *        linked into a chain first and published with a single
+ *        compare-and-swap, so they appear together and in order
+ *
+ * @param queue queue to add the items to
+ * @param items array of items, none of which may be NULL
+ * @param count number of items in the array
+ * @return 0 on success, non-zero value on failure
+ */
+int queue_enqueue_batch(queue_t * queue, void ** items, uint32_t count);
+
+/**
+ * @brief removes the item at the front of the queue. safe to call from any
+ *        number of threads at once
+ *
+ * @param queue queue to remove the item from
+ * @return pointer to the item, NULL if the queue is empty or on failure
+ */
+void * queue_dequeue(queue_t * queue);
+
+/**
+ * @brief removes up to `max_items` items from the front of the queue. other
+ *        consumers may take items in between, so the items need not have
+ *        been adjacent in the queue
+ *
+ * @param queue queue to remove the items from
+ * @param items array that receives the items in queue order
+ * @param max_items most items to remove
+ * @return number of items removed, or -1 on failure
+ */
+int queue_dequeue_batch(queue_t * queue, void ** items, uint32_t max_items);
+
+/**
+ * @brief checks if the queue is empty. with other threads running the answer
+ *        may be out of date as soon as it is returned
+ *
+ * @param queue queue to check
+ * @return true if the queue is empty or NULL, false otherwise
+ */
+bool queue_is_empty(queue_t * queue);
+
+/**
+ * @brief dequeues every item, freeing each with the queue's free function
+ *
+ * @param queue queue to clear out
+ * @return 0 on success, non-zero value on failure
+ */
+int queue_clear(queue_t * queue);
+
+/**
+ * @brief clears and deletes a queue. no other thread may use the queue
+ *        during or after the call
+ *
+ * @param queue_address pointer to queue pointer
+ * @return 0 on success, non-zero value on failure
+ */
+int queue_delete(queue_t ** queue_address);
+
+#endif
+
+/*** end of file ***/
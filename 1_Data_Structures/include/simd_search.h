@@ -0,0 +1,110 @@
+#ifndef _SIMD_SEARCH_H
+#define _SIMD_SEARCH_H
+
+#include <stdint.h>
+
+/**
+ * Linear search kernels for arrays of primitive keys. Every call picks the
+ * widest instruction set the CPU supports at run time (AVX-512, AVX2 or SSE2
+ * on x86) and falls back to a scalar loop elsewhere. Floats are compared with
+ * `==`, so NaN never matches and -0.0 matches 0.0.
+ */
+
+/**
+ * @brief Instruction sets the kernels can be dispatched to, narrowest first.
+ */
+typedef enum search_level
+{
+    SEARCH_SCALAR = 0,
+    SEARCH_SSE2,
+    SEARCH_AVX2,
+    SEARCH_AVX512
+} search_level_t;
+
+/**
+ * @brief Returns the instruction set the kernels currently dispatch to.
+ * @return The active search level.
+ */
+search_level_t search_get_level(void);
+
+/**
+ * @brief Caps the instruction set the kernels may use, for example to compare
+ * implementations. Levels the CPU does not support are lowered to the widest
+ * one it does.
+ * @param level Widest level to use.
+ * @return The level now in effect.
+ */
+search_level_t search_set_level(search_level_t level);
+
+/**
+ * @brief Finds the first element equal to a key.
+ * @param array Array to search.
+ * @param count Number of elements in the array.
+ * @param key Value to search for.
+ * @return Index of the first match, or -1 if there is none.
+ */
+int search_find_i32(const int32_t * array, int count, int32_t key);
+
+/**
+ * @brief Finds the first element equal to a key.
+ * @param array Array to search.
+ * @param count Number of elements in the array.
+ * @param key Value to search for.
+ * @return Index of the first match, or -1 if there is none.
+ */
+int search_find_i64(const int64_t * array, int count, int64_t key);
+
+/**
+ * @brief Finds the first element equal to a key.
+ * @param array Array to search.
+ * @param count Number of elements in the array.
+ * @param key Value to search for.
+ * @return Index of the first match, or -1 if there is none.
+ */
+int search_find_float(const float * array, int count, float key);
+
+/**
+ * @brief Finds every element equal to a key.
+ * @param array Array to search.
+ * @param count Number of elements in the array.
+ * @param key Value to search for.
+ * @param indices Receives the indices of the matches in ascending order. Must
+ * have room for `count` entries.
+ * @return Number of matches.
+ */
+int search_find_all_i32(const int32_t * array,
+                        int             count,
+                        int32_t         key,
+                        int *           indices);
+
+/**
+ * @brief Finds every element equal to a key.
+ * @param array Array to search.
+ * @param count Number of elements in the array.
+ * @param key Value to search for.
+ * @param indices Receives the indices of the matches in ascending order. Must
+ * have room for `count` entries.
+ * @return Number of matches.
+ */
+int search_find_all_i64(const int64_t * array,
+                        int             count,
+                        int64_t         key,
+                        int *           indices);
+
+/**
+ * @brief Finds every element equal to a key.
+ * @param array Array to search.
+ * @param count Number of elements in the array.
+ * @param key Value to search for.
+ * @param indices Receives the indices of the matches in ascending order. Must
+ * have room for `count` entries.
+ * @return Number of matches.
+ */
+int search_find_all_float(const float * array,
+                          int           count,
+                          float         key,
+                          int *         indices);
+
+#endif
+
+/*** end of file ***/
@@ -0,0 +1,295 @@
+#ifndef _SORTS_H
+#define _SORTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "comparisons.h"
+
+/**
+ * All comparison based sorts order elements ascending by `compare_func`: an
+ * element is placed before another when `compare_func(a, b)` returns
+ * LESS_THAN. Functions return E_SUCCESS or E_FAILURE like the rest of the
+ * library.
+ */
+
+/**
+ * @brief Sorts an array of fixed-size elements with pattern-defeating
+ * quicksort. Runs in O(n log n) worst case, O(n) on sorted, reversed and
+ * all-equal inputs, and is not stable.
+ * @param base Pointer to the first element.
+ * @param count Number of elements.
+ * @param elem_size Size in bytes of one element.
+ * @param compare_func Comparison function, called with element addresses.
+ * @return Status code indicating success or failure.
+ */
+int sort_pdq(void * base, size_t count, size_t elem_size, CMP_F compare_func);
+
+/**
+ * @brief Sorts an array of pointers with pattern-defeating quicksort by the
+ * data they point to.
+ * @param array Pointer to the first pointer.
+ * @param count Number of pointers.
+ * @param compare_func Comparison function, called with the stored pointers.
+ * @return Status code indicating success or failure.
+ */
+int sort_pdq_ptrs(void ** array, size_t count, CMP_F compare_func);
+
+/**
+ * @brief Sorts an array of fixed-size elements with a stable bottom-up merge
+ * sort. Uses a temporary buffer the size of the array.
+ * @param base Pointer to the first element.
+ * @param count Number of elements.
+ * @param elem_size Size in bytes of one element.
+ * @param compare_func Comparison function, called with element addresses.
+ * @return Status code indicating success or failure.
+ */
+int sort_merge(void * base, size_t count, size_t elem_size, CMP_F compare_func);
+
+/**
+ * @brief Sorts an array of pointers with a stable merge sort by the data they
+ * point to.
+ * @param array Pointer to the first pointer.
+ * @param count Number of pointers.
+ * @param compare_func Comparison function, called with the stored pointers.
+ * @return Status code indicating success or failure.
+ */
+int sort_merge_ptrs(void ** array, size_t count, CMP_F compare_func);
+
+/**
+ * @brief Sorts an array of fixed-size elements on several threads. Each
+ * thread pdqsorts one slice, then the slices are merged in parallel rounds.
+ * Inputs below a sequential cutoff are sorted on the calling thread. The sort
+ * is not stable and uses a temporary buffer the size of the array.
+ * @param base Pointer to the first element.
+ * @param count Number of elements.
+ * @param elem_size Size in bytes of one element.
+ * @param compare_func Comparison function, called with element addresses. It
+ * is called from several threads at once.
+ * @param nthreads Number of threads to use, or 0 for one per online CPU.
+ * @return Status code indicating success or failure.
+ */
+int sort_parallel(void * base,
+                  size_t count,
+                  size_t elem_size,
+                  CMP_F  compare_func,
+                  int    nthreads);
+
+/**
+ * @brief Sorts an array of pointers on several threads by the data they point
+ * to, in the same way as sort_parallel().
+ * @param array Pointer to the first pointer.
+ * @param count Number of pointers.
+ * @param compare_func Comparison function, called with the stored pointers.
+ * @param nthreads Number of threads to use, or 0 for one per online CPU.
+ * @return Status code indicating success or failure.
+ */
+int sort_parallel_ptrs(void ** array,
+                       size_t  count,
+                       CMP_F   compare_func,
+                       int     nthreads);
+
+/**
+ * @brief Sorts unsigned 32-bit keys with an LSD radix sort.
+ * @param array Pointer to the first key.
+ * @param count Number of keys.
+ * @return Status code indicating success or failure.
+ */
+int sort_radix_u32(uint32_t * array, size_t count);
+
+/**
+ * @brief Sorts unsigned 64-bit keys with an LSD radix sort.
+ * @param array Pointer to the first key.
+ * @param count Number of keys.
+ * @return Status code indicating success or failure.
+ */
+int sort_radix_u64(uint64_t * array, size_t count);
+
+/**
+ * @brief Sorts signed 32-bit keys with an LSD radix sort.
+ * @param array Pointer to the first key.
+ * @param count Number of keys.
+ * @return Status code indicating success or failure.
+ */
+int sort_radix_i32(int32_t * array, size_t count);
+
+/**
+ * @brief Sorts signed 64-bit keys with an LSD radix sort.
+ * @param array Pointer to the first key.
+ * @param count Number of keys.
+ * @return Status code indicating success or failure.
+ */
+int sort_radix_i64(int64_t * array, size_t count);
+
+/**
+ * @brief Sorts floats with an LSD radix sort on their IEEE-754 bit patterns.
+ * Negative zero sorts before positive zero, and NaNs sort to the end (or the
+ * start, for NaNs with the sign bit set).
+ * @param array Pointer to the first key.
+ * @param count Number of keys.
+ * @return Status code indicating success or failure.
+ */
+int sort_radix_float(float * array, size_t count);
+
+/**
+ * @brief Sorts doubles with an LSD radix sort on their IEEE-754 bit patterns,
+ * ordered the same way as sort_radix_float().
+ * @param array Pointer to the first key.
+ * @param count Number of keys.
+ * @return Status code indicating success or failure.
+ */
+int sort_radix_double(double * array, size_t count);
+
+/**
+ * @brief Default ordering for SORTS_DEFINE_INTROSORT(): the `<` operator.
+ */
+#define SORTS_LESS(a, b) ((a) < (b))
+
+/**
+ * @brief Generates `static void name(type * array, size_t count)`, an
+ * introsort specialized for `type` with the comparison `less(a, b)` inlined
+ * instead of called through a CMP_F pointer.
+ *
+ * `less` is a function-like macro or function taking two `type` values and
+ * returning non-zero when the first sorts before the second, for example
+ * SORTS_LESS. The generated sort is not stable.
+ *
+ * Usage:
+ *     #define POINT_LESS(a, b) ((a).x < (b).x)
+ *     SORTS_DEFINE_INTROSORT(sort_points, point_t, POINT_LESS)
+ */
+#define SORTS_DEFINE_INTROSORT(name, type, less)                              \
+    static inline void name##_insertion(type * array, size_t count)          \
+    {                                                                          \
+        for (size_t cur = 1; cur < count; cur++)                               \
+        {                                                                      \
+            type   tmp  = array[cur];                                          \
+            size_t sift = cur;                                                 \
+            while ((0 < sift) && less(tmp, array[sift - 1]))                   \
+            {                                                                  \
+                array[sift] = array[sift - 1];                                 \
+                sift--;                                                        \
+            }                                                                  \
+            array[sift] = tmp;                                                 \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static inline void name##_sift_down(                                       \
+        type * array, size_t root, size_t count)                               \
+    {                                                                          \
+        type tmp = array[root];                                                \
+        for (size_t child = (2 * root) + 1; child < count;                     \
+             child        = (2 * root) + 1)                                    \
+        {                                                                      \
+            if ((child + 1 < count) && less(array[child], array[child + 1]))   \
+            {                                                                  \
+                child++;                                                       \
+            }                                                                  \
+            if (!less(tmp, array[child]))                                      \
+            {                                                                  \
+                break;                                                         \
+            }                                                                  \
+            array[root] = array[child];                                        \
+            root        = child;                                               \
+        }                                                                      \
+        array[root] = tmp;                                                     \
+    }                                                                          \
+                                                                               \
+    static inline void name##_heapsort(type * array, size_t count)            \
+    {                                                                          \
+        for (size_t idx = count / 2; 0 < idx; idx--)                           \
+        {                                                                      \
+            name##_sift_down(array, idx - 1, count);                           \
+        }                                                                      \
+        for (size_t end = count - 1; 0 < end; end--)                           \
+        {                                                                      \
+            type tmp   = array[0];                                             \
+            array[0]   = array[end];                                           \
+            array[end] = tmp;                                                  \
+            name##_sift_down(array, 0, end);                                   \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static inline void name##_loop(type * array, size_t count, int depth)     \
+    {                                                                          \
+        while (16 < count)                                                     \
+        {                                                                      \
+            type * lo  = array;                                                \
+            type * mid = array + (count / 2);                                  \
+            type * hi  = array + (count - 1);                                  \
+            type   pivot;                                                      \
+            type   tmp;                                                        \
+                                                                               \
+            if (0 == depth--)                                                  \
+            {                                                                  \
+                name##_heapsort(array, count);                                 \
+                return;                                                        \
+            }                                                                  \
+                                                                               \
+            /* Median of three, leaving sentinels at both ends */              \
+            if (less(*mid, *lo))                                               \
+            {                                                                  \
+                tmp = *mid, *mid = *lo, *lo = tmp;                             \
+            }                                                                  \
+            if (less(*hi, *mid))                                               \
+            {                                                                  \
+                tmp = *hi, *hi = *mid, *mid = tmp;                             \
+                if (less(*mid, *lo))                                           \
+                {                                                              \
+                    tmp = *mid, *mid = *lo, *lo = tmp;                         \
+                }                                                              \
+            }                                                                  \
+            pivot = *mid;                                                      \
+                                                                               \
+            /* Hoare partition around the pivot value */                       \
+            for (;;)                                                           \
+            {                                                                  \
+                while (less(*lo, pivot))                                       \
+                {                                                              \
+                    lo++;                                                      \
+                }                                                              \
+                while (less(pivot, *hi))                                       \
+                {                                                              \
+                    hi--;                                                      \
+                }                                                              \
+                if (lo >= hi)                                                  \
+                {                                                              \
+                    break;                                                     \
+                }                                                              \
+                tmp = *lo, *lo = *hi, *hi = tmp;                               \
+                lo++;                                                          \
+                hi--;                                                          \
+            }                                                                  \
+                                                                               \
+            /* Recurse into the smaller side, loop on the larger one */        \
+            if ((size_t)(hi + 1 - array) < count - (size_t)(hi + 1 - array))   \
+            {                                                                  \
+                name##_loop(array, (size_t)(hi + 1 - array), depth);           \
+                count -= (size_t)(hi + 1 - array);                             \
+                array = hi + 1;                                                \
+            }                                                                  \
+            else                                                               \
+            {                                                                  \
+                name##_loop(hi + 1, count - (size_t)(hi + 1 - array), depth);  \
+                count = (size_t)(hi + 1 - array);                              \
+            }                                                                  \
+        }                                                                      \
+        name##_insertion(array, count);                                        \
+    }                                                                          \
+                                                                               \
+    static inline void name(type * array, size_t count)                       \
+    {                                                                          \
+        int depth = 0;                                                         \
+        for (size_t len = count; 1 < len; len >>= 1)                           \
+        {                                                                      \
+            depth += 2;                                                        \
+        }                                                                      \
+        if (1 < count)                                                         \
+        {                                                                      \
+            name##_loop(array, count, depth);                                  \
+        }                                                                      \
+    }
+
+#endif
+
+/*** end of file ***/
@@ -0,0 +1,246 @@
+#ifndef _UNROLLED_LIST_H
+#define _UNROLLED_LIST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "comparisons.h"
+
+#define ULIST_CACHE_LINE 64 // Nodes are allocated in whole cache lines
+
+/**
+ * @brief A pointer to a user-defined free function. This is used to free
+ * memory allocated for list data.
+ */
+typedef void (*FREE_F)(void *);
+
+/**
+ * @brief A pointer to a user-defined function that gets called in the
+ * foreach_call on each item in the list.
+ */
+typedef void (*ACT_F)(void *);
+
+/**
+ * @brief structure of an unrolled list node, a small array of data pointers
+ *
+ * @param prev pointer to the node before it
+ * @param next pointer to the node after it
+ * @param count number of items in use
+ * @param items data pointers, `count` of them in list order
+ */
+typedef struct ulist_node_t
+{
+    struct ulist_node_t * prev;
+    struct ulist_node_t * next;
+    uint32_t              count;
+    void *                items[];
+} ulist_node_t;
+
+/**
+ * @brief structure of an unrolled list object. each node holds up to
+ *        `node_items` data pointers in a block of whole cache lines, so a
+ *        traversal touches one cache line per several items instead of one
+ *        per item. a full node splits in half on insert, and a node that
+ *        falls below half full merges with or borrows from its neighbour
+ *
+ * @param size number of items in the list
+ * @param head pointer to the head node
+ * @param tail pointer to the tail node
+ * @param node_items number of items each node can hold
+ * @param custom_free pointer to the user defined free function
+ * @param compare_func pointer to the user defined compare function
+ */
+typedef struct ulist_t
+{
+    uint32_t       size;
+    ulist_node_t * head;
+    ulist_node_t * tail;
+    uint32_t       node_items;
+    FREE_F         custom_free;
+    CMP_F          compare_func;
+} ulist_t;
+
+/**
+ * @brief creates a new unrolled list
+ *
+ * @param custom_free pointer to the free function to be used with that list
+ * @param compare_func pointer to the compare function to be used with that
+ * list
+ * @param node_items minimum number of items per node, or 0 for nodes of two
+ * cache lines. the count is rounded up to fill the node's last cache line
+ * @returns pointer to allocated list on success or NULL on failure
+ */
+ulist_t * ulist_new(FREE_F   custom_free,
+                    CMP_F    compare_func,
+                    uint32_t node_items);
+
+/**
+ * @brief pushes an item onto the head of the list
+ *
+ * @param list list to push the item into
+ * @param data data to be pushed
+ * @returns 0 on success, non-zero value on failure
+ */
+int ulist_push_head(ulist_t * list, void * data);
+
+/**
+ * @brief pushes an item onto the tail of the list
+ *
+ * @param list list to push the item into
+ * @param data data to be pushed
+ * @return 0 on success, non-zero value on failure
+ */
+int ulist_push_tail(ulist_t * list, void * data);
+
+/**
+ * @brief pushes an item into the list at a specific position
+ *
+ * @param list list to push the item into
+ * @param data data to be pushed
+ * @param position the position to insert at, from 0 to the list size
+ * @return 0 on success, non-zero value on failure
+ */
+int ulist_push_position(ulist_t * list, void * data, uint32_t position);
+
+/**
+ * @brief checks if the list object is empty
+ *
+ * @param list pointer to list object to be checked
+ * @returns 0 if list is empty, non-zero value if not empty
+ */
+int ulist_emptycheck(ulist_t * list);
+
+/**
+ * @brief pops the head item out of the list
+ *
+ * @param list list to pop the item out of
+ * @return pointer to the popped data on success, NULL on failure
+ */
+void * ulist_pop_head(ulist_t * list);
+
+/**
+ * @brief pops the tail item out of the list
+ *
+ * @param list list to pop the item out of
+ * @return pointer to the popped data on success, NULL on failure
+ */
+void * ulist_pop_tail(ulist_t * list);
+
+/**
+ * @brief pops an item out of the list at a specific position
+ *
+ * @param list list to pop the item out of
+ * @param position position of the item
+ * @return pointer to the popped data on success, NULL on failure
+ */
+void * ulist_pop_position(ulist_t * list, uint32_t position);
+
+/**
+ * @brief removes the head item of the list and frees its data
+ *
+ * @param list list to remove the item from
+ * @return 0 on success, non-zero value on failure
+ */
+int ulist_remove_head(ulist_t * list);
+
+/**
+ * @brief removes the tail item of the list and frees its data
+ *
+ * @param list list to remove the item from
+ * @return 0 on success, non-zero value on failure
+ */
+int ulist_remove_tail(ulist_t * list);
+
+/**
+ * @brief removes the item at a specific position and frees its data
+ *
+ * @param list list to remove the item from
+ * @param position position of the item
+ * @return 0 on success, non-zero value on failure
+ */
+int ulist_remove_position(ulist_t * list, uint32_t position);
+
+/**
+ * @brief get the head item of the list without popping
+ *
+ * @param list list to peek into
+ * @return pointer to the data on success, NULL on failure
+ */
+void * ulist_peek_head(ulist_t * list);
+
+/**
+ * @brief get the tail item of the list without popping
+ *
+ * @param list list to peek into
+ * @return pointer to the data on success, NULL on failure
+ */
+void * ulist_peek_tail(ulist_t * list);
+
+/**
+ * @brief get the item at a specific position without popping. whole nodes
+ *        are skipped by their counts, from whichever end is nearer
+ *
+ * @param list list to peek into
+ * @param position position of the item
+ * @return pointer to the data on success, NULL on failure
+ */
+void * ulist_peek_position(ulist_t * list, uint32_t position);
+
+/**
+ * @brief remove the first item the compare function reports as equal to
+ *        the given data, freeing it
+ *
+ * @param list list to remove the item from
+ * @param item_to_remove the data to search for
+ * @return 0 on success, non-zero value on failure
+ */
+int ulist_remove_data(ulist_t * list, void * item_to_remove);
+
+/**
+ * @brief perform a user defined action on the data of every item, from head
+ *        to tail
+ *
+ * @param list list to perform actions on
+ * @param action_function pointer to user defined action function
+ * @return 0 on success, non-zero value on failure
+ */
+int ulist_foreach_call(ulist_t * list, ACT_F action_function);
+
+/**
+ * @brief find the first item the compare function reports as equal to the
+ *        search data
+ *
+ * @param list list to search through
+ * @param search_data pointer to the data to search for
+ * @return pointer to the data found on success, NULL on failure
+ */
+void * ulist_find_first_occurrence(ulist_t * list, void * search_data);
+
+/**
+ * @brief sort list as per user defined compare function. the sort is stable
+ *
+ * @param list pointer to list to be sorted
+ * @return 0 on success, non-zero value on failure
+ */
+int ulist_sort(ulist_t * list);
+
+/**
+ * @brief clear all items out of a list, freeing their data
+ *
+ * @param list list to clear out
+ * @return 0 on success, non-zero value on failure
+ */
+int ulist_clear(ulist_t * list);
+
+/**
+ * @brief delete a list
+ *
+ * @param list_address pointer to list pointer
+ * @return 0 on success, non-zero value on failure
+ */
+int ulist_delete(ulist_t ** list_address);
+
+#endif
+
+/*** end of file ***/
@@ -8,6 +8,10 @@
 
 #include "comparisons.h"
 
+// Growth factor applied to the capacity of a full vector unless changed with
+// vector_set_growth_factor()
+#define VECTOR_DEFAULT_GROWTH_FACTOR 2.0
+
 /**
  * @brief A pointer to a user-defined function that gets called in the
  * foreach_call on each item in the vector.
@@ -22,13 +26,65 @@ typedef void (*ACT_F)(void *);
  */
 typedef void (*FREE_F)(void *);
 
+/**
+ * @brief Primitive key types a typed vector can declare. Searches in a vector
+ * with a key type compare values directly with SIMD kernels instead of calling
+ * compare_func on every element.
+ */
+typedef enum vector_key_type
+{
+    VECTOR_KEY_NONE = 0,
+    VECTOR_KEY_INT32,
+    VECTOR_KEY_INT64,
+    VECTOR_KEY_FLOAT
+} vector_key_t;
+
+/**
+ * @brief A dynamic array of elements.
+ *
+ * A vector either stores `void *` pointers to caller-owned data (created with
+ * `vector_new()`), or stores fixed-size values inline in one contiguous buffer
+ * (created with `vector_new_typed()`). In a typed vector every call that takes
+ * `data` copies `elem_size` bytes from it, and every call that returns an
+ * element returns the address of the value inside the buffer. That address is
+ * only valid until the next call that inserts into the vector.
+ *
+ * A vector remembers when its elements are in ascending order, which is set
+ * by the sort functions and kept while elements are only appended in order,
+ * removed or inserted with vector_insert_sorted(). Finding an element in a
+ * sorted vector is a binary search. Changing an element in place through a
+ * returned address does not clear the flag; sort the vector again afterwards.
+ *
+ * @param elements slot array of a pointer vector
+ * @param values byte buffer of a typed vector
+ * @param size number of elements currently stored
+ * @param capacity number of elements the buffer can hold
+ * @param elem_size size of one inline value, 0 for pointer vectors
+ * @param growth_factor factor the capacity is multiplied by when full
+ * @param key_type primitive type of the values, used to accelerate searches
+ * @param is_sorted whether the elements are in ascending order
+ * @param fixed_storage whether the buffer belongs to someone else and must
+ * not be reallocated or freed, as in the view of a mapped vector
+ * @param custom_free function that releases an element (may be NULL for typed
+ * vectors)
+ * @param compare_func function used to compare elements
+ */
 typedef struct vector
 {
-    void ** elements;
-    int     size;
-    int     capacity;
-    FREE_F  custom_free;
-    CMP_F   compare_func;
+    union
+    {
+        void **         elements;
+        unsigned char * values;
+    };
+    int          size;
+    int          capacity;
+    size_t       elem_size;
+    double       growth_factor;
+    vector_key_t key_type;
+    bool         is_sorted;
+    bool         fixed_storage;
+    FREE_F       custom_free;
+    CMP_F        compare_func;
 } vector_t;
 
 /**
@@ -45,13 +101,79 @@ vector_t * vector_new(FREE_F custom_free,
                       int    initial_capacity);
 
 /**
- * @brief Appends a data element to the end of the vector.
+ * @brief Initializes a new typed vector that stores values of `elem_size`
+ * bytes contiguously instead of pointers to them.
+ * @param elem_size Size in bytes of one element.
+ * @param custom_free Function called with the address of each value that is
+ * removed, to release resources the value owns. It must not free the address
+ * itself. May be NULL for plain values.
+ * @param compare_func Function pointer to a comparison function, called with
+ * the addresses of the values being compared.
+ * @param initial_capacity Initial capacity of the vector.
+ * @return A pointer to the newly created vector.
+ */
+vector_t * vector_new_typed(size_t elem_size,
+                            FREE_F custom_free,
+                            CMP_F  compare_func,
+                            int    initial_capacity);
+
+/**
+ * @brief Appends a data element to the end of the vector in amortized O(1).
  * @param vector Pointer to the vector.
  * @param data Pointer to the data to append.
  * @return Status code indicating success or failure.
  */
 int vector_append(vector_t * vector, void * data);
 
+/**
+ * @brief Appends several elements to the end of the vector with at most one
+ * reallocation.
+ * @param vector Pointer to the vector.
+ * @param data Array of `count` pointers for a pointer vector, or `count`
+ * packed values for a typed vector. It must not point into the vector's own
+ * storage, which a reallocation would free; use vector_append_vector() to
+ * append a vector to itself.
+ * @param count Number of elements to append.
+ * @return Status code indicating success or failure.
+ */
+int vector_append_many(vector_t * vector, void * data, int count);
+
+/**
+ * @brief Appends every element of another vector to the end of the vector.
+ * The source vector is left unchanged, so for pointer vectors both vectors
+ * reference the same data afterwards and only one of them should free it.
+ * @param vector Pointer to the destination vector.
+ * @param source Pointer to the vector to copy elements from. It must have the
+ * same element size as the destination, and may be the destination itself.
+ * @return Status code indicating success or failure.
+ */
+int vector_append_vector(vector_t * vector, vector_t * source);
+
+/**
+ * @brief Ensures the vector can hold at least `capacity` elements without
+ * reallocating.
+ * @param vector Pointer to the vector.
+ * @param capacity Minimum capacity required.
+ * @return Status code indicating success or failure.
+ */
+int vector_reserve(vector_t * vector, int capacity);
+
+/**
+ * @brief Reduces the capacity of the vector to its current size.
+ * @param vector Pointer to the vector.
+ * @return Status code indicating success or failure.
+ */
+int vector_shrink_to_fit(vector_t * vector);
+
+/**
+ * @brief Sets the factor the capacity is multiplied by when the vector is
+ * full.
+ * @param vector Pointer to the vector.
+ * @param growth_factor New growth factor, must be greater than 1.0.
+ * @return Status code indicating success or failure.
+ */
+int vector_set_growth_factor(vector_t * vector, double growth_factor);
+
 /**
  * @brief Inserts a data element at a specific index in the vector.
  * @param vector Pointer to the vector.
@@ -71,7 +193,8 @@ bool vector_is_empty(vector_t * vector);
 /**
  * @brief Removes and returns the last element from the vector.
  * @param vector Pointer to the vector.
- * @return Pointer to the popped element.
+ * @return Pointer to the popped element. For a typed vector this is the
+ * address of the popped value, valid until the next insertion.
  */
 void * vector_pop(vector_t * vector);
 
@@ -83,6 +206,45 @@ void * vector_pop(vector_t * vector);
  */
 int vector_remove(vector_t * vector, int index);
 
+/**
+ * @brief Removes every element the predicate returns true for, in a single
+ * pass that keeps the remaining elements in order.
+ * @param vector Pointer to the vector.
+ * @param predicate Function called with each element and the context.
+ * @param context Caller data passed to the predicate, may be NULL.
+ * @return Number of elements removed, or -1 on failure.
+ */
+int vector_remove_if(vector_t * vector, PRED_F predicate, void * context);
+
+/**
+ * @brief Keeps only the elements the predicate returns true for, in a single
+ * pass that keeps them in order.
+ * @param vector Pointer to the vector.
+ * @param predicate Function called with each element and the context.
+ * @param context Caller data passed to the predicate, may be NULL.
+ * @return Number of elements removed, or -1 on failure.
+ */
+int vector_retain(vector_t * vector, PRED_F predicate, void * context);
+
+/**
+ * @brief Removes the elements in the range [first, last) with a single shift
+ * of the elements after it.
+ * @param vector Pointer to the vector.
+ * @param first Index of the first element to remove.
+ * @param last Index one past the last element to remove.
+ * @return Number of elements removed, or -1 on failure.
+ */
+int vector_remove_range(vector_t * vector, int first, int last);
+
+/**
+ * @brief Removes elements that compare equal to the element before them,
+ * keeping the first of each run. On a sorted vector this leaves each value
+ * exactly once.
+ * @param vector Pointer to the vector.
+ * @return Number of elements removed, or -1 on failure.
+ */
+int vector_dedup_sorted(vector_t * vector);
+
 /**
  * @brief Retrieves an element at a specific index from the vector.
  * @param vector Pointer to the vector.
@@ -135,17 +297,113 @@ void * vector_find_first_occurrence(vector_t * vector, void ** search_data);
  * @brief Finds all occurrences of a specific element in the vector.
  * @param vector Pointer to the vector.
  * @param search_data Pointer to the data to search for.
- * @return A new vector containing all occurrences, or NULL if not found.
+ * @return A new vector containing all occurrences, or NULL if not found. For a
+ * typed vector the result holds copies of the matching values and has no
+ * custom free function.
  */
 vector_t * vector_find_all_occurrences(vector_t * vector, void ** search_data);
 
 /**
- * @brief Sorts the elements in the vector.
+ * @brief Declares the primitive type of a typed vector's values, so that the
+ * find functions use SIMD equality kernels. Values are then matched with `==`
+ * on the key type rather than with compare_func.
+ * @param vector Pointer to a typed vector whose element size matches the key
+ * type.
+ * @param key_type Key type of the values, or VECTOR_KEY_NONE to go back to
+ * compare_func.
+ * @return Status code indicating success or failure.
+ */
+int vector_set_key_type(vector_t * vector, vector_key_t key_type);
+
+/**
+ * @brief Finds the index of the first element equal to the search data.
+ * @param vector Pointer to the vector.
+ * @param search_data Pointer to the data to search for.
+ * @return Index of the first occurrence, or -1 if not found.
+ */
+int vector_find_index(vector_t * vector, void * search_data);
+
+/**
+ * @brief Finds the indices of every element equal to the search data.
+ * @param vector Pointer to the vector.
+ * @param search_data Pointer to the data to search for.
+ * @param count Receives the number of indices returned.
+ * @return A newly allocated array of indices in ascending order, to be
+ * released with free(), or NULL if there are no occurrences.
+ */
+int * vector_find_all_indices(vector_t * vector,
+                              void *     search_data,
+                              int *      count);
+
+/**
+ * @brief Sorts the elements in the vector in ascending order, as defined by
+ * the vector's compare function returning LESS_THAN. The sort is not stable.
  * @param vector Pointer to the vector.
  * @return Status code indicating success or failure.
  */
 int vector_sort(vector_t * vector);
 
+/**
+ * @brief Sorts the elements in the vector like vector_sort(), spreading the
+ * work over several threads. Vectors too small to benefit are sorted on the
+ * calling thread.
+ * @param vector Pointer to the vector.
+ * @param nthreads Number of threads to use, or 0 for one per online CPU.
+ * @return Status code indicating success or failure.
+ */
+int vector_sort_parallel(vector_t * vector, int nthreads);
+
+/**
+ * @brief Reports whether the vector is known to be in ascending order.
+ * @param vector Pointer to the vector.
+ * @return True if the vector is sorted, false otherwise.
+ */
+bool vector_is_sorted(vector_t * vector);
+
+/**
+ * @brief Finds the first element of a sorted vector that does not compare
+ * less than the search data.
+ * @param vector Pointer to a sorted vector.
+ * @param search_data Pointer to the data to search for.
+ * @return Index of the element, the vector size if every element is less, or
+ * -1 on failure or if the vector is not sorted.
+ */
+int vector_lower_bound(vector_t * vector, void * search_data);
+
+/**
+ * @brief Finds the first element of a sorted vector that compares greater than
+ * the search data.
+ * @param vector Pointer to a sorted vector.
+ * @param search_data Pointer to the data to search for.
+ * @return Index of the element, the vector size if no element is greater, or
+ * -1 on failure or if the vector is not sorted.
+ */
+int vector_upper_bound(vector_t * vector, void * search_data);
+
+/**
+ * @brief Finds the range of elements of a sorted vector that compare equal to
+ * the search data.
+ * @param vector Pointer to a sorted vector.
+ * @param search_data Pointer to the data to search for.
+ * @param first Receives the index of the first equal element.
+ * @param last Receives the index one past the last equal element. The range
+ * is empty when it equals first.
+ * @return Status code indicating success or failure.
+ */
+int vector_equal_range(vector_t * vector,
+                       void *     search_data,
+                       int *      first,
+                       int *      last);
+
+/**
+ * @brief Inserts a data element into a sorted vector at the position that
+ * keeps it sorted, after any elements that compare equal to it.
+ * @param vector Pointer to a sorted vector.
+ * @param data Pointer to the data to insert.
+ * @return Status code indicating success or failure.
+ */
+int vector_insert_sorted(vector_t * vector, void * data);
+
 /**
  * @brief Clears all elements from the vector.
  * @param vector Pointer to the vector.
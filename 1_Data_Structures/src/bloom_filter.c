@@ -0,0 +1,546 @@
+#include <math.h>   // ceil(), exp(), log(), pow(), sqrt()
+#include <string.h> // memcpy(), memset()
+
+#include "bloom_filter.h"
+#include "utilities.h"
+
+#define BLOOM_HEADER_BYTES 24 // Magic, hash count, block count, key count
+#define BLOOM_BATCH        8  // Keys hashed and prefetched ahead
+#define BLOOM_BIT_INDEXES  7  // 9-bit positions taken from one 64-bit hash
+#define BLOOM_LN2          0.69314718055994530942
+
+/**
+ * @brief Mixes a key's hash and splits it into the block it maps to and the
+ * hash the bit positions inside the block are cut from.
+ *
+ * @param filter Pointer to the filter.
+ * @param hash Hash of the key.
+ * @param bits Receives the hash the bit positions come from.
+ * @return Pointer to the first word of the block.
+ */
+static uint64_t * bloom_locate(bloom_filter_t * filter,
+                               uint64_t         hash,
+                               uint64_t *       bits);
+
+/**
+ * @brief Sets a key's bits in its block.
+ *
+ * @param filter Pointer to the filter.
+ * @param block Pointer to the block.
+ * @param bits Hash the bit positions come from.
+ */
+static void bloom_set(bloom_filter_t * filter, uint64_t * block, uint64_t bits);
+
+/**
+ * @brief Tests whether all of a key's bits are set in its block.
+ *
+ * @param filter Pointer to the filter.
+ * @param block Pointer to the block.
+ * @param bits Hash the bit positions come from.
+ * @return true if every bit is set.
+ */
+static bool bloom_test(bloom_filter_t * filter,
+                       const uint64_t * block,
+                       uint64_t         bits);
+
+/**
+ * @brief Returns the expected false positive rate of a blocked filter. The
+ * number of keys in a block follows a Poisson distribution, and a block
+ * holding i keys behaves like a classic 512-bit filter with i keys.
+ *
+ * @param keys_per_block Mean number of keys per block.
+ * @param hash_count Number of bits set per key.
+ * @return Expected false positive rate.
+ */
+static double bloom_expected_fpr(double keys_per_block, uint32_t hash_count);
+
+/**
+ * @brief Allocates a filter with zeroed blocks.
+ *
+ * @param hash_func Function hashing keys.
+ * @param block_count Number of blocks.
+ * @param hash_count Number of bits set per key.
+ * @return Pointer to the new filter, or NULL on failure.
+ */
+static bloom_filter_t * bloom_alloc(HASH_F   hash_func,
+                                    uint64_t block_count,
+                                    uint32_t hash_count);
+
+bloom_filter_t * bloom_filter_new(HASH_F   hash_func,
+                                  uint64_t expected_items,
+                                  double   false_positive_rate)
+{
+    bloom_filter_t * new_filter  = NULL;
+    double           bits        = 0;
+    double           best_fpr    = 0;
+    uint64_t         block_count = 0;
+    uint32_t         best_hashes = 0;
+
+    if (NULL == hash_func)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if ((0 == expected_items) || !(0 < false_positive_rate)
+        || !(1 > false_positive_rate))
+    {
+        print_error("Invalid argument passed.");
+        goto END;
+    }
+
+    // Start from the bits per key of a classic filter and add bits until
+    // the blocked layout reaches the rate with its best hash count
+    bits = -log(false_positive_rate) / (BLOOM_LN2 * BLOOM_LN2);
+    for (;;)
+    {
+        block_count = (uint64_t)ceil(((double)expected_items * bits)
+                                     / BLOOM_BLOCK_BITS);
+        best_fpr    = 1;
+        for (uint32_t hashes = 1; hashes <= BLOOM_MAX_HASHES; hashes++)
+        {
+            double fpr = bloom_expected_fpr(
+                (double)expected_items / (double)block_count, hashes);
+
+            if (fpr < best_fpr)
+            {
+                best_fpr    = fpr;
+                best_hashes = hashes;
+            }
+        }
+
+        if (best_fpr <= false_positive_rate)
+        {
+            break;
+        }
+
+        // Once a key has a block to itself more bits stop helping
+        if (bits > (double)BLOOM_BLOCK_BITS)
+        {
+            print_error("False positive rate too low.");
+            goto END;
+        }
+        bits *= 1.02;
+    }
+
+    new_filter = bloom_alloc(hash_func, block_count, best_hashes);
+
+END:
+    return new_filter;
+}
+
+int bloom_filter_insert(bloom_filter_t * filter, void * key)
+{
+    int        exit_code = E_FAILURE;
+    uint64_t * block     = NULL;
+    uint64_t   bits      = 0;
+
+    if ((NULL == filter) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    block = bloom_locate(filter, filter->hash_func(key), &bits);
+    bloom_set(filter, block, bits);
+    filter->count++;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+bool bloom_filter_contains(bloom_filter_t * filter, void * key)
+{
+    bool       found = false;
+    uint64_t * block = NULL;
+    uint64_t   bits  = 0;
+
+    if ((NULL == filter) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    block = bloom_locate(filter, filter->hash_func(key), &bits);
+    found = bloom_test(filter, block, bits);
+
+END:
+    return found;
+}
+
+int bloom_filter_insert_batch(bloom_filter_t * filter,
+                              void **          keys,
+                              uint32_t         count)
+{
+    int        exit_code = E_FAILURE;
+    uint64_t * blocks[BLOOM_BATCH];
+    uint64_t   bits[BLOOM_BATCH];
+
+    if ((NULL == filter) || (NULL == keys))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (uint32_t start = 0; start < count; start += BLOOM_BATCH)
+    {
+        uint32_t batch = count - start;
+
+        if (BLOOM_BATCH < batch)
+        {
+            batch = BLOOM_BATCH;
+        }
+
+        for (uint32_t idx = 0; idx < batch; idx++)
+        {
+            if (NULL == keys[start + idx])
+            {
+                print_error("NULL argument passed.");
+                goto END;
+            }
+            blocks[idx] = bloom_locate(
+                filter, filter->hash_func(keys[start + idx]), &bits[idx]);
+            __builtin_prefetch(blocks[idx], 1);
+        }
+
+        for (uint32_t idx = 0; idx < batch; idx++)
+        {
+            bloom_set(filter, blocks[idx], bits[idx]);
+            filter->count++;
+        }
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int bloom_filter_contains_batch(bloom_filter_t * filter,
+                                void **          keys,
+                                uint32_t         count,
+                                bool *           results)
+{
+    int        exit_code = E_FAILURE;
+    uint64_t * blocks[BLOOM_BATCH];
+    uint64_t   bits[BLOOM_BATCH];
+
+    if ((NULL == filter) || (NULL == keys) || (NULL == results))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (uint32_t start = 0; start < count; start += BLOOM_BATCH)
+    {
+        uint32_t batch = count - start;
+
+        if (BLOOM_BATCH < batch)
+        {
+            batch = BLOOM_BATCH;
+        }
+
+        for (uint32_t idx = 0; idx < batch; idx++)
+        {
+            if (NULL == keys[start + idx])
+            {
+                print_error("NULL argument passed.");
+                goto END;
+            }
+            blocks[idx] = bloom_locate(
+                filter, filter->hash_func(keys[start + idx]), &bits[idx]);
+            __builtin_prefetch(blocks[idx], 0);
+        }
+
+        for (uint32_t idx = 0; idx < batch; idx++)
+        {
+            results[start + idx] = bloom_test(filter, blocks[idx], bits[idx]);
+        }
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+double bloom_filter_estimate_fpr(bloom_filter_t * filter)
+{
+    double fpr = -1;
+
+    if (NULL == filter)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    fpr = bloom_expected_fpr((double)filter->count
+                                 / (double)filter->block_count,
+                             filter->hash_count);
+
+END:
+    return fpr;
+}
+
+size_t bloom_filter_serialized_size(bloom_filter_t * filter)
+{
+    size_t size = 0;
+
+    if (NULL == filter)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    size = BLOOM_HEADER_BYTES + (filter->block_count * BLOOM_BLOCK_BYTES);
+
+END:
+    return size;
+}
+
+int bloom_filter_serialize(bloom_filter_t * filter, void * buffer, size_t size)
+{
+    int       exit_code = E_FAILURE;
+    uint8_t * bytes     = buffer;
+    uint32_t  magic     = BLOOM_FILTER_MAGIC;
+
+    if ((NULL == filter) || (NULL == buffer))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (bloom_filter_serialized_size(filter) > size)
+    {
+        print_error("Buffer too small.");
+        goto END;
+    }
+
+    memcpy(bytes, &magic, sizeof(magic));
+    memcpy(bytes + 4, &filter->hash_count, sizeof(filter->hash_count));
+    memcpy(bytes + 8, &filter->block_count, sizeof(filter->block_count));
+    memcpy(bytes + 16, &filter->count, sizeof(filter->count));
+    memcpy(bytes + BLOOM_HEADER_BYTES,
+           filter->blocks,
+           filter->block_count * BLOOM_BLOCK_BYTES);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+bloom_filter_t * bloom_filter_deserialize(HASH_F       hash_func,
+                                          const void * buffer,
+                                          size_t       size)
+{
+    bloom_filter_t * new_filter  = NULL;
+    const uint8_t *  bytes       = buffer;
+    uint32_t         magic       = 0;
+    uint32_t         hash_count  = 0;
+    uint64_t         block_count = 0;
+
+    if ((NULL == hash_func) || (NULL == buffer))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (BLOOM_HEADER_BYTES > size)
+    {
+        print_error("Invalid filter data.");
+        goto END;
+    }
+
+    memcpy(&magic, bytes, sizeof(magic));
+    memcpy(&hash_count, bytes + 4, sizeof(hash_count));
+    memcpy(&block_count, bytes + 8, sizeof(block_count));
+    if ((BLOOM_FILTER_MAGIC != magic) || (0 == hash_count)
+        || (BLOOM_MAX_HASHES < hash_count) || (0 == block_count)
+        || (((size - BLOOM_HEADER_BYTES) / BLOOM_BLOCK_BYTES) < block_count))
+    {
+        print_error("Invalid filter data.");
+        goto END;
+    }
+
+    new_filter = bloom_alloc(hash_func, block_count, hash_count);
+    if (NULL == new_filter)
+    {
+        goto END;
+    }
+
+    memcpy(&new_filter->count, bytes + 16, sizeof(new_filter->count));
+    memcpy(new_filter->blocks,
+           bytes + BLOOM_HEADER_BYTES,
+           block_count * BLOOM_BLOCK_BYTES);
+
+END:
+    return new_filter;
+}
+
+int bloom_filter_clear(bloom_filter_t * filter)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == filter)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    memset(filter->blocks, 0, filter->block_count * BLOOM_BLOCK_BYTES);
+    filter->count = 0;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int bloom_filter_delete(bloom_filter_t ** filter_address)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == filter_address) || (NULL == *filter_address))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    free((*filter_address)->blocks);
+    free(*filter_address);
+    *filter_address = NULL;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static uint64_t * bloom_locate(bloom_filter_t * filter,
+                               uint64_t         hash,
+                               uint64_t *       bits)
+{
+    uint64_t block = 0;
+
+    // The block comes from the top bits, which a hash function filling only
+    // the low 32 bits leaves zero, so the hash is mixed first
+    hash = hash_u64(hash);
+
+    // Multiply-shift maps the hash onto the blocks without a division; the
+    // bits inside the block come from a second remix so they do not follow it
+    block = (uint64_t)(((__uint128_t)hash * filter->block_count) >> 64);
+
+    *bits = hash_u64(hash);
+    return &filter->blocks[block * BLOOM_BLOCK_WORDS];
+}
+
+static void bloom_set(bloom_filter_t * filter, uint64_t * block, uint64_t bits)
+{
+    uint64_t word = bits;
+
+    for (uint32_t idx = 0; idx < filter->hash_count; idx++)
+    {
+        uint32_t bit = 0;
+
+        // Each position is its own 9 bits of hash; deriving them all from
+        // two values makes keys in a block share positions far too often
+        if ((0 != idx) && (0 == (idx % BLOOM_BIT_INDEXES)))
+        {
+            bits = hash_u64(bits);
+            word = bits;
+        }
+        bit = (uint32_t)(word % BLOOM_BLOCK_BITS);
+        word /= BLOOM_BLOCK_BITS;
+
+        block[bit / 64] |= (uint64_t)1 << (bit % 64);
+    }
+}
+
+static bool bloom_test(bloom_filter_t * filter,
+                       const uint64_t * block,
+                       uint64_t         bits)
+{
+    bool     found = true;
+    uint64_t word  = bits;
+
+    for (uint32_t idx = 0; idx < filter->hash_count; idx++)
+    {
+        uint32_t bit = 0;
+
+        if ((0 != idx) && (0 == (idx % BLOOM_BIT_INDEXES)))
+        {
+            bits = hash_u64(bits);
+            word = bits;
+        }
+        bit = (uint32_t)(word % BLOOM_BLOCK_BITS);
+        word /= BLOOM_BLOCK_BITS;
+
+        if (0 == (block[bit / 64] & ((uint64_t)1 << (bit % 64))))
+        {
+            found = false;
+            break;
+        }
+    }
+
+    return found;
+}
+
+static double bloom_expected_fpr(double keys_per_block, uint32_t hash_count)
+{
+    double fpr         = 0;
+    double probability = exp(-keys_per_block);
+    double limit = keys_per_block + (10 * sqrt(keys_per_block + 1)) + 10;
+
+    for (uint32_t keys = 0; keys < (uint32_t)limit; keys++)
+    {
+        double bit_set = 1 - pow(1 - (1.0 / BLOOM_BLOCK_BITS),
+                                 (double)(hash_count * keys));
+
+        fpr += probability * pow(bit_set, hash_count);
+        probability *= keys_per_block / (keys + 1);
+    }
+
+    return fpr;
+}
+
+static bloom_filter_t * bloom_alloc(HASH_F   hash_func,
+                                    uint64_t block_count,
+                                    uint32_t hash_count)
+{
+    bloom_filter_t * new_filter = NULL;
+
+    if ((SIZE_MAX / BLOOM_BLOCK_BYTES) < block_count)
+    {
+        print_error("Invalid filter size.");
+        goto END;
+    }
+
+    new_filter = calloc(1, sizeof(bloom_filter_t));
+    if (NULL == new_filter)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    new_filter->blocks
+        = aligned_alloc(BLOOM_BLOCK_BYTES, block_count * BLOOM_BLOCK_BYTES);
+    if (NULL == new_filter->blocks)
+    {
+        print_error("CMR failure.");
+        free(new_filter);
+        new_filter = NULL;
+        goto END;
+    }
+
+    memset(new_filter->blocks, 0, block_count * BLOOM_BLOCK_BYTES);
+    new_filter->block_count = block_count;
+    new_filter->hash_count  = hash_count;
+    new_filter->count       = 0;
+    new_filter->hash_func   = hash_func;
+
+END:
+    return new_filter;
+}
+
+/*** end of file ***/
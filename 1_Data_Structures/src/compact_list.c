@@ -0,0 +1,985 @@
+#include "compact_list.h"
+#include "sorts.h"
+#include "utilities.h"
+
+/**
+ * @brief Checks that an index names a node currently in the list.
+ *
+ * @param list Pointer to the list.
+ * @param node Index to check.
+ * @return true if the node is in the list.
+ */
+static bool clist_is_node(clist_t * list, uint32_t node);
+
+/**
+ * @brief Takes a node off the free chain, or the next never used node,
+ * growing the array when it is full.
+ *
+ * @param list Pointer to the list.
+ * @param data Data to store in the node.
+ * @return Index of the unlinked node, or CLIST_NIL on failure.
+ */
+static uint32_t clist_node_new(clist_t * list, void * data);
+
+/**
+ * @brief Links a node between two neighbours, either of which may be
+ * CLIST_NIL at the ends of the list.
+ *
+ * @param list Pointer to the list.
+ * @param prev Index of the node that will come before it.
+ * @param next Index of the node that will come after it.
+ * @param node Index of the node to link.
+ */
+static void clist_link(clist_t * list,
+                       uint32_t  prev,
+                       uint32_t  next,
+                       uint32_t  node);
+
+/**
+ * @brief Unlinks a node and puts it on the free chain.
+ *
+ * @param list Pointer to the list.
+ * @param node Index of the node to unlink.
+ * @return The node's data.
+ */
+static void * clist_unlink(clist_t * list, uint32_t node);
+
+/**
+ * @brief Creates a node for data and links it between two neighbours.
+ *
+ * @param list Pointer to the list.
+ * @param prev Index of the node that will come before it.
+ * @param next Index of the node that will come after it.
+ * @param data Data to store.
+ * @return Index of the new node, or CLIST_NIL on failure.
+ */
+static uint32_t clist_insert_between(clist_t * list,
+                                     uint32_t  prev,
+                                     uint32_t  next,
+                                     void *    data);
+
+/**
+ * @brief Finds the node at a position, walking from whichever end of the
+ * list is nearer.
+ *
+ * @param list Pointer to the list.
+ * @param position Position of the node, less than the list size.
+ * @return Index of the node.
+ */
+static uint32_t clist_locate(clist_t * list, uint32_t position);
+
+/**
+ * @brief Copies the list's data into an array in list order.
+ *
+ * @param list Pointer to the list.
+ * @return Pointer to an array of `size` data pointers, or NULL on failure.
+ */
+static void ** clist_gather(clist_t * list);
+
+/**
+ * @brief Rewrites the list as nodes 0 to size - 1 in order, holding the
+ * given data, and empties the free chain.
+ *
+ * @param list Pointer to the list.
+ * @param data_array Data for each position, `size` of them.
+ */
+static void clist_rebuild(clist_t * list, void ** data_array);
+
+clist_t * clist_new(FREE_F free_func, CMP_F comp_func, uint32_t capacity)
+{
+    clist_t * new_list = NULL;
+
+    if ((NULL == free_func) || (NULL == comp_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    new_list = calloc(1, sizeof(clist_t));
+    if (NULL == new_list)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    new_list->nodes        = NULL;
+    new_list->capacity     = 0;
+    new_list->used         = 0;
+    new_list->size         = 0;
+    new_list->head         = CLIST_NIL;
+    new_list->tail         = CLIST_NIL;
+    new_list->free_head    = CLIST_NIL;
+    new_list->custom_free  = free_func;
+    new_list->compare_func = comp_func;
+
+    if ((0 < capacity) && (E_SUCCESS != clist_reserve(new_list, capacity)))
+    {
+        free(new_list);
+        new_list = NULL;
+    }
+
+END:
+    return new_list;
+}
+
+int clist_reserve(clist_t * list, uint32_t capacity)
+{
+    int            exit_code = E_FAILURE;
+    clist_node_t * new_nodes = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (CLIST_MAX_CAPACITY < capacity)
+    {
+        print_error("Invalid capacity.");
+        goto END;
+    }
+
+    if (capacity <= list->capacity)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    // Links are indices, so the nodes stay valid wherever realloc puts them
+    new_nodes = realloc(list->nodes, (size_t)capacity * sizeof(clist_node_t));
+    if (NULL == new_nodes)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    list->nodes    = new_nodes;
+    list->capacity = capacity;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int clist_push_head(clist_t * list, void * data)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (CLIST_NIL != clist_insert_between(list, CLIST_NIL, list->head, data))
+    {
+        exit_code = E_SUCCESS;
+    }
+
+END:
+    return exit_code;
+}
+
+int clist_push_tail(clist_t * list, void * data)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (CLIST_NIL != clist_insert_between(list, list->tail, CLIST_NIL, data))
+    {
+        exit_code = E_SUCCESS;
+    }
+
+END:
+    return exit_code;
+}
+
+int clist_push_position(clist_t * list, void * data, uint32_t position)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (position > list->size)
+    {
+        print_error("Position out of bounds.");
+        goto END;
+    }
+
+    if (position == list->size)
+    {
+        exit_code = clist_push_tail(list, data);
+        goto END;
+    }
+
+    if (CLIST_NIL
+        != clist_insert_before(list, clist_locate(list, position), data))
+    {
+        exit_code = E_SUCCESS;
+    }
+
+END:
+    return exit_code;
+}
+
+uint32_t clist_insert_after(clist_t * list, uint32_t node, void * data)
+{
+    uint32_t new_node = CLIST_NIL;
+
+    if ((NULL == list) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (!clist_is_node(list, node))
+    {
+        print_error("Invalid node.");
+        goto END;
+    }
+
+    new_node = clist_insert_between(list, node, list->nodes[node].next, data);
+
+END:
+    return new_node;
+}
+
+uint32_t clist_insert_before(clist_t * list, uint32_t node, void * data)
+{
+    uint32_t new_node = CLIST_NIL;
+
+    if ((NULL == list) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (!clist_is_node(list, node))
+    {
+        print_error("Invalid node.");
+        goto END;
+    }
+
+    new_node = clist_insert_between(list, list->nodes[node].prev, node, data);
+
+END:
+    return new_node;
+}
+
+int clist_emptycheck(clist_t * list)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 == list->size)
+    {
+        exit_code = E_SUCCESS;
+    }
+
+END:
+    return exit_code;
+}
+
+void * clist_pop_head(clist_t * list)
+{
+    void * data = NULL;
+
+    if ((NULL == list) || (0 == list->size))
+    {
+        print_error("List is empty.");
+        goto END;
+    }
+
+    data = clist_unlink(list, list->head);
+
+END:
+    return data;
+}
+
+void * clist_pop_tail(clist_t * list)
+{
+    void * data = NULL;
+
+    if ((NULL == list) || (0 == list->size))
+    {
+        print_error("List is empty.");
+        goto END;
+    }
+
+    data = clist_unlink(list, list->tail);
+
+END:
+    return data;
+}
+
+void * clist_pop_position(clist_t * list, uint32_t position)
+{
+    void * data = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (position >= list->size)
+    {
+        print_error("Position out of bounds.");
+        goto END;
+    }
+
+    data = clist_unlink(list, clist_locate(list, position));
+
+END:
+    return data;
+}
+
+void * clist_pop_node(clist_t * list, uint32_t node)
+{
+    void * data = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (!clist_is_node(list, node))
+    {
+        print_error("Invalid node.");
+        goto END;
+    }
+
+    data = clist_unlink(list, node);
+
+END:
+    return data;
+}
+
+int clist_remove_head(clist_t * list)
+{
+    int    exit_code = E_FAILURE;
+    void * data      = clist_pop_head(list);
+
+    if (NULL != data)
+    {
+        list->custom_free(data);
+        exit_code = E_SUCCESS;
+    }
+
+    return exit_code;
+}
+
+int clist_remove_tail(clist_t * list)
+{
+    int    exit_code = E_FAILURE;
+    void * data      = clist_pop_tail(list);
+
+    if (NULL != data)
+    {
+        list->custom_free(data);
+        exit_code = E_SUCCESS;
+    }
+
+    return exit_code;
+}
+
+int clist_remove_position(clist_t * list, uint32_t position)
+{
+    int    exit_code = E_FAILURE;
+    void * data      = clist_pop_position(list, position);
+
+    if (NULL != data)
+    {
+        list->custom_free(data);
+        exit_code = E_SUCCESS;
+    }
+
+    return exit_code;
+}
+
+int clist_remove_node(clist_t * list, uint32_t node)
+{
+    int    exit_code = E_FAILURE;
+    void * data      = clist_pop_node(list, node);
+
+    if (NULL != data)
+    {
+        list->custom_free(data);
+        exit_code = E_SUCCESS;
+    }
+
+    return exit_code;
+}
+
+uint32_t clist_head(clist_t * list)
+{
+    uint32_t node = CLIST_NIL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    node = list->head;
+
+END:
+    return node;
+}
+
+uint32_t clist_tail(clist_t * list)
+{
+    uint32_t node = CLIST_NIL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    node = list->tail;
+
+END:
+    return node;
+}
+
+uint32_t clist_next(clist_t * list, uint32_t node)
+{
+    uint32_t next = CLIST_NIL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (!clist_is_node(list, node))
+    {
+        print_error("Invalid node.");
+        goto END;
+    }
+
+    next = list->nodes[node].next;
+
+END:
+    return next;
+}
+
+uint32_t clist_prev(clist_t * list, uint32_t node)
+{
+    uint32_t prev = CLIST_NIL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (!clist_is_node(list, node))
+    {
+        print_error("Invalid node.");
+        goto END;
+    }
+
+    prev = list->nodes[node].prev;
+
+END:
+    return prev;
+}
+
+void * clist_get(clist_t * list, uint32_t node)
+{
+    void * data = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (!clist_is_node(list, node))
+    {
+        print_error("Invalid node.");
+        goto END;
+    }
+
+    data = list->nodes[node].data;
+
+END:
+    return data;
+}
+
+void * clist_peek_head(clist_t * list)
+{
+    void * data = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 < list->size)
+    {
+        data = list->nodes[list->head].data;
+    }
+
+END:
+    return data;
+}
+
+void * clist_peek_tail(clist_t * list)
+{
+    void * data = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 < list->size)
+    {
+        data = list->nodes[list->tail].data;
+    }
+
+END:
+    return data;
+}
+
+void * clist_peek_position(clist_t * list, uint32_t position)
+{
+    void * data = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (position >= list->size)
+    {
+        print_error("Position out of bounds.");
+        goto END;
+    }
+
+    data = list->nodes[clist_locate(list, position)].data;
+
+END:
+    return data;
+}
+
+int clist_remove_data(clist_t * list, void * item_to_remove)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list) || (NULL == item_to_remove))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (uint32_t node = list->head; CLIST_NIL != node;
+         node = list->nodes[node].next)
+    {
+        if (EQUAL == list->compare_func(item_to_remove, list->nodes[node].data))
+        {
+            list->custom_free(clist_unlink(list, node));
+            exit_code = E_SUCCESS;
+            goto END;
+        }
+    }
+
+    print_error("Item not found.");
+END:
+    return exit_code;
+}
+
+int clist_foreach_call(clist_t * list, ACT_F action_function)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list) || (NULL == action_function))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (uint32_t node = list->head; CLIST_NIL != node;
+         node = list->nodes[node].next)
+    {
+        action_function(list->nodes[node].data);
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * clist_find_first_occurrence(clist_t * list, void * search_data)
+{
+    void * found_data = NULL;
+
+    if ((NULL == list) || (NULL == search_data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (uint32_t node = list->head; CLIST_NIL != node;
+         node = list->nodes[node].next)
+    {
+        if (EQUAL == list->compare_func(search_data, list->nodes[node].data))
+        {
+            found_data = list->nodes[node].data;
+            break;
+        }
+    }
+
+END:
+    return found_data;
+}
+
+int clist_sort(clist_t * list)
+{
+    int     exit_code  = E_FAILURE;
+    void ** data_array = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (2 > list->size)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    data_array = clist_gather(list);
+    if (NULL == data_array)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    exit_code = sort_merge_ptrs(data_array, list->size, list->compare_func);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to sort list data.");
+        goto END;
+    }
+
+    clist_rebuild(list, data_array);
+
+END:
+    free(data_array);
+    return exit_code;
+}
+
+int clist_compact(clist_t * list)
+{
+    int            exit_code  = E_FAILURE;
+    void **        data_array = NULL;
+    clist_node_t * new_nodes  = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 < list->size)
+    {
+        data_array = clist_gather(list);
+        if (NULL == data_array)
+        {
+            print_error("CMR failure.");
+            goto END;
+        }
+
+        clist_rebuild(list, data_array);
+
+        // Shrinking cannot fail in a way that loses the nodes, so a failed
+        // realloc just keeps the larger array
+        new_nodes = realloc(list->nodes, list->size * sizeof(clist_node_t));
+        if (NULL != new_nodes)
+        {
+            list->nodes    = new_nodes;
+            list->capacity = list->size;
+        }
+    }
+    else
+    {
+        free(list->nodes);
+        list->nodes     = NULL;
+        list->capacity  = 0;
+        list->used      = 0;
+        list->free_head = CLIST_NIL;
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    free(data_array);
+    return exit_code;
+}
+
+int clist_clear(clist_t * list)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (uint32_t node = list->head; CLIST_NIL != node;
+         node = list->nodes[node].next)
+    {
+        list->custom_free(list->nodes[node].data);
+    }
+
+    list->used      = 0;
+    list->size      = 0;
+    list->head      = CLIST_NIL;
+    list->tail      = CLIST_NIL;
+    list->free_head = CLIST_NIL;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int clist_delete(clist_t ** list_address)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list_address) || (NULL == *list_address))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = clist_clear(*list_address);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to clear list.");
+        goto END;
+    }
+
+    free((*list_address)->nodes);
+    free(*list_address);
+    *list_address = NULL;
+
+END:
+    return exit_code;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static bool clist_is_node(clist_t * list, uint32_t node)
+{
+    return (node < list->used) && (NULL != list->nodes[node].data);
+}
+
+static uint32_t clist_node_new(clist_t * list, void * data)
+{
+    uint32_t node     = list->free_head;
+    uint32_t capacity = 0;
+
+    if (CLIST_NIL != node)
+    {
+        list->free_head = list->nodes[node].next;
+        goto FILL;
+    }
+
+    if (list->used == list->capacity)
+    {
+        if (CLIST_MAX_CAPACITY == list->capacity)
+        {
+            print_error("List is full.");
+            goto END;
+        }
+
+        capacity = (CLIST_MIN_CAPACITY > list->capacity) ? CLIST_MIN_CAPACITY
+                   : (CLIST_MAX_CAPACITY / 2 < list->capacity)
+                       ? CLIST_MAX_CAPACITY
+                       : list->capacity * 2;
+        if (E_SUCCESS != clist_reserve(list, capacity))
+        {
+            goto END;
+        }
+    }
+
+    node = list->used;
+    list->used++;
+
+FILL:
+    list->nodes[node].data = data;
+    list->nodes[node].prev = CLIST_NIL;
+    list->nodes[node].next = CLIST_NIL;
+END:
+    return node;
+}
+
+static void clist_link(clist_t * list,
+                       uint32_t  prev,
+                       uint32_t  next,
+                       uint32_t  node)
+{
+    list->nodes[node].prev = prev;
+    list->nodes[node].next = next;
+
+    if (CLIST_NIL == prev)
+    {
+        list->head = node;
+    }
+    else
+    {
+        list->nodes[prev].next = node;
+    }
+
+    if (CLIST_NIL == next)
+    {
+        list->tail = node;
+    }
+    else
+    {
+        list->nodes[next].prev = node;
+    }
+
+    list->size++;
+}
+
+static void * clist_unlink(clist_t * list, uint32_t node)
+{
+    clist_node_t * entry = &list->nodes[node];
+    void *         data  = entry->data;
+
+    if (CLIST_NIL == entry->prev)
+    {
+        list->head = entry->next;
+    }
+    else
+    {
+        list->nodes[entry->prev].next = entry->next;
+    }
+
+    if (CLIST_NIL == entry->next)
+    {
+        list->tail = entry->prev;
+    }
+    else
+    {
+        list->nodes[entry->next].prev = entry->prev;
+    }
+
+    entry->data     = NULL;
+    entry->prev     = CLIST_NIL;
+    entry->next     = list->free_head;
+    list->free_head = node;
+    list->size--;
+
+    return data;
+}
+
+static uint32_t clist_insert_between(clist_t * list,
+                                     uint32_t  prev,
+                                     uint32_t  next,
+                                     void *    data)
+{
+    uint32_t node = clist_node_new(list, data);
+
+    if (CLIST_NIL == node)
+    {
+        print_error("Unable to create new node.");
+        goto END;
+    }
+
+    clist_link(list, prev, next, node);
+
+END:
+    return node;
+}
+
+static uint32_t clist_locate(clist_t * list, uint32_t position)
+{
+    uint32_t node = CLIST_NIL;
+
+    if (position < list->size / 2)
+    {
+        node = list->head;
+        for (uint32_t idx = 0; idx < position; idx++)
+        {
+            node = list->nodes[node].next;
+        }
+    }
+    else
+    {
+        node = list->tail;
+        for (uint32_t idx = list->size - 1; idx > position; idx--)
+        {
+            node = list->nodes[node].prev;
+        }
+    }
+
+    return node;
+}
+
+static void ** clist_gather(clist_t * list)
+{
+    void ** data_array = NULL;
+    size_t  position   = 0;
+
+    data_array = calloc(list->size, sizeof(void *));
+    if (NULL == data_array)
+    {
+        goto END;
+    }
+
+    for (uint32_t node = list->head; CLIST_NIL != node;
+         node = list->nodes[node].next)
+    {
+        data_array[position] = list->nodes[node].data;
+        position++;
+    }
+
+END:
+    return data_array;
+}
+
+static void clist_rebuild(clist_t * list, void ** data_array)
+{
+    for (uint32_t idx = 0; idx < list->size; idx++)
+    {
+        list->nodes[idx].data = data_array[idx];
+        list->nodes[idx].prev = (0 == idx) ? CLIST_NIL : idx - 1;
+        list->nodes[idx].next = (list->size - 1 == idx) ? CLIST_NIL : idx + 1;
+    }
+
+    list->used      = list->size;
+    list->head      = 0;
+    list->tail      = list->size - 1;
+    list->free_head = CLIST_NIL;
+}
+
+/*** end of file ***/
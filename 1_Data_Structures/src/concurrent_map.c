@@ -0,0 +1,373 @@
+#define _POSIX_C_SOURCE 200809L // pthread_rwlock_t
+
+#include "concurrent_map.h"
+#include "hashing.h"
+#include "utilities.h"
+
+/**
+ * @brief Returns the shard a key's hash falls in, from the top bits of the
+ * remixed hash. Remixing keeps hashes that leave the top bits zero from all
+ * landing in shard 0.
+ *
+ * @param map Pointer to the map.
+ * @param hash The map's hash function applied to the key.
+ * @return Pointer to the shard.
+ */
+static cmap_shard_t * cmap_shard(cmap_t * map, uint64_t hash);
+
+/**
+ * @brief Deletes the tables and destroys the locks of the first `count`
+ * shards, then frees the shard array.
+ *
+ * @param map Pointer to the map.
+ * @param count Number of shards that were set up.
+ */
+static void cmap_destroy_shards(cmap_t * map, uint32_t count);
+
+cmap_t * cmap_new(HASH_F   hash_func,
+                  CMP_F    compare_func,
+                  FREE_F   key_free,
+                  FREE_F   value_free,
+                  uint32_t shard_count)
+{
+    cmap_t * new_map = NULL;
+    uint32_t count   = 1;
+    uint32_t bits    = 0;
+    uint32_t idx     = 0;
+
+    if ((NULL == hash_func) || (NULL == compare_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 == shard_count)
+    {
+        shard_count = CMAP_DEFAULT_SHARDS;
+    }
+
+    if (CMAP_MAX_SHARDS < shard_count)
+    {
+        print_error("Invalid shard count.");
+        goto END;
+    }
+
+    while (count < shard_count)
+    {
+        count *= 2;
+        bits++;
+    }
+
+    new_map = calloc(1, sizeof(cmap_t));
+    if (NULL == new_map)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    new_map->shards
+        = aligned_alloc(CMAP_CACHE_LINE, count * sizeof(cmap_shard_t));
+    if (NULL == new_map->shards)
+    {
+        print_error("CMR failure.");
+        free(new_map);
+        new_map = NULL;
+        goto END;
+    }
+
+    new_map->shard_count = count;
+    new_map->shard_shift = 64 - bits;
+    new_map->hash_func   = hash_func;
+
+    for (idx = 0; idx < count; idx++)
+    {
+        hash_table_init(&new_map->shards[idx].table,
+                        hash_func,
+                        compare_func,
+                        key_free,
+                        value_free);
+
+        if (0 != pthread_rwlock_init(&new_map->shards[idx].lock, NULL))
+        {
+            print_error("Unable to initialize lock.");
+            break;
+        }
+    }
+
+    if (idx < count)
+    {
+        cmap_destroy_shards(new_map, idx);
+        free(new_map);
+        new_map = NULL;
+    }
+
+END:
+    return new_map;
+}
+
+int cmap_insert(cmap_t * map, void * key, void * value)
+{
+    int            exit_code = E_FAILURE;
+    cmap_shard_t * shard     = NULL;
+    uint64_t       hash      = 0;
+
+    if ((NULL == map) || (NULL == key) || (NULL == value))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    hash  = map->hash_func(key);
+    shard = cmap_shard(map, hash);
+    pthread_rwlock_wrlock(&shard->lock);
+    exit_code = hash_table_insert_hashed(&shard->table, key, value, hash);
+    pthread_rwlock_unlock(&shard->lock);
+
+END:
+    return exit_code;
+}
+
+void * cmap_lookup(cmap_t * map, void * key)
+{
+    void *         value = NULL;
+    cmap_shard_t * shard = NULL;
+    uint64_t       hash  = 0;
+
+    if ((NULL == map) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    hash  = map->hash_func(key);
+    shard = cmap_shard(map, hash);
+    pthread_rwlock_rdlock(&shard->lock);
+    value = hash_table_lookup_hashed(&shard->table, key, hash);
+    pthread_rwlock_unlock(&shard->lock);
+
+END:
+    return value;
+}
+
+int cmap_visit(cmap_t *   map,
+               void *     key,
+               PAIR_ACT_F action_function,
+               void *     context)
+{
+    int            exit_code = E_FAILURE;
+    cmap_shard_t * shard     = NULL;
+    uint64_t       hash      = 0;
+    void *         value     = NULL;
+
+    if ((NULL == map) || (NULL == key) || (NULL == action_function))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    hash  = map->hash_func(key);
+    shard = cmap_shard(map, hash);
+    pthread_rwlock_rdlock(&shard->lock);
+    value = hash_table_lookup_hashed(&shard->table, key, hash);
+    if (NULL != value)
+    {
+        action_function(key, value, context);
+        exit_code = E_SUCCESS;
+    }
+
+    pthread_rwlock_unlock(&shard->lock);
+
+END:
+    return exit_code;
+}
+
+bool cmap_contains(cmap_t * map, void * key)
+{
+    return (NULL != cmap_lookup(map, key));
+}
+
+int cmap_extract(cmap_t * map, void * key, void ** stored_key, void ** value)
+{
+    int            exit_code = E_FAILURE;
+    cmap_shard_t * shard     = NULL;
+    uint64_t       hash      = 0;
+
+    if ((NULL == map) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    hash  = map->hash_func(key);
+    shard = cmap_shard(map, hash);
+    pthread_rwlock_wrlock(&shard->lock);
+    exit_code = hash_table_extract_hashed(
+        &shard->table, key, hash, stored_key, value);
+    pthread_rwlock_unlock(&shard->lock);
+
+END:
+    return exit_code;
+}
+
+int cmap_remove(cmap_t * map, void * key)
+{
+    int            exit_code  = E_FAILURE;
+    cmap_shard_t * shard      = NULL;
+    uint64_t       hash       = 0;
+    void *         stored_key = NULL;
+    void *         value      = NULL;
+
+    if ((NULL == map) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    hash  = map->hash_func(key);
+    shard = cmap_shard(map, hash);
+    pthread_rwlock_wrlock(&shard->lock);
+    exit_code = hash_table_extract_hashed(
+        &shard->table, key, hash, &stored_key, &value);
+    pthread_rwlock_unlock(&shard->lock);
+
+    // The entry is out of the map, so it is freed outside the lock
+    if (E_SUCCESS == exit_code)
+    {
+        if (NULL != shard->table.key_free)
+        {
+            shard->table.key_free(stored_key);
+        }
+        if (NULL != shard->table.value_free)
+        {
+            shard->table.value_free(value);
+        }
+    }
+
+END:
+    return exit_code;
+}
+
+int cmap_foreach_call(cmap_t * map, PAIR_ACT_F action_function, void * context)
+{
+    int      exit_code = E_FAILURE;
+    uint32_t idx       = 0;
+
+    if ((NULL == map) || (NULL == action_function))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (idx = 0; idx < map->shard_count; idx++)
+    {
+        pthread_rwlock_rdlock(&map->shards[idx].lock);
+        hash_table_foreach_call(
+            &map->shards[idx].table, action_function, context);
+        pthread_rwlock_unlock(&map->shards[idx].lock);
+    }
+
+    exit_code = E_SUCCESS;
+
+END:
+    return exit_code;
+}
+
+int64_t cmap_size(cmap_t * map)
+{
+    int64_t  size = -1;
+    uint32_t idx  = 0;
+
+    if (NULL == map)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    size = 0;
+    for (idx = 0; idx < map->shard_count; idx++)
+    {
+        pthread_rwlock_rdlock(&map->shards[idx].lock);
+        size += hash_table_size(&map->shards[idx].table);
+        pthread_rwlock_unlock(&map->shards[idx].lock);
+    }
+
+END:
+    return size;
+}
+
+int cmap_clear(cmap_t * map)
+{
+    int      exit_code = E_FAILURE;
+    uint32_t idx       = 0;
+
+    if (NULL == map)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (idx = 0; idx < map->shard_count; idx++)
+    {
+        pthread_rwlock_wrlock(&map->shards[idx].lock);
+        hash_table_clear(&map->shards[idx].table);
+        pthread_rwlock_unlock(&map->shards[idx].lock);
+    }
+
+    exit_code = E_SUCCESS;
+
+END:
+    return exit_code;
+}
+
+int cmap_delete(cmap_t ** map_address)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == map_address) || (NULL == *map_address))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    cmap_destroy_shards(*map_address, (*map_address)->shard_count);
+    free(*map_address);
+    *map_address = NULL;
+
+    exit_code = E_SUCCESS;
+
+END:
+    return exit_code;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static cmap_shard_t * cmap_shard(cmap_t * map, uint64_t hash)
+{
+    uint32_t index = 0;
+
+    // A shift by 64 is undefined, so a single shard skips the remix
+    if (1 < map->shard_count)
+    {
+        index = (uint32_t)(hash_u64(hash) >> map->shard_shift);
+    }
+
+    return &map->shards[index];
+}
+
+static void cmap_destroy_shards(cmap_t * map, uint32_t count)
+{
+    uint32_t idx = 0;
+
+    for (idx = 0; idx < count; idx++)
+    {
+        hash_table_destroy(&map->shards[idx].table);
+        pthread_rwlock_destroy(&map->shards[idx].lock);
+    }
+
+    free(map->shards);
+    map->shards = NULL;
+}
+
+/*** end of file ***/
@@ -0,0 +1,451 @@
+#include "concurrent_vector.h"
+#include "utilities.h"
+
+#define CVECTOR_FIRST_SEGMENT_SIZE (1 << CVECTOR_FIRST_SEGMENT_BITS)
+
+/**
+ * @brief Maps an index to the segment holding it and its offset there.
+ *
+ * Biasing the index by the first segment size makes segment k cover the
+ * biased range [64 << k, 128 << k), so the segment is the position of the
+ * highest set bit.
+ *
+ * @param index Index of the element.
+ * @param offset Receives the offset of the element within its segment.
+ * @return Number of the segment holding the element.
+ */
+static int cvector_locate(int index, int * offset);
+
+/**
+ * @brief Returns the number of slots in a segment.
+ *
+ * @param segment Number of the segment.
+ * @return Number of slots in the segment.
+ */
+static size_t cvector_segment_size(int segment);
+
+/**
+ * @brief Returns a segment, installing it first if no thread has yet. When
+ * two threads race to install the same segment the loser frees its copy.
+ *
+ * @param vector Pointer to the vector.
+ * @param segment Number of the segment.
+ * @return Pointer to the segment's slots, or NULL on allocation failure.
+ */
+static cvector_slot_t * cvector_segment(cvector_t * vector, int segment);
+
+/**
+ * @brief Returns the slot for an index, or NULL if its segment does not exist.
+ *
+ * @param vector Pointer to the vector.
+ * @param index Index of the element.
+ * @return Pointer to the slot.
+ */
+static cvector_slot_t * cvector_slot(cvector_t * vector, int index);
+
+cvector_t * cvector_new(FREE_F free_func, CMP_F comp_func)
+{
+    cvector_t * new_vector = NULL;
+
+    if ((NULL == free_func) || (NULL == comp_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    new_vector = calloc(1, sizeof(cvector_t));
+    if (NULL == new_vector)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    for (int idx = 0; idx < CVECTOR_SEGMENT_COUNT; idx++)
+    {
+        atomic_init(&new_vector->segments[idx], NULL);
+    }
+    atomic_init(&new_vector->size, 0);
+    new_vector->custom_free  = free_func;
+    new_vector->compare_func = comp_func;
+
+    // The first segment is always needed, so it is allocated up front
+    if (NULL == cvector_segment(new_vector, 0))
+    {
+        free(new_vector);
+        new_vector = NULL;
+    }
+
+END:
+    return new_vector;
+}
+
+int cvector_append(cvector_t * vector, void * data)
+{
+    int              index = -1;
+    int              slot  = 0;
+    cvector_slot_t * items = NULL;
+
+    if ((NULL == vector) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // Checked first so the counter cannot run far past the limit
+    if (CVECTOR_MAX_SIZE
+        <= atomic_load_explicit(&vector->size, memory_order_relaxed))
+    {
+        print_error("Vector is full.");
+        goto END;
+    }
+
+    index = atomic_fetch_add_explicit(&vector->size, 1, memory_order_relaxed);
+    if (CVECTOR_MAX_SIZE <= index)
+    {
+        print_error("Vector is full.");
+        index = -1;
+        goto END;
+    }
+
+    items = cvector_segment(vector, cvector_locate(index, &slot));
+    if (NULL == items)
+    {
+        // The index stays reserved and reads as NULL
+        print_error("CMR failure.");
+        index = -1;
+        goto END;
+    }
+
+    // Publish the element, pairing with the acquire loads of readers
+    atomic_store_explicit(&items[slot], data, memory_order_release);
+
+END:
+    return index;
+}
+
+int cvector_reserve(cvector_t * vector, int capacity)
+{
+    int exit_code = E_FAILURE;
+    int slot      = 0;
+    int last      = 0;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if ((0 > capacity) || (CVECTOR_MAX_SIZE < capacity))
+    {
+        print_error("Invalid capacity.");
+        goto END;
+    }
+
+    last = (0 == capacity) ? 0 : cvector_locate(capacity - 1, &slot);
+    for (int segment = 0; segment <= last; segment++)
+    {
+        if (NULL == cvector_segment(vector, segment))
+        {
+            print_error("CMR failure.");
+            goto END;
+        }
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * cvector_get_element(cvector_t * vector, int index)
+{
+    void *           element = NULL;
+    cvector_slot_t * slot    = NULL;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if ((0 > index) || (index >= cvector_size(vector)))
+    {
+        print_error("Index out of bounds.");
+        goto END;
+    }
+
+    slot = cvector_slot(vector, index);
+    if (NULL != slot)
+    {
+        element = atomic_load_explicit(slot, memory_order_acquire);
+    }
+
+END:
+    return element;
+}
+
+int cvector_set_element(cvector_t * vector, void * data, int index)
+{
+    int              exit_code = E_FAILURE;
+    cvector_slot_t * slot      = NULL;
+
+    if ((NULL == vector) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if ((0 > index) || (index >= cvector_size(vector)))
+    {
+        print_error("Index out of bounds.");
+        goto END;
+    }
+
+    slot = cvector_slot(vector, index);
+    if (NULL == slot)
+    {
+        print_error("Element is not published yet.");
+        goto END;
+    }
+
+    atomic_store_explicit(slot, data, memory_order_release);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int cvector_size(cvector_t * vector)
+{
+    int size = -1;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // Failed appends past the limit still bump the counter
+    size = atomic_load_explicit(&vector->size, memory_order_acquire);
+    if (CVECTOR_MAX_SIZE < size)
+    {
+        size = CVECTOR_MAX_SIZE;
+    }
+
+END:
+    return size;
+}
+
+int cvector_iterate(cvector_t * vector, ACT_F action_function)
+{
+    int    exit_code = E_FAILURE;
+    int    size      = 0;
+    void * element   = NULL;
+
+    if ((NULL == vector) || (NULL == action_function))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    size = cvector_size(vector);
+    for (int idx = 0; idx < size; idx++)
+    {
+        cvector_slot_t * slot = cvector_slot(vector, idx);
+
+        element = (NULL == slot)
+                      ? NULL
+                      : atomic_load_explicit(slot, memory_order_acquire);
+        if (NULL != element)
+        {
+            action_function(element);
+        }
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * cvector_find_first_occurrence(cvector_t * vector, void * search_data)
+{
+    void * found_element = NULL;
+    void * element       = NULL;
+    int    size          = 0;
+
+    if ((NULL == vector) || (NULL == search_data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    size = cvector_size(vector);
+    for (int idx = 0; idx < size; idx++)
+    {
+        cvector_slot_t * slot = cvector_slot(vector, idx);
+
+        element = (NULL == slot)
+                      ? NULL
+                      : atomic_load_explicit(slot, memory_order_acquire);
+        if ((NULL != element)
+            && (EQUAL == vector->compare_func(search_data, element)))
+        {
+            found_element = element;
+            break;
+        }
+    }
+
+END:
+    return found_element;
+}
+
+int cvector_clear(cvector_t * vector)
+{
+    int              exit_code = E_FAILURE;
+    int              size      = 0;
+    cvector_slot_t * items     = NULL;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    size = cvector_size(vector);
+    for (int segment = 0; segment < CVECTOR_SEGMENT_COUNT; segment++)
+    {
+        int first = (int)cvector_segment_size(segment)
+                    - CVECTOR_FIRST_SEGMENT_SIZE;
+
+        items = atomic_load_explicit(&vector->segments[segment],
+                                     memory_order_relaxed);
+        if ((NULL == items) || (first >= size))
+        {
+            break;
+        }
+
+        for (size_t slot = 0; slot < cvector_segment_size(segment); slot++)
+        {
+            void * element
+                = atomic_load_explicit(&items[slot], memory_order_relaxed);
+            if (NULL != element)
+            {
+                vector->custom_free(element);
+                atomic_store_explicit(&items[slot], NULL, memory_order_relaxed);
+            }
+        }
+    }
+
+    atomic_store_explicit(&vector->size, 0, memory_order_release);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void cvector_delete(cvector_t ** vector)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == vector) || (NULL == *vector))
+    {
+        print_error("NULL argument passed.");
+        return;
+    }
+
+    exit_code = cvector_clear(*vector);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to clear vector.");
+        goto END;
+    }
+
+    for (int segment = 0; segment < CVECTOR_SEGMENT_COUNT; segment++)
+    {
+        free(atomic_load_explicit(&(*vector)->segments[segment],
+                                  memory_order_relaxed));
+    }
+    free(*vector);
+    *vector = NULL;
+
+END:
+    return;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static int cvector_locate(int index, int * offset)
+{
+    unsigned int biased  = (unsigned int)index + CVECTOR_FIRST_SEGMENT_SIZE;
+    int          segment = 0;
+
+    segment = (31 - __builtin_clz(biased)) - CVECTOR_FIRST_SEGMENT_BITS;
+
+    *offset = (int)(biased - (unsigned int)cvector_segment_size(segment));
+
+    return segment;
+}
+
+static size_t cvector_segment_size(int segment)
+{
+    return (size_t)CVECTOR_FIRST_SEGMENT_SIZE << segment;
+}
+
+static cvector_slot_t * cvector_segment(cvector_t * vector, int segment)
+{
+    cvector_slot_t * items    = NULL;
+    cvector_slot_t * expected = NULL;
+    size_t           count    = cvector_segment_size(segment);
+
+    items = atomic_load_explicit(&vector->segments[segment],
+                                 memory_order_acquire);
+    if (NULL != items)
+    {
+        goto END;
+    }
+
+    items = malloc(count * sizeof(cvector_slot_t));
+    if (NULL == items)
+    {
+        goto END;
+    }
+
+    for (size_t slot = 0; slot < count; slot++)
+    {
+        atomic_init(&items[slot], NULL);
+    }
+
+    // On failure expected holds the segment another thread installed
+    if (!atomic_compare_exchange_strong_explicit(&vector->segments[segment],
+                                                 &expected,
+                                                 items,
+                                                 memory_order_acq_rel,
+                                                 memory_order_acquire))
+    {
+        free(items);
+        items = expected;
+    }
+
+END:
+    return items;
+}
+
+static cvector_slot_t * cvector_slot(cvector_t * vector, int index)
+{
+    cvector_slot_t * items   = NULL;
+    cvector_slot_t * slot    = NULL;
+    int              offset  = 0;
+    int              segment = cvector_locate(index, &offset);
+
+    items = atomic_load_explicit(&vector->segments[segment],
+                                 memory_order_acquire);
+    if (NULL != items)
+    {
+        slot = &items[offset];
+    }
+
+    return slot;
+}
+
+/*** end of file ***/
@@ -0,0 +1,819 @@
+#include <string.h> // memcpy(), memset()
+
+#include "cuckoo_filter.h"
+#include "utilities.h"
+
+#define CUCKOO_HEADER_BYTES 40 // Magic, widths, counts and the victim
+#define CUCKOO_BATCH        8  // Keys hashed and prefetched ahead
+#define CUCKOO_LOAD_PERCENT 95 // Highest load insertion reliably reaches
+#define CUCKOO_RANDOM_SEED  0x9e3779b97f4a7c15ULL
+
+/**
+ * @brief Reads the fingerprint in a slot.
+ *
+ * @param filter Pointer to the filter.
+ * @param slot Index of the slot across all buckets.
+ * @return The fingerprint, or 0 if the slot is empty.
+ */
+static uint32_t cuckoo_slot_get(cuckoo_filter_t * filter, uint64_t slot);
+
+/**
+ * @brief Writes the fingerprint in a slot.
+ *
+ * @param filter Pointer to the filter.
+ * @param slot Index of the slot across all buckets.
+ * @param fingerprint Fingerprint to write, or 0 to empty the slot.
+ */
+static void cuckoo_slot_set(cuckoo_filter_t * filter,
+                            uint64_t          slot,
+                            uint32_t          fingerprint);
+
+/**
+ * @brief Mixes a key's hash and splits it into its first bucket and its
+ * fingerprint. They come from opposite ends of the mixed hash so they do not
+ * depend on each other.
+ *
+ * @param filter Pointer to the filter.
+ * @param hash Hash of the key.
+ * @param fingerprint Receives the fingerprint, never 0.
+ * @return Index of the first bucket.
+ */
+static uint64_t cuckoo_locate(cuckoo_filter_t * filter,
+                              uint64_t          hash,
+                              uint32_t *        fingerprint);
+
+/**
+ * @brief Returns the other bucket a fingerprint may live in. Applying it
+ * twice gives back the bucket it started from.
+ *
+ * @param filter Pointer to the filter.
+ * @param index Index of one bucket.
+ * @param fingerprint The fingerprint.
+ * @return Index of the other bucket.
+ */
+static uint64_t cuckoo_alt_index(cuckoo_filter_t * filter,
+                                 uint64_t          index,
+                                 uint32_t          fingerprint);
+
+/**
+ * @brief Checks whether a bucket holds a fingerprint.
+ *
+ * @param filter Pointer to the filter.
+ * @param index Index of the bucket.
+ * @param fingerprint Fingerprint to look for.
+ * @return true if it is in the bucket.
+ */
+static bool cuckoo_bucket_find(cuckoo_filter_t * filter,
+                               uint64_t          index,
+                               uint32_t          fingerprint);
+
+/**
+ * @brief Puts a fingerprint in an empty slot of a bucket.
+ *
+ * @param filter Pointer to the filter.
+ * @param index Index of the bucket.
+ * @param fingerprint Fingerprint to add.
+ * @return true if the bucket had room.
+ */
+static bool cuckoo_bucket_add(cuckoo_filter_t * filter,
+                              uint64_t          index,
+                              uint32_t          fingerprint);
+
+/**
+ * @brief Empties one slot of a bucket holding a fingerprint.
+ *
+ * @param filter Pointer to the filter.
+ * @param index Index of the bucket.
+ * @param fingerprint Fingerprint to remove.
+ * @return true if the fingerprint was in the bucket.
+ */
+static bool cuckoo_bucket_drop(cuckoo_filter_t * filter,
+                               uint64_t          index,
+                               uint32_t          fingerprint);
+
+/**
+ * @brief Stores a fingerprint in one of its buckets, evicting others when
+ * both are full, and counts the key.
+ *
+ * @param filter Pointer to the filter, which must have no victim.
+ * @param index Index of the fingerprint's first bucket.
+ * @param alt_index Index of the fingerprint's second bucket.
+ * @param fingerprint Fingerprint to store.
+ */
+static void cuckoo_add(cuckoo_filter_t * filter,
+                       uint64_t          index,
+                       uint64_t          alt_index,
+                       uint32_t          fingerprint);
+
+/**
+ * @brief Checks whether a fingerprint is in either of its buckets or is
+ * the victim evicted from one of them.
+ *
+ * @param filter Pointer to the filter.
+ * @param index Index of the fingerprint's first bucket.
+ * @param alt_index Index of the fingerprint's second bucket.
+ * @param fingerprint Fingerprint to look for.
+ * @return true if the fingerprint was found.
+ */
+static bool cuckoo_match(cuckoo_filter_t * filter,
+                         uint64_t          index,
+                         uint64_t          alt_index,
+                         uint32_t          fingerprint);
+
+/**
+ * @brief Returns the first byte of a bucket, for prefetching.
+ *
+ * @param filter Pointer to the filter.
+ * @param index Index of the bucket.
+ * @return Pointer to the bucket.
+ */
+static const uint8_t * cuckoo_bucket(cuckoo_filter_t * filter, uint64_t index);
+
+/**
+ * @brief Places a fingerprint whose two buckets are full by evicting
+ * fingerprints to their other buckets. If no free slot turns up the last
+ * evicted fingerprint becomes the victim.
+ *
+ * @param filter Pointer to the filter, which must have no victim.
+ * @param index Index of one of the fingerprint's buckets.
+ * @param fingerprint Fingerprint to place.
+ */
+static void cuckoo_kick(cuckoo_filter_t * filter,
+                        uint64_t          index,
+                        uint32_t          fingerprint);
+
+/**
+ * @brief Returns the next value of the filter's xorshift generator.
+ *
+ * @param filter Pointer to the filter.
+ * @return A pseudo random value.
+ */
+static uint64_t cuckoo_random(cuckoo_filter_t * filter);
+
+/**
+ * @brief Allocates a filter with empty slots.
+ *
+ * @param hash_func Function hashing keys.
+ * @param bucket_count Number of buckets, a power of two.
+ * @param fingerprint_bits Width of a fingerprint, 8 or 16.
+ * @return Pointer to the new filter, or NULL on failure.
+ */
+static cuckoo_filter_t * cuckoo_alloc(HASH_F   hash_func,
+                                      uint64_t bucket_count,
+                                      uint32_t fingerprint_bits);
+
+/**
+ * @brief Returns the number of bytes the slots of a filter take.
+ *
+ * @param filter Pointer to the filter.
+ * @return Size of the slot array.
+ */
+static size_t cuckoo_slots_bytes(cuckoo_filter_t * filter);
+
+cuckoo_filter_t * cuckoo_filter_new(HASH_F   hash_func,
+                                    uint64_t expected_items,
+                                    double   false_positive_rate)
+{
+    cuckoo_filter_t * new_filter       = NULL;
+    uint64_t          buckets_needed   = 0;
+    uint64_t          bucket_count     = 1;
+    uint32_t          fingerprint_bits = 0;
+
+    if (NULL == hash_func)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if ((0 == expected_items) || (CUCKOO_MAX_BUCKETS < expected_items)
+        || !(0 < false_positive_rate) || !(1 > false_positive_rate))
+    {
+        print_error("Invalid argument passed.");
+        goto END;
+    }
+
+    // A lookup compares against the 2 * 4 fingerprints of its buckets, each
+    // matching by chance with probability 2^-bits
+    if ((2.0 * CUCKOO_BUCKET_SLOTS / 256) <= false_positive_rate)
+    {
+        fingerprint_bits = 8;
+    }
+    else if ((2.0 * CUCKOO_BUCKET_SLOTS / 65536) <= false_positive_rate)
+    {
+        fingerprint_bits = 16;
+    }
+    else
+    {
+        print_error("False positive rate too low.");
+        goto END;
+    }
+
+    buckets_needed = (((expected_items * 100) / CUCKOO_LOAD_PERCENT)
+                      + CUCKOO_BUCKET_SLOTS - 1)
+                     / CUCKOO_BUCKET_SLOTS;
+    while (bucket_count < buckets_needed)
+    {
+        bucket_count *= 2;
+    }
+
+    if (CUCKOO_MAX_BUCKETS < bucket_count)
+    {
+        print_error("Invalid filter size.");
+        goto END;
+    }
+
+    new_filter = cuckoo_alloc(hash_func, bucket_count, fingerprint_bits);
+
+END:
+    return new_filter;
+}
+
+int cuckoo_filter_insert(cuckoo_filter_t * filter, void * key)
+{
+    int      exit_code   = E_FAILURE;
+    uint64_t index       = 0;
+    uint32_t fingerprint = 0;
+
+    if ((NULL == filter) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // With a victim waiting no further fingerprint is accepted, so none is
+    // ever lost
+    if (0 != filter->victim)
+    {
+        goto END;
+    }
+
+    index = cuckoo_locate(filter, filter->hash_func(key), &fingerprint);
+    cuckoo_add(filter,
+               index,
+               cuckoo_alt_index(filter, index, fingerprint),
+               fingerprint);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+bool cuckoo_filter_contains(cuckoo_filter_t * filter, void * key)
+{
+    bool     found       = false;
+    uint64_t index       = 0;
+    uint32_t fingerprint = 0;
+
+    if ((NULL == filter) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    index = cuckoo_locate(filter, filter->hash_func(key), &fingerprint);
+    found = cuckoo_match(filter,
+                         index,
+                         cuckoo_alt_index(filter, index, fingerprint),
+                         fingerprint);
+
+END:
+    return found;
+}
+
+int cuckoo_filter_remove(cuckoo_filter_t * filter, void * key)
+{
+    int      exit_code   = E_FAILURE;
+    uint64_t index       = 0;
+    uint64_t alt_index   = 0;
+    uint32_t fingerprint = 0;
+
+    if ((NULL == filter) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    index     = cuckoo_locate(filter, filter->hash_func(key), &fingerprint);
+    alt_index = cuckoo_alt_index(filter, index, fingerprint);
+    if ((fingerprint == filter->victim)
+        && ((index == filter->victim_index)
+            || (alt_index == filter->victim_index)))
+    {
+        filter->victim = 0;
+    }
+    else if ((false == cuckoo_bucket_drop(filter, index, fingerprint))
+             && (false == cuckoo_bucket_drop(filter, alt_index, fingerprint)))
+    {
+        goto END;
+    }
+    filter->count--;
+
+    // The freed slot may give the victim a home again
+    if (0 != filter->victim)
+    {
+        fingerprint    = filter->victim;
+        filter->victim = 0;
+        cuckoo_kick(filter, filter->victim_index, fingerprint);
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int64_t cuckoo_filter_insert_batch(cuckoo_filter_t * filter,
+                                   void **           keys,
+                                   uint32_t          count)
+{
+    int64_t  inserted = -1;
+    uint64_t indexes[CUCKOO_BATCH];
+    uint64_t alt_indexes[CUCKOO_BATCH];
+    uint32_t fingerprints[CUCKOO_BATCH];
+
+    if ((NULL == filter) || (NULL == keys))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    inserted = 0;
+    for (uint32_t start = 0; start < count; start += CUCKOO_BATCH)
+    {
+        uint32_t batch = count - start;
+
+        if (CUCKOO_BATCH < batch)
+        {
+            batch = CUCKOO_BATCH;
+        }
+
+        for (uint32_t idx = 0; idx < batch; idx++)
+        {
+            if (NULL == keys[start + idx])
+            {
+                print_error("NULL argument passed.");
+                inserted = -1;
+                goto END;
+            }
+            indexes[idx]     = cuckoo_locate(filter,
+                                         filter->hash_func(keys[start + idx]),
+                                         &fingerprints[idx]);
+            alt_indexes[idx] = cuckoo_alt_index(
+                filter, indexes[idx], fingerprints[idx]);
+            __builtin_prefetch(cuckoo_bucket(filter, indexes[idx]), 1);
+            __builtin_prefetch(cuckoo_bucket(filter, alt_indexes[idx]), 1);
+        }
+
+        for (uint32_t idx = 0; idx < batch; idx++)
+        {
+            if (0 != filter->victim)
+            {
+                goto END;
+            }
+            cuckoo_add(
+                filter, indexes[idx], alt_indexes[idx], fingerprints[idx]);
+            inserted++;
+        }
+    }
+
+END:
+    return inserted;
+}
+
+int cuckoo_filter_contains_batch(cuckoo_filter_t * filter,
+                                 void **           keys,
+                                 uint32_t          count,
+                                 bool *            results)
+{
+    int      exit_code = E_FAILURE;
+    uint64_t indexes[CUCKOO_BATCH];
+    uint64_t alt_indexes[CUCKOO_BATCH];
+    uint32_t fingerprints[CUCKOO_BATCH];
+
+    if ((NULL == filter) || (NULL == keys) || (NULL == results))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (uint32_t start = 0; start < count; start += CUCKOO_BATCH)
+    {
+        uint32_t batch = count - start;
+
+        if (CUCKOO_BATCH < batch)
+        {
+            batch = CUCKOO_BATCH;
+        }
+
+        for (uint32_t idx = 0; idx < batch; idx++)
+        {
+            if (NULL == keys[start + idx])
+            {
+                print_error("NULL argument passed.");
+                goto END;
+            }
+            indexes[idx]     = cuckoo_locate(filter,
+                                         filter->hash_func(keys[start + idx]),
+                                         &fingerprints[idx]);
+            alt_indexes[idx] = cuckoo_alt_index(
+                filter, indexes[idx], fingerprints[idx]);
+            __builtin_prefetch(cuckoo_bucket(filter, indexes[idx]), 0);
+            __builtin_prefetch(cuckoo_bucket(filter, alt_indexes[idx]), 0);
+        }
+
+        for (uint32_t idx = 0; idx < batch; idx++)
+        {
+            results[start + idx] = cuckoo_match(
+                filter, indexes[idx], alt_indexes[idx], fingerprints[idx]);
+        }
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int64_t cuckoo_filter_size(cuckoo_filter_t * filter)
+{
+    int64_t size = -1;
+
+    if (NULL == filter)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    size = (int64_t)filter->count;
+
+END:
+    return size;
+}
+
+size_t cuckoo_filter_serialized_size(cuckoo_filter_t * filter)
+{
+    size_t size = 0;
+
+    if (NULL == filter)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    size = CUCKOO_HEADER_BYTES + cuckoo_slots_bytes(filter);
+
+END:
+    return size;
+}
+
+int cuckoo_filter_serialize(cuckoo_filter_t * filter,
+                            void *            buffer,
+                            size_t            size)
+{
+    int       exit_code = E_FAILURE;
+    uint8_t * bytes     = buffer;
+    uint32_t  magic     = CUCKOO_FILTER_MAGIC;
+
+    if ((NULL == filter) || (NULL == buffer))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (cuckoo_filter_serialized_size(filter) > size)
+    {
+        print_error("Buffer too small.");
+        goto END;
+    }
+
+    memset(bytes, 0, CUCKOO_HEADER_BYTES);
+    memcpy(bytes, &magic, sizeof(magic));
+    memcpy(bytes + 4, &filter->fingerprint_bits, sizeof(uint32_t));
+    memcpy(bytes + 8, &filter->bucket_count, sizeof(uint64_t));
+    memcpy(bytes + 16, &filter->count, sizeof(uint64_t));
+    memcpy(bytes + 24, &filter->victim_index, sizeof(uint64_t));
+    memcpy(bytes + 32, &filter->victim, sizeof(uint32_t));
+    memcpy(bytes + CUCKOO_HEADER_BYTES,
+           filter->slots,
+           cuckoo_slots_bytes(filter));
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+cuckoo_filter_t * cuckoo_filter_deserialize(HASH_F       hash_func,
+                                            const void * buffer,
+                                            size_t       size)
+{
+    cuckoo_filter_t * new_filter       = NULL;
+    const uint8_t *   bytes            = buffer;
+    uint32_t          magic            = 0;
+    uint32_t          fingerprint_bits = 0;
+    uint64_t          bucket_count     = 0;
+
+    if ((NULL == hash_func) || (NULL == buffer))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (CUCKOO_HEADER_BYTES > size)
+    {
+        print_error("Invalid filter data.");
+        goto END;
+    }
+
+    memcpy(&magic, bytes, sizeof(magic));
+    memcpy(&fingerprint_bits, bytes + 4, sizeof(uint32_t));
+    memcpy(&bucket_count, bytes + 8, sizeof(uint64_t));
+    if ((CUCKOO_FILTER_MAGIC != magic)
+        || ((8 != fingerprint_bits) && (16 != fingerprint_bits))
+        || (0 == bucket_count) || (CUCKOO_MAX_BUCKETS < bucket_count)
+        || (0 != (bucket_count & (bucket_count - 1)))
+        || (((size - CUCKOO_HEADER_BYTES) / (fingerprint_bits / 8)
+             / CUCKOO_BUCKET_SLOTS)
+            < bucket_count))
+    {
+        print_error("Invalid filter data.");
+        goto END;
+    }
+
+    new_filter = cuckoo_alloc(hash_func, bucket_count, fingerprint_bits);
+    if (NULL == new_filter)
+    {
+        goto END;
+    }
+
+    memcpy(&new_filter->count, bytes + 16, sizeof(uint64_t));
+    memcpy(&new_filter->victim_index, bytes + 24, sizeof(uint64_t));
+    memcpy(&new_filter->victim, bytes + 32, sizeof(uint32_t));
+    new_filter->victim_index &= bucket_count - 1;
+    memcpy(new_filter->slots,
+           bytes + CUCKOO_HEADER_BYTES,
+           cuckoo_slots_bytes(new_filter));
+
+END:
+    return new_filter;
+}
+
+int cuckoo_filter_clear(cuckoo_filter_t * filter)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == filter)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    memset(filter->slots, 0, cuckoo_slots_bytes(filter));
+    filter->count        = 0;
+    filter->victim       = 0;
+    filter->victim_index = 0;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int cuckoo_filter_delete(cuckoo_filter_t ** filter_address)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == filter_address) || (NULL == *filter_address))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    free((*filter_address)->slots);
+    free(*filter_address);
+    *filter_address = NULL;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static uint32_t cuckoo_slot_get(cuckoo_filter_t * filter, uint64_t slot)
+{
+    uint32_t fingerprint = 0;
+
+    if (8 == filter->fingerprint_bits)
+    {
+        fingerprint = filter->slots[slot];
+    }
+    else
+    {
+        fingerprint = ((uint16_t *)(void *)filter->slots)[slot];
+    }
+
+    return fingerprint;
+}
+
+static void cuckoo_slot_set(cuckoo_filter_t * filter,
+                            uint64_t          slot,
+                            uint32_t          fingerprint)
+{
+    if (8 == filter->fingerprint_bits)
+    {
+        filter->slots[slot] = (uint8_t)fingerprint;
+    }
+    else
+    {
+        ((uint16_t *)(void *)filter->slots)[slot] = (uint16_t)fingerprint;
+    }
+}
+
+static uint64_t cuckoo_locate(cuckoo_filter_t * filter,
+                              uint64_t          hash,
+                              uint32_t *        fingerprint)
+{
+    // Mixing first spreads a hash that only fills the low 32 bits into the
+    // top bits, which would otherwise leave every fingerprint 0
+    hash = hash_u64(hash);
+
+    // Bucket indexes use at most the low 32 bits, fingerprints the top 16
+    *fingerprint = (uint32_t)(hash >> (64 - filter->fingerprint_bits));
+    if (0 == *fingerprint)
+    {
+        *fingerprint = 1;
+    }
+
+    return hash & (filter->bucket_count - 1);
+}
+
+static uint64_t cuckoo_alt_index(cuckoo_filter_t * filter,
+                                 uint64_t          index,
+                                 uint32_t          fingerprint)
+{
+    return (index ^ hash_u64(fingerprint)) & (filter->bucket_count - 1);
+}
+
+static bool cuckoo_bucket_find(cuckoo_filter_t * filter,
+                               uint64_t          index,
+                               uint32_t          fingerprint)
+{
+    bool     found = false;
+    uint64_t first = index * CUCKOO_BUCKET_SLOTS;
+
+    for (uint64_t slot = first; slot < first + CUCKOO_BUCKET_SLOTS; slot++)
+    {
+        found |= (fingerprint == cuckoo_slot_get(filter, slot));
+    }
+
+    return found;
+}
+
+static bool cuckoo_bucket_add(cuckoo_filter_t * filter,
+                              uint64_t          index,
+                              uint32_t          fingerprint)
+{
+    bool     added = false;
+    uint64_t first = index * CUCKOO_BUCKET_SLOTS;
+
+    for (uint64_t slot = first; slot < first + CUCKOO_BUCKET_SLOTS; slot++)
+    {
+        if (0 == cuckoo_slot_get(filter, slot))
+        {
+            cuckoo_slot_set(filter, slot, fingerprint);
+            added = true;
+            break;
+        }
+    }
+
+    return added;
+}
+
+static bool cuckoo_bucket_drop(cuckoo_filter_t * filter,
+                               uint64_t          index,
+                               uint32_t          fingerprint)
+{
+    bool     dropped = false;
+    uint64_t first   = index * CUCKOO_BUCKET_SLOTS;
+
+    for (uint64_t slot = first; slot < first + CUCKOO_BUCKET_SLOTS; slot++)
+    {
+        if (fingerprint == cuckoo_slot_get(filter, slot))
+        {
+            cuckoo_slot_set(filter, slot, 0);
+            dropped = true;
+            break;
+        }
+    }
+
+    return dropped;
+}
+
+static void cuckoo_add(cuckoo_filter_t * filter,
+                       uint64_t          index,
+                       uint64_t          alt_index,
+                       uint32_t          fingerprint)
+{
+    if ((false == cuckoo_bucket_add(filter, index, fingerprint))
+        && (false == cuckoo_bucket_add(filter, alt_index, fingerprint)))
+    {
+        // Start from either bucket so evictions do not pile onto one side
+        if (0 != (cuckoo_random(filter) & 1))
+        {
+            index = alt_index;
+        }
+        cuckoo_kick(filter, index, fingerprint);
+    }
+    filter->count++;
+}
+
+static bool cuckoo_match(cuckoo_filter_t * filter,
+                         uint64_t          index,
+                         uint64_t          alt_index,
+                         uint32_t          fingerprint)
+{
+    return cuckoo_bucket_find(filter, index, fingerprint)
+           || cuckoo_bucket_find(filter, alt_index, fingerprint)
+           || ((fingerprint == filter->victim)
+               && ((index == filter->victim_index)
+                   || (alt_index == filter->victim_index)));
+}
+
+static const uint8_t * cuckoo_bucket(cuckoo_filter_t * filter, uint64_t index)
+{
+    return &filter->slots[index * CUCKOO_BUCKET_SLOTS
+                          * (filter->fingerprint_bits / 8)];
+}
+
+static void cuckoo_kick(cuckoo_filter_t * filter,
+                        uint64_t          index,
+                        uint32_t          fingerprint)
+{
+    for (uint32_t kick = 0; kick < CUCKOO_MAX_KICKS; kick++)
+    {
+        uint64_t slot = (index * CUCKOO_BUCKET_SLOTS)
+                        + (cuckoo_random(filter) % CUCKOO_BUCKET_SLOTS);
+        uint32_t evicted = cuckoo_slot_get(filter, slot);
+
+        cuckoo_slot_set(filter, slot, fingerprint);
+        fingerprint = evicted;
+        index       = cuckoo_alt_index(filter, index, fingerprint);
+        if (true == cuckoo_bucket_add(filter, index, fingerprint))
+        {
+            return;
+        }
+    }
+
+    filter->victim       = fingerprint;
+    filter->victim_index = index;
+}
+
+static uint64_t cuckoo_random(cuckoo_filter_t * filter)
+{
+    filter->random ^= filter->random << 13;
+    filter->random ^= filter->random >> 7;
+    filter->random ^= filter->random << 17;
+
+    return filter->random;
+}
+
+static cuckoo_filter_t * cuckoo_alloc(HASH_F   hash_func,
+                                      uint64_t bucket_count,
+                                      uint32_t fingerprint_bits)
+{
+    cuckoo_filter_t * new_filter = NULL;
+
+    new_filter = calloc(1, sizeof(cuckoo_filter_t));
+    if (NULL == new_filter)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    new_filter->bucket_count     = bucket_count;
+    new_filter->fingerprint_bits = fingerprint_bits;
+    new_filter->count            = 0;
+    new_filter->victim           = 0;
+    new_filter->victim_index     = 0;
+    new_filter->random           = CUCKOO_RANDOM_SEED;
+    new_filter->hash_func        = hash_func;
+
+    new_filter->slots = calloc(1, cuckoo_slots_bytes(new_filter));
+    if (NULL == new_filter->slots)
+    {
+        print_error("CMR failure.");
+        free(new_filter);
+        new_filter = NULL;
+        goto END;
+    }
+
+END:
+    return new_filter;
+}
+
+static size_t cuckoo_slots_bytes(cuckoo_filter_t * filter)
+{
+    return filter->bucket_count * CUCKOO_BUCKET_SLOTS
+           * (filter->fingerprint_bits / 8);
+}
+
+/*** end of file ***/
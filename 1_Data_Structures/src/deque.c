@@ -0,0 +1,449 @@
+#include <limits.h> // INT_MAX
+#include <string.h> // memcpy()
+
+#include "deque.h"
+#include "utilities.h"
+
+#define DEQUE_MIN_CAPACITY 8 // Smallest buffer a deque is created with
+
+/**
+ * @brief Maps a logical index to its physical slot in the circular buffer.
+ *
+ * @param deque Pointer to the deque.
+ * @param index Logical index, 0 being the front.
+ * @return Physical slot of the element.
+ */
+static int deque_slot(deque_t * deque, int index);
+
+/**
+ * @brief Doubles the capacity of the deque and unwraps its elements so the
+ * front sits at slot 0.
+ *
+ * @param deque Pointer to the deque to be resized.
+ * @return Status code indicating success (E_SUCCESS) or failure (E_FAILURE).
+ */
+static int deque_resize(deque_t * deque);
+
+deque_t * deque_new(FREE_F free_func, CMP_F comp_func, int initial_capacity)
+{
+    deque_t * new_deque = NULL;
+    int       capacity  = DEQUE_MIN_CAPACITY;
+
+    if ((NULL == free_func) || (NULL == comp_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // Round the capacity up to a power of two
+    while ((capacity < initial_capacity) && (capacity <= INT_MAX / 2))
+    {
+        capacity *= 2;
+    }
+
+    new_deque = calloc(1, sizeof(deque_t));
+    if (NULL == new_deque)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    new_deque->elements = calloc(capacity, sizeof(void *));
+    if (NULL == new_deque->elements)
+    {
+        print_error("CMR failure.");
+        free(new_deque);
+        new_deque = NULL;
+        goto END;
+    }
+
+    new_deque->head         = 0;
+    new_deque->size         = 0;
+    new_deque->capacity     = capacity;
+    new_deque->custom_free  = free_func;
+    new_deque->compare_func = comp_func;
+
+END:
+    return new_deque;
+}
+
+int deque_push_front(deque_t * deque, void * data)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == deque) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (deque->size == deque->capacity)
+    {
+        exit_code = deque_resize(deque);
+        if (E_SUCCESS != exit_code)
+        {
+            print_error("Unable to resize deque.");
+            goto END;
+        }
+    }
+
+    // Step the head back one slot, wrapping around to the end of the buffer
+    deque->head                  = (deque->head - 1) & (deque->capacity - 1);
+    deque->elements[deque->head] = data;
+    deque->size++;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int deque_push_back(deque_t * deque, void * data)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == deque) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (deque->size == deque->capacity)
+    {
+        exit_code = deque_resize(deque);
+        if (E_SUCCESS != exit_code)
+        {
+            print_error("Unable to resize deque.");
+            goto END;
+        }
+    }
+
+    deque->elements[deque_slot(deque, deque->size)] = data;
+    deque->size++;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * deque_pop_front(deque_t * deque)
+{
+    void * element = NULL;
+
+    if (NULL == deque)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 == deque->size)
+    {
+        print_error("Empty deque.");
+        goto END;
+    }
+
+    element                      = deque->elements[deque->head];
+    deque->elements[deque->head] = NULL;
+    deque->head                  = (deque->head + 1) & (deque->capacity - 1);
+    deque->size--;
+
+END:
+    return element;
+}
+
+void * deque_pop_back(deque_t * deque)
+{
+    void * element = NULL;
+    int    slot    = 0;
+
+    if (NULL == deque)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 == deque->size)
+    {
+        print_error("Empty deque.");
+        goto END;
+    }
+
+    slot                  = deque_slot(deque, deque->size - 1);
+    element               = deque->elements[slot];
+    deque->elements[slot] = NULL;
+    deque->size--;
+
+END:
+    return element;
+}
+
+void * deque_peek_front(deque_t * deque)
+{
+    return deque_get_element(deque, 0);
+}
+
+void * deque_peek_back(deque_t * deque)
+{
+    void * element = NULL;
+
+    if (NULL == deque)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    element = deque_get_element(deque, deque->size - 1);
+
+END:
+    return element;
+}
+
+void * deque_get_element(deque_t * deque, int index)
+{
+    void * element = NULL;
+
+    if (NULL == deque)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if ((0 > index) || (index >= deque->size))
+    {
+        print_error("Index out of bounds.");
+        goto END;
+    }
+
+    element = deque->elements[deque_slot(deque, index)];
+
+END:
+    return element;
+}
+
+int deque_set_element(deque_t * deque, void * data, int index)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == deque) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if ((0 > index) || (index >= deque->size))
+    {
+        print_error("Index out of bounds.");
+        goto END;
+    }
+
+    deque->elements[deque_slot(deque, index)] = data;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+bool deque_is_empty(deque_t * deque)
+{
+    bool is_empty = false;
+
+    if (NULL == deque)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 == deque->size)
+    {
+        is_empty = true;
+    }
+
+END:
+    return is_empty;
+}
+
+int deque_size(deque_t * deque)
+{
+    int size = -1;
+
+    if (NULL == deque)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    size = deque->size;
+END:
+    return size;
+}
+
+int deque_capacity(deque_t * deque)
+{
+    int capacity = -1;
+
+    if (NULL == deque)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    capacity = deque->capacity;
+END:
+    return capacity;
+}
+
+int deque_iterate(deque_t * deque, ACT_F action_function)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == deque) || (NULL == action_function))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (int idx = 0; idx < deque->size; idx++)
+    {
+        action_function(deque->elements[deque_slot(deque, idx)]);
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * deque_find_first_occurrence(deque_t * deque, void * search_data)
+{
+    void * found_element = NULL;
+
+    if ((NULL == deque) || (NULL == search_data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (int idx = 0; idx < deque->size; idx++)
+    {
+        void * element = deque->elements[deque_slot(deque, idx)];
+
+        if (EQUAL == deque->compare_func(search_data, element))
+        {
+            found_element = element;
+            goto END;
+        }
+    }
+
+END:
+    return found_element;
+}
+
+int deque_clear(deque_t * deque)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == deque)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (int idx = 0; idx < deque->size; idx++)
+    {
+        int slot = deque_slot(deque, idx);
+
+        deque->custom_free(deque->elements[slot]);
+        deque->elements[slot] = NULL;
+    }
+
+    deque->head = 0;
+    deque->size = 0;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void deque_delete(deque_t ** deque)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == deque) || (NULL == *deque))
+    {
+        print_error("NULL argument passed.");
+        return;
+    }
+
+    exit_code = deque_clear(*deque);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to clear deque.");
+        goto END;
+    }
+
+    free((*deque)->elements);
+    free(*deque);
+    *deque = NULL;
+
+END:
+    return;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static int deque_slot(deque_t * deque, int index)
+{
+    return (deque->head + index) & (deque->capacity - 1);
+}
+
+static int deque_resize(deque_t * deque)
+{
+    int     exit_code      = E_FAILURE;
+    void ** resized_array  = NULL;
+    int     front_elements = 0;
+
+    if (NULL == deque)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (deque->capacity > INT_MAX / 2)
+    {
+        print_error("Deque is at its maximum capacity.");
+        goto END;
+    }
+
+    resized_array = calloc((size_t)deque->capacity * 2, sizeof(void *));
+    if (NULL == resized_array)
+    {
+        print_error("Failed to reallocate deque.");
+        goto END;
+    }
+
+    // Copy the run from the head to the end of the buffer, then the part
+    // that wrapped around to the start
+    front_elements = deque->capacity - deque->head;
+    if (front_elements > deque->size)
+    {
+        front_elements = deque->size;
+    }
+
+    memcpy(resized_array,
+           &deque->elements[deque->head],
+           front_elements * sizeof(void *));
+    memcpy(&resized_array[front_elements],
+           deque->elements,
+           (deque->size - front_elements) * sizeof(void *));
+
+    free(deque->elements);
+    deque->elements = resized_array;
+    deque->head     = 0;
+    deque->capacity *= 2;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+/*** end of file ***/
@@ -0,0 +1,1150 @@
+#include <string.h> // memset()
+
+#include "hash_table.h"
+#include "utilities.h"
+
+#if defined(__SSE2__)
+#define TABLE_SSE2 1
+#include <emmintrin.h>
+#else
+#define TABLE_SSE2 0
+#endif
+
+#define CTRL_EMPTY      ((int8_t)-128) // 0x80, never used
+#define CTRL_DELETED    ((int8_t)-2)   // 0xFE, tombstone
+#define CTRL_TAG_MASK   0x7F           // Low hash bits kept in a full slot
+#define CTRL_TAG_BITS   7
+#define TABLE_NOT_FOUND UINT32_MAX
+
+/**
+ * @brief Returns a bit for each of the 16 control bytes at `group` that
+ * holds `tag`.
+ *
+ * @param group Pointer to the first control byte of the group.
+ * @param tag Tag to look for.
+ * @return Mask with bit i set if control byte i matches.
+ */
+static uint32_t group_match(const int8_t * group, int8_t tag);
+
+/**
+ * @brief Returns a bit for each of the 16 control bytes at `group` that is
+ * empty.
+ *
+ * @param group Pointer to the first control byte of the group.
+ * @return Mask with bit i set if control byte i is empty.
+ */
+static uint32_t group_match_empty(const int8_t * group);
+
+/**
+ * @brief Returns a bit for each of the 16 control bytes at `group` that is
+ * empty or deleted, which are the bytes with their top bit set.
+ *
+ * @param group Pointer to the first control byte of the group.
+ * @return Mask with bit i set if control byte i is free.
+ */
+static uint32_t group_match_free(const int8_t * group);
+
+/**
+ * @brief Sets a control byte, and its copy past the end of the table when
+ * it lies in the first group.
+ *
+ * @param table Pointer to the table.
+ * @param index Index of the slot.
+ * @param ctrl New control byte.
+ */
+static void table_set_ctrl(hash_table_t * table, uint32_t index, int8_t ctrl);
+
+/**
+ * @brief Finds the slot holding a key.
+ *
+ * @param table Pointer to the table.
+ * @param key Key to look for.
+ * @param hash Hash of the key.
+ * @return Index of the slot, or TABLE_NOT_FOUND.
+ */
+static uint32_t table_find(hash_table_t * table, void * key, uint64_t hash);
+
+/**
+ * @brief Finds the first empty or deleted slot on a hash's probe sequence.
+ *
+ * @param table Pointer to the table, which must have a free slot.
+ * @param hash Hash of the key to place.
+ * @return Index of the slot.
+ */
+static uint32_t table_find_free(hash_table_t * table, uint64_t hash);
+
+/**
+ * @brief Rebuilds the table with a new capacity, dropping every tombstone.
+ *
+ * @param table Pointer to the table.
+ * @param capacity New number of slots, a power of two that fits the entries.
+ * @return Status code indicating success (E_SUCCESS) or failure (E_FAILURE).
+ */
+static int table_resize(hash_table_t * table, uint32_t capacity);
+
+/**
+ * @brief Starts an incremental rebuild: the current slot table becomes the
+ * old table and the entries move over in later updates. Any migration still
+ * under way is finished first.
+ *
+ * @param table Pointer to the table.
+ * @param capacity New number of slots, a power of two that fits the entries
+ * at most half full.
+ * @return Status code indicating success (E_SUCCESS) or failure (E_FAILURE).
+ */
+static int table_begin_migration(hash_table_t * table, uint32_t capacity);
+
+/**
+ * @brief Moves the entries of up to `count` old slots into the table, and
+ * frees the old table once it is drained.
+ *
+ * @param table Pointer to the table, which must have an old table.
+ * @param count Number of old slots to go through.
+ */
+static void table_migrate(hash_table_t * table, uint32_t count);
+
+/**
+ * @brief Shrinks the retired table's arrays by up to `count` slots, and
+ * frees them and the table once nothing is left.
+ *
+ * @param table Pointer to the table, which must have a retired table.
+ * @param count Number of slots to release.
+ */
+static void table_release(hash_table_t * table, uint32_t count);
+
+/**
+ * @brief Readies the spare control array for the next rebuild: allocates it
+ * once the table is close enough to a rebuild, then sets the next
+ * HASH_TABLE_SPARE_STEP of its bytes to empty.
+ *
+ * @param table Pointer to the table.
+ */
+static void table_prepare_spare(hash_table_t * table);
+
+/**
+ * @brief Swaps a table's slot arrays for new empty ones, taking the spare
+ * control array if it is big enough.
+ *
+ * @param table Pointer to the table.
+ * @param capacity New number of slots, a power of two.
+ * @return Status code indicating success (E_SUCCESS) or failure (E_FAILURE).
+ */
+static int table_alloc(hash_table_t * table, uint32_t capacity);
+
+/**
+ * @brief Empties a full slot. The slot becomes empty again if every group
+ * that covers it has an empty slot, since no probe can then have passed
+ * over it; otherwise it becomes a tombstone.
+ *
+ * @param table Pointer to the table.
+ * @param index Index of the slot.
+ */
+static void table_erase_at(hash_table_t * table, uint32_t index);
+
+/**
+ * @brief Returns how many slots of a table may be filled before it must be
+ * rebuilt.
+ *
+ * @param capacity Number of slots.
+ * @return Seven eighths of the capacity.
+ */
+static uint32_t table_max_load(uint32_t capacity);
+
+hash_table_t * hash_table_new(HASH_F hash_func,
+                              CMP_F  compare_func,
+                              FREE_F key_free,
+                              FREE_F value_free)
+{
+    hash_table_t * new_table = NULL;
+
+    if ((NULL == hash_func) || (NULL == compare_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    new_table = calloc(1, sizeof(hash_table_t));
+    if (NULL == new_table)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    hash_table_init(new_table, hash_func, compare_func, key_free, value_free);
+
+END:
+    return new_table;
+}
+
+int hash_table_init(hash_table_t * table,
+                    HASH_F         hash_func,
+                    CMP_F          compare_func,
+                    FREE_F         key_free,
+                    FREE_F         value_free)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == table) || (NULL == hash_func) || (NULL == compare_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    table->ctrl         = NULL;
+    table->slots        = NULL;
+    table->capacity     = 0;
+    table->size         = 0;
+    table->growth_left  = 0;
+    table->hash_func    = hash_func;
+    table->compare_func = compare_func;
+    table->key_free     = key_free;
+    table->value_free   = value_free;
+    table->old          = NULL;
+    table->migrate_pos  = 0;
+    table->incremental  = false;
+    table->spare_ctrl   = NULL;
+    table->spare_size   = 0;
+    table->spare_ready  = 0;
+    table->retired      = NULL;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int hash_table_set_incremental(hash_table_t * table, bool incremental)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == table)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if ((false == incremental) && (NULL != table->old))
+    {
+        table_migrate(table, UINT32_MAX);
+    }
+    if ((false == incremental) && (NULL != table->retired))
+    {
+        table_release(table, UINT32_MAX);
+    }
+    table->incremental = incremental;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int hash_table_reserve(hash_table_t * table, uint32_t count)
+{
+    int      exit_code = E_FAILURE;
+    uint32_t capacity  = HASH_TABLE_MIN_CAPACITY;
+
+    if (NULL == table)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    while (table_max_load(capacity) < count)
+    {
+        if (HASH_TABLE_MAX_CAPACITY == capacity)
+        {
+            print_error("Invalid capacity.");
+            goto END;
+        }
+        capacity *= 2;
+    }
+
+    if (NULL != table->old)
+    {
+        table_migrate(table, UINT32_MAX);
+    }
+
+    exit_code = E_SUCCESS;
+    if (capacity > table->capacity)
+    {
+        exit_code = table_resize(table, capacity);
+    }
+
+END:
+    return exit_code;
+}
+
+int hash_table_insert(hash_table_t * table, void * key, void * value)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == table) || (NULL == key) || (NULL == value))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code
+        = hash_table_insert_hashed(table, key, value, table->hash_func(key));
+
+END:
+    return exit_code;
+}
+
+int hash_table_insert_hashed(hash_table_t * table,
+                             void *         key,
+                             void *         value,
+                             uint64_t       hash)
+{
+    int                 exit_code = E_FAILURE;
+    int                 rebuilt   = E_FAILURE;
+    uint32_t            index     = 0;
+    uint32_t            capacity  = 0;
+    hash_table_slot_t * slot      = NULL;
+
+    if ((NULL == table) || (NULL == key) || (NULL == value))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (NULL != table->old)
+    {
+        table_migrate(table, HASH_TABLE_MIGRATE_STEP);
+    }
+    if (NULL != table->retired)
+    {
+        table_release(table, HASH_TABLE_RELEASE_STEP);
+    }
+    if (true == table->incremental)
+    {
+        table_prepare_spare(table);
+    }
+
+    index = table_find(table, key, hash);
+    if (TABLE_NOT_FOUND != index)
+    {
+        slot = &table->slots[index];
+    }
+    else if (NULL != table->old)
+    {
+        // A key not migrated yet has its value replaced where it is
+        index = table_find(table->old, key, hash);
+        if (TABLE_NOT_FOUND != index)
+        {
+            slot = &table->old->slots[index];
+        }
+    }
+
+    if (NULL != slot)
+    {
+        if ((slot->value != value) && (NULL != table->value_free))
+        {
+            table->value_free(slot->value);
+        }
+        if ((slot->key != key) && (NULL != table->key_free))
+        {
+            table->key_free(key);
+        }
+        slot->value = value;
+        exit_code   = E_SUCCESS;
+        goto END;
+    }
+
+    if (0 == table->capacity)
+    {
+        if (E_SUCCESS != table_resize(table, HASH_TABLE_MIN_CAPACITY))
+        {
+            goto END;
+        }
+    }
+
+    index = table_find_free(table, hash);
+
+    // Reusing a tombstone costs nothing, taking an empty slot needs room
+    if ((CTRL_EMPTY == table->ctrl[index]) && (0 == table->growth_left))
+    {
+        // Mostly tombstones, so a rebuild at the same size frees enough
+        capacity = table->capacity;
+        if (table->size >= table_max_load(capacity) / 2)
+        {
+            if (HASH_TABLE_MAX_CAPACITY == capacity)
+            {
+                print_error("Table is full.");
+                goto END;
+            }
+            capacity *= 2;
+        }
+
+        if (true == table->incremental)
+        {
+            rebuilt = table_begin_migration(table, capacity);
+        }
+        else
+        {
+            rebuilt = table_resize(table, capacity);
+        }
+
+        if (E_SUCCESS != rebuilt)
+        {
+            goto END;
+        }
+        index = table_find_free(table, hash);
+    }
+
+    if (CTRL_EMPTY == table->ctrl[index])
+    {
+        table->growth_left--;
+    }
+
+    table_set_ctrl(table, index, (int8_t)(hash & CTRL_TAG_MASK));
+    table->slots[index].key   = key;
+    table->slots[index].value = value;
+    table->size++;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * hash_table_lookup(hash_table_t * table, void * key)
+{
+    void * value = NULL;
+
+    if ((NULL == table) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    value = hash_table_lookup_hashed(table, key, table->hash_func(key));
+
+END:
+    return value;
+}
+
+void * hash_table_lookup_hashed(hash_table_t * table,
+                                void *         key,
+                                uint64_t       hash)
+{
+    void *   value = NULL;
+    uint32_t index = 0;
+
+    if ((NULL == table) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // Lookups never migrate, so they stay read-only
+    index = table_find(table, key, hash);
+    if (TABLE_NOT_FOUND != index)
+    {
+        value = table->slots[index].value;
+    }
+    else if (NULL != table->old)
+    {
+        index = table_find(table->old, key, hash);
+        if (TABLE_NOT_FOUND != index)
+        {
+            value = table->old->slots[index].value;
+        }
+    }
+
+END:
+    return value;
+}
+
+bool hash_table_contains(hash_table_t * table, void * key)
+{
+    return NULL != hash_table_lookup(table, key);
+}
+
+int hash_table_extract(hash_table_t * table,
+                       void *         key,
+                       void **        stored_key,
+                       void **        value)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == table) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = hash_table_extract_hashed(
+        table, key, table->hash_func(key), stored_key, value);
+
+END:
+    return exit_code;
+}
+
+int hash_table_extract_hashed(hash_table_t * table,
+                              void *         key,
+                              uint64_t       hash,
+                              void **        stored_key,
+                              void **        value)
+{
+    int            exit_code = E_FAILURE;
+    uint32_t       index     = 0;
+    hash_table_t * holder    = NULL;
+
+    if ((NULL == table) || (NULL == key))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (NULL != table->old)
+    {
+        table_migrate(table, HASH_TABLE_MIGRATE_STEP);
+    }
+    if (NULL != table->retired)
+    {
+        table_release(table, HASH_TABLE_RELEASE_STEP);
+    }
+    if (true == table->incremental)
+    {
+        table_prepare_spare(table);
+    }
+
+    holder = table;
+    index  = table_find(table, key, hash);
+    if ((TABLE_NOT_FOUND == index) && (NULL != table->old))
+    {
+        holder = table->old;
+        index  = table_find(holder, key, hash);
+    }
+
+    if (TABLE_NOT_FOUND == index)
+    {
+        goto END;
+    }
+
+    if (NULL != stored_key)
+    {
+        *stored_key = holder->slots[index].key;
+    }
+    if (NULL != value)
+    {
+        *value = holder->slots[index].value;
+    }
+    table_erase_at(holder, index);
+
+    // The new table kept room for every old entry; hand this one's back
+    if (holder != table)
+    {
+        table->size--;
+        table->growth_left++;
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int hash_table_remove(hash_table_t * table, void * key)
+{
+    int    exit_code  = E_FAILURE;
+    void * stored_key = NULL;
+    void * value      = NULL;
+
+    exit_code = hash_table_extract(table, key, &stored_key, &value);
+    if (E_SUCCESS != exit_code)
+    {
+        goto END;
+    }
+
+    if (NULL != table->key_free)
+    {
+        table->key_free(stored_key);
+    }
+    if (NULL != table->value_free)
+    {
+        table->value_free(value);
+    }
+
+END:
+    return exit_code;
+}
+
+int hash_table_foreach_call(hash_table_t * table,
+                            PAIR_ACT_F     action_function,
+                            void *         context)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == table) || (NULL == action_function))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (uint32_t idx = 0; idx < table->capacity; idx++)
+    {
+        if (0 <= table->ctrl[idx])
+        {
+            action_function(
+                table->slots[idx].key, table->slots[idx].value, context);
+        }
+    }
+
+    if (NULL != table->old)
+    {
+        exit_code
+            = hash_table_foreach_call(table->old, action_function, context);
+        goto END;
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int hash_table_size(hash_table_t * table)
+{
+    int size = -1;
+
+    if (NULL == table)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    size = (int)table->size;
+
+END:
+    return size;
+}
+
+int hash_table_clear(hash_table_t * table)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == table)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // The old table shares the free functions, so clearing it frees the
+    // entries not yet migrated
+    if (NULL != table->old)
+    {
+        hash_table_delete(&table->old);
+        table->migrate_pos = 0;
+    }
+
+    for (uint32_t idx = 0; idx < table->capacity; idx++)
+    {
+        if (0 > table->ctrl[idx])
+        {
+            continue;
+        }
+
+        if (NULL != table->key_free)
+        {
+            table->key_free(table->slots[idx].key);
+        }
+        if (NULL != table->value_free)
+        {
+            table->value_free(table->slots[idx].value);
+        }
+    }
+
+    if (0 < table->capacity)
+    {
+        memset(table->ctrl,
+               (uint8_t)CTRL_EMPTY,
+               table->capacity + HASH_TABLE_GROUP_WIDTH);
+    }
+    table->size        = 0;
+    table->growth_left = table_max_load(table->capacity);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int hash_table_destroy(hash_table_t * table)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == table)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = hash_table_clear(table);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to clear table.");
+        goto END;
+    }
+
+    if (NULL != table->retired)
+    {
+        table_release(table, UINT32_MAX);
+    }
+
+    free(table->ctrl);
+    free(table->slots);
+    free(table->spare_ctrl);
+    table->ctrl        = NULL;
+    table->slots       = NULL;
+    table->capacity    = 0;
+    table->growth_left = 0;
+    table->spare_ctrl  = NULL;
+    table->spare_size  = 0;
+    table->spare_ready = 0;
+
+END:
+    return exit_code;
+}
+
+int hash_table_delete(hash_table_t ** table_address)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == table_address) || (NULL == *table_address))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = hash_table_destroy(*table_address);
+    if (E_SUCCESS != exit_code)
+    {
+        goto END;
+    }
+
+    free(*table_address);
+    *table_address = NULL;
+
+END:
+    return exit_code;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+#if TABLE_SSE2
+
+static uint32_t group_match(const int8_t * group, int8_t tag)
+{
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)(const void *)group);
+
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl));
+}
+
+static uint32_t group_match_empty(const int8_t * group)
+{
+    return group_match(group, CTRL_EMPTY);
+}
+
+static uint32_t group_match_free(const int8_t * group)
+{
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)(const void *)group);
+
+    return (uint32_t)_mm_movemask_epi8(ctrl);
+}
+
+#else
+
+static uint32_t group_match(const int8_t * group, int8_t tag)
+{
+    uint32_t mask = 0;
+
+    for (uint32_t idx = 0; idx < HASH_TABLE_GROUP_WIDTH; idx++)
+    {
+        mask |= (uint32_t)(group[idx] == tag) << idx;
+    }
+
+    return mask;
+}
+
+static uint32_t group_match_empty(const int8_t * group)
+{
+    return group_match(group, CTRL_EMPTY);
+}
+
+static uint32_t group_match_free(const int8_t * group)
+{
+    uint32_t mask = 0;
+
+    for (uint32_t idx = 0; idx < HASH_TABLE_GROUP_WIDTH; idx++)
+    {
+        mask |= (uint32_t)(0 > group[idx]) << idx;
+    }
+
+    return mask;
+}
+
+#endif
+
+static void table_set_ctrl(hash_table_t * table, uint32_t index, int8_t ctrl)
+{
+    table->ctrl[index] = ctrl;
+    if (index < HASH_TABLE_GROUP_WIDTH - 1)
+    {
+        table->ctrl[table->capacity + index] = ctrl;
+    }
+}
+
+static uint32_t table_find(hash_table_t * table, void * key, uint64_t hash)
+{
+    uint32_t found  = TABLE_NOT_FOUND;
+    uint32_t mask   = table->capacity - 1;
+    uint32_t pos    = 0;
+    uint32_t stride = 0;
+    int8_t   tag    = (int8_t)(hash & CTRL_TAG_MASK);
+
+    if (0 == table->capacity)
+    {
+        goto END;
+    }
+
+    // Step by whole groups in a triangular sequence, which visits every
+    // group of a power of two table
+    pos = (uint32_t)(hash >> CTRL_TAG_BITS) & mask;
+    for (;;)
+    {
+        const int8_t * group   = &table->ctrl[pos];
+        uint32_t       matches = group_match(group, tag);
+
+        while (0 != matches)
+        {
+            uint32_t index = (pos + (uint32_t)__builtin_ctz(matches)) & mask;
+
+            if (EQUAL == table->compare_func(key, table->slots[index].key))
+            {
+                found = index;
+                goto END;
+            }
+            matches &= matches - 1;
+        }
+
+        // A probe for the key would have stopped at this empty slot
+        if (0 != group_match_empty(group))
+        {
+            goto END;
+        }
+
+        stride += HASH_TABLE_GROUP_WIDTH;
+        pos = (pos + stride) & mask;
+    }
+
+END:
+    return found;
+}
+
+static uint32_t table_find_free(hash_table_t * table, uint64_t hash)
+{
+    uint32_t mask      = table->capacity - 1;
+    uint32_t pos       = (uint32_t)(hash >> CTRL_TAG_BITS) & mask;
+    uint32_t stride    = 0;
+    uint32_t free_mask = group_match_free(&table->ctrl[pos]);
+
+    while (0 == free_mask)
+    {
+        stride += HASH_TABLE_GROUP_WIDTH;
+        pos       = (pos + stride) & mask;
+        free_mask = group_match_free(&table->ctrl[pos]);
+    }
+
+    return (pos + (uint32_t)__builtin_ctz(free_mask)) & mask;
+}
+
+static int table_resize(hash_table_t * table, uint32_t capacity)
+{
+    int                 exit_code    = E_FAILURE;
+    int8_t *            old_ctrl     = table->ctrl;
+    hash_table_slot_t * old_slots    = table->slots;
+    uint32_t            old_capacity = table->capacity;
+
+    if (E_SUCCESS != table_alloc(table, capacity))
+    {
+        goto END;
+    }
+
+    // The new table has no tombstones, so the first free slot is empty
+    for (uint32_t idx = 0; idx < old_capacity; idx++)
+    {
+        uint64_t hash  = 0;
+        uint32_t index = 0;
+
+        if (0 > old_ctrl[idx])
+        {
+            continue;
+        }
+
+        hash  = table->hash_func(old_slots[idx].key);
+        index = table_find_free(table, hash);
+        table_set_ctrl(table, index, old_ctrl[idx]);
+        table->slots[index] = old_slots[idx];
+    }
+
+    free(old_ctrl);
+    free(old_slots);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+static int table_begin_migration(hash_table_t * table, uint32_t capacity)
+{
+    int            exit_code = E_FAILURE;
+    hash_table_t * old       = NULL;
+
+    // Only reachable if updates outpaced the migration, which the half
+    // full start rules out; finishing it keeps one old table at a time
+    if (NULL != table->old)
+    {
+        table_migrate(table, UINT32_MAX);
+    }
+
+    old = malloc(sizeof(hash_table_t));
+    if (NULL == old)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    *old = *table;
+    if (E_SUCCESS != table_alloc(table, capacity))
+    {
+        free(old);
+        goto END;
+    }
+
+    // The spare and retired arrays stay with the table
+    old->incremental   = false;
+    old->spare_ctrl    = NULL;
+    old->spare_size    = 0;
+    old->spare_ready   = 0;
+    old->retired       = NULL;
+    table->old         = old;
+    table->migrate_pos = 0;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+static void table_migrate(hash_table_t * table, uint32_t count)
+{
+    hash_table_t * old = table->old;
+    uint32_t       end = old->capacity;
+
+    if (count < end - table->migrate_pos)
+    {
+        end = table->migrate_pos + count;
+    }
+
+    for (; table->migrate_pos < end; table->migrate_pos++)
+    {
+        uint32_t from  = table->migrate_pos;
+        uint64_t hash  = 0;
+        uint32_t index = 0;
+
+        if (0 > old->ctrl[from])
+        {
+            continue;
+        }
+
+        // Room for the entry was kept when the table was allocated, so a
+        // tombstone reused here gives that room back
+        hash  = table->hash_func(old->slots[from].key);
+        index = table_find_free(table, hash);
+        if (CTRL_DELETED == table->ctrl[index])
+        {
+            table->growth_left++;
+        }
+        table_set_ctrl(table, index, old->ctrl[from]);
+        table->slots[index] = old->slots[from];
+
+        table_set_ctrl(old, from, CTRL_DELETED);
+        old->size--;
+    }
+
+    if ((0 == old->size) || (old->capacity == table->migrate_pos))
+    {
+        if (NULL != table->retired)
+        {
+            table_release(table, UINT32_MAX);
+        }
+        table->retired     = old;
+        table->old         = NULL;
+        table->migrate_pos = 0;
+
+        if (false == table->incremental)
+        {
+            table_release(table, UINT32_MAX);
+        }
+    }
+}
+
+static void table_release(hash_table_t * table, uint32_t count)
+{
+    hash_table_t * retired = table->retired;
+    void *         shrunk  = NULL;
+
+    if (count < retired->capacity)
+    {
+        // Allocators shrink a block in place and hand the tail back, which
+        // costs time in proportion to the part released. A failed shrink
+        // leaves the block as it was
+        retired->capacity -= count;
+        shrunk = realloc(retired->slots,
+                         retired->capacity * sizeof(hash_table_slot_t));
+        if (NULL != shrunk)
+        {
+            retired->slots = shrunk;
+        }
+        shrunk = realloc(retired->ctrl, retired->capacity);
+        if (NULL != shrunk)
+        {
+            retired->ctrl = shrunk;
+        }
+        return;
+    }
+
+    free(retired->ctrl);
+    free(retired->slots);
+    free(retired);
+    table->retired = NULL;
+}
+
+static void table_prepare_spare(hash_table_t * table)
+{
+    size_t size  = table->capacity + (size_t)HASH_TABLE_GROUP_WIDTH;
+    size_t count = 0;
+
+    if (NULL == table->spare_ctrl)
+    {
+        // Sized for doubling; its start serves a rebuild at the same size
+        if (HASH_TABLE_MAX_CAPACITY > table->capacity)
+        {
+            size += table->capacity;
+        }
+
+        // growth_left drops by at most one per insert, so starting here
+        // leaves enough updates to set every byte before it runs out
+        if ((0 == table->capacity)
+            || (table->growth_left > (size / HASH_TABLE_SPARE_STEP) + 1))
+        {
+            return;
+        }
+
+        // On failure table_alloc() sets the bytes itself
+        table->spare_ctrl = malloc(size);
+        if (NULL == table->spare_ctrl)
+        {
+            return;
+        }
+        table->spare_size  = size;
+        table->spare_ready = 0;
+    }
+
+    count = table->spare_size - table->spare_ready;
+    if (HASH_TABLE_SPARE_STEP < count)
+    {
+        count = HASH_TABLE_SPARE_STEP;
+    }
+    memset(table->spare_ctrl + table->spare_ready, (uint8_t)CTRL_EMPTY, count);
+    table->spare_ready += count;
+}
+
+static int table_alloc(hash_table_t * table, uint32_t capacity)
+{
+    int                 exit_code = E_FAILURE;
+    int8_t *            new_ctrl  = NULL;
+    hash_table_slot_t * new_slots = NULL;
+    size_t              size      = capacity + (size_t)HASH_TABLE_GROUP_WIDTH;
+    size_t              ready     = 0;
+
+    if ((NULL != table->spare_ctrl) && (size <= table->spare_size))
+    {
+        new_ctrl = table->spare_ctrl;
+        ready    = table->spare_ready;
+    }
+    else
+    {
+        free(table->spare_ctrl);
+        new_ctrl = malloc(size);
+    }
+    table->spare_ctrl  = NULL;
+    table->spare_size  = 0;
+    table->spare_ready = 0;
+
+    new_slots = malloc(capacity * sizeof(hash_table_slot_t));
+    if ((NULL == new_ctrl) || (NULL == new_slots))
+    {
+        print_error("CMR failure.");
+        free(new_ctrl);
+        free(new_slots);
+        goto END;
+    }
+
+    // Nothing is left to set when incremental updates readied the spare
+    if (ready < size)
+    {
+        memset(new_ctrl + ready, (uint8_t)CTRL_EMPTY, size - ready);
+    }
+
+    table->ctrl        = new_ctrl;
+    table->slots       = new_slots;
+    table->capacity    = capacity;
+    table->growth_left = table_max_load(capacity) - table->size;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+static void table_erase_at(hash_table_t * table, uint32_t index)
+{
+    uint32_t mask         = table->capacity - 1;
+    uint32_t empty_after  = 0;
+    uint32_t empty_before = 0;
+    uint32_t full_run     = 0;
+
+    // Count the non-empty slots running forwards from the slot and backwards
+    // from the one before it. If together they are shorter than a group,
+    // every group covering the slot also holds an empty slot
+    empty_after  = group_match_empty(&table->ctrl[index]);
+    empty_before = group_match_empty(
+        &table->ctrl[(index - HASH_TABLE_GROUP_WIDTH) & mask]);
+    if ((0 != empty_after) && (0 != empty_before))
+    {
+        full_run = (uint32_t)__builtin_ctz(empty_after)
+                   + ((uint32_t)__builtin_clz(empty_before)
+                      - (32 - HASH_TABLE_GROUP_WIDTH));
+    }
+
+    if ((0 != empty_after) && (0 != empty_before)
+        && (HASH_TABLE_GROUP_WIDTH > full_run))
+    {
+        table_set_ctrl(table, index, CTRL_EMPTY);
+        table->growth_left++;
+    }
+    else
+    {
+        table_set_ctrl(table, index, CTRL_DELETED);
+    }
+
+    table->slots[index].key   = NULL;
+    table->slots[index].value = NULL;
+    table->size--;
+}
+
+static uint32_t table_max_load(uint32_t capacity)
+{
+    return capacity - (capacity / 8);
+}
+
+/*** end of file ***/
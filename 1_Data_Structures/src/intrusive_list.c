@@ -0,0 +1,549 @@
+#include "intrusive_list.h"
+#include "utilities.h"
+
+/**
+ * @brief Returns the link embedded in an object.
+ *
+ * @param list Pointer to the list.
+ * @param object Pointer to the object.
+ * @return Pointer to the object's link.
+ */
+static list_link_t * ilist_link_of(ilist_t * list, void * object);
+
+/**
+ * @brief Returns the object a link is embedded in.
+ *
+ * @param list Pointer to the list.
+ * @param link Pointer to the link, may be NULL.
+ * @return Pointer to the object, NULL if the link is NULL.
+ */
+static void * ilist_object_of(ilist_t * list, list_link_t * link);
+
+/**
+ * @brief Links a new link between two neighbours, either of which may be NULL
+ * at the ends of the list.
+ *
+ * @param list Pointer to the list.
+ * @param prev Link that will come before the new one.
+ * @param next Link that will come after the new one.
+ * @param link Link to insert.
+ */
+static void ilist_link_between(ilist_t *     list,
+                               list_link_t * prev,
+                               list_link_t * next,
+                               list_link_t * link);
+
+/**
+ * @brief Unlinks a link from the list and clears its pointers.
+ *
+ * @param list Pointer to the list.
+ * @param link Link to unlink.
+ */
+static void ilist_detach(ilist_t * list, list_link_t * link);
+
+ilist_t * ilist_new(size_t link_offset, FREE_F free_func, CMP_F comp_func)
+{
+    ilist_t * new_list = NULL;
+
+    if (NULL == comp_func)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    new_list = calloc(1, sizeof(ilist_t));
+    if (NULL == new_list)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    new_list->size         = 0;
+    new_list->head         = NULL;
+    new_list->tail         = NULL;
+    new_list->link_offset  = link_offset;
+    new_list->custom_free  = free_func;
+    new_list->compare_func = comp_func;
+
+END:
+    return new_list;
+}
+
+int ilist_push_head(ilist_t * list, void * object)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list) || (NULL == object))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    ilist_link_between(list, NULL, list->head, ilist_link_of(list, object));
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int ilist_push_tail(ilist_t * list, void * object)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list) || (NULL == object))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    ilist_link_between(list, list->tail, NULL, ilist_link_of(list, object));
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int ilist_insert_after(ilist_t * list, void * position, void * object)
+{
+    int           exit_code = E_FAILURE;
+    list_link_t * prev      = NULL;
+
+    if ((NULL == list) || (NULL == position) || (NULL == object))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    prev = ilist_link_of(list, position);
+    ilist_link_between(list, prev, prev->next, ilist_link_of(list, object));
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * ilist_pop_head(ilist_t * list)
+{
+    void * object = NULL;
+
+    if ((NULL == list) || (NULL == list->head))
+    {
+        print_error("List is empty.");
+        goto END;
+    }
+
+    object = ilist_object_of(list, list->head);
+    ilist_detach(list, list->head);
+
+END:
+    return object;
+}
+
+void * ilist_pop_tail(ilist_t * list)
+{
+    void * object = NULL;
+
+    if ((NULL == list) || (NULL == list->tail))
+    {
+        print_error("List is empty.");
+        goto END;
+    }
+
+    object = ilist_object_of(list, list->tail);
+    ilist_detach(list, list->tail);
+
+END:
+    return object;
+}
+
+void * ilist_peek_head(ilist_t * list)
+{
+    void * object = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    object = ilist_object_of(list, list->head);
+
+END:
+    return object;
+}
+
+void * ilist_peek_tail(ilist_t * list)
+{
+    void * object = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    object = ilist_object_of(list, list->tail);
+
+END:
+    return object;
+}
+
+void * ilist_next(ilist_t * list, void * object)
+{
+    void * next = NULL;
+
+    if ((NULL == list) || (NULL == object))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    next = ilist_object_of(list, ilist_link_of(list, object)->next);
+
+END:
+    return next;
+}
+
+void * ilist_prev(ilist_t * list, void * object)
+{
+    void * prev = NULL;
+
+    if ((NULL == list) || (NULL == object))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    prev = ilist_object_of(list, ilist_link_of(list, object)->prev);
+
+END:
+    return prev;
+}
+
+int ilist_unlink(ilist_t * list, void * object)
+{
+    int           exit_code = E_FAILURE;
+    list_link_t * link      = NULL;
+
+    if ((NULL == list) || (NULL == object))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 == list->size)
+    {
+        print_error("List is empty.");
+        goto END;
+    }
+
+    // A link with no neighbour on one side must be the list's end on that
+    // side. Unlinked and never pushed objects have no neighbours at all
+    link = ilist_link_of(list, object);
+    if (((NULL == link->prev) && (list->head != link))
+        || ((NULL == link->next) && (list->tail != link)))
+    {
+        print_error("Object is not in the list.");
+        goto END;
+    }
+
+    ilist_detach(list, link);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int ilist_remove(ilist_t * list, void * object)
+{
+    int exit_code = E_FAILURE;
+
+    exit_code = ilist_unlink(list, object);
+    if (E_SUCCESS != exit_code)
+    {
+        goto END;
+    }
+
+    if (NULL != list->custom_free)
+    {
+        list->custom_free(object);
+    }
+
+END:
+    return exit_code;
+}
+
+int ilist_foreach_call(ilist_t * list, ACT_F action_function)
+{
+    int           exit_code    = E_FAILURE;
+    list_link_t * current_link = NULL;
+    list_link_t * next_link    = NULL;
+
+    if ((NULL == list) || (NULL == action_function))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // Read ahead so the action may unlink or free the current object
+    for (current_link = list->head; NULL != current_link;
+         current_link = next_link)
+    {
+        next_link = current_link->next;
+        action_function(ilist_object_of(list, current_link));
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * ilist_find_first_occurrence(ilist_t * list, void * search_data)
+{
+    void *        found_object = NULL;
+    list_link_t * current_link = NULL;
+
+    if ((NULL == list) || (NULL == search_data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (current_link = list->head; NULL != current_link;
+         current_link = current_link->next)
+    {
+        void * object = ilist_object_of(list, current_link);
+
+        if (EQUAL == list->compare_func(search_data, object))
+        {
+            found_object = object;
+            break;
+        }
+    }
+
+END:
+    return found_object;
+}
+
+int ilist_sort(ilist_t * list)
+{
+    int           exit_code = E_FAILURE;
+    list_link_t * head      = NULL;
+    list_link_t * tail      = NULL;
+    list_link_t * left      = NULL;
+    list_link_t * right     = NULL;
+    list_link_t * taken     = NULL;
+    uint32_t      merges    = 0;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (2 > list->size)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    // Merge runs of width 1, 2, 4, ... until a pass needs a single merge
+    head = list->head;
+    for (uint32_t width = 1;; width *= 2)
+    {
+        left   = head;
+        head   = NULL;
+        tail   = NULL;
+        merges = 0;
+
+        while (NULL != left)
+        {
+            uint32_t left_size  = 0;
+            uint32_t right_size = width;
+
+            merges++;
+            right = left;
+            while ((left_size < width) && (NULL != right))
+            {
+                left_size++;
+                right = right->next;
+            }
+
+            while ((0 < left_size) || ((0 < right_size) && (NULL != right)))
+            {
+                // Ties take from the left run, which keeps the sort stable
+                if ((0 == left_size)
+                    || ((0 < right_size) && (NULL != right)
+                        && (LESS_THAN
+                            == list->compare_func(
+                                ilist_object_of(list, right),
+                                ilist_object_of(list, left)))))
+                {
+                    taken = right;
+                    right = right->next;
+                    right_size--;
+                }
+                else
+                {
+                    taken = left;
+                    left  = left->next;
+                    left_size--;
+                }
+
+                taken->prev = tail;
+                if (NULL == tail)
+                {
+                    head = taken;
+                }
+                else
+                {
+                    tail->next = taken;
+                }
+                tail = taken;
+            }
+
+            left = right;
+        }
+
+        tail->next = NULL;
+        if (1 >= merges)
+        {
+            break;
+        }
+    }
+
+    list->head = head;
+    list->tail = tail;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int ilist_clear(ilist_t * list)
+{
+    int           exit_code    = E_FAILURE;
+    list_link_t * current_link = NULL;
+    list_link_t * next_link    = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (current_link = list->head; NULL != current_link;
+         current_link = next_link)
+    {
+        next_link          = current_link->next;
+        current_link->prev = NULL;
+        current_link->next = NULL;
+
+        if (NULL != list->custom_free)
+        {
+            list->custom_free(ilist_object_of(list, current_link));
+        }
+    }
+
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int ilist_delete(ilist_t ** list_address)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list_address) || (NULL == *list_address))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = ilist_clear(*list_address);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to clear list.");
+        goto END;
+    }
+
+    free(*list_address);
+    *list_address = NULL;
+
+END:
+    return exit_code;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static list_link_t * ilist_link_of(ilist_t * list, void * object)
+{
+    return (list_link_t *)(void *)((char *)object + list->link_offset);
+}
+
+static void * ilist_object_of(ilist_t * list, list_link_t * link)
+{
+    return (NULL == link) ? NULL : (char *)link - list->link_offset;
+}
+
+static void ilist_link_between(ilist_t *     list,
+                               list_link_t * prev,
+                               list_link_t * next,
+                               list_link_t * link)
+{
+    link->prev = prev;
+    link->next = next;
+
+    if (NULL == prev)
+    {
+        list->head = link;
+    }
+    else
+    {
+        prev->next = link;
+    }
+
+    if (NULL == next)
+    {
+        list->tail = link;
+    }
+    else
+    {
+        next->prev = link;
+    }
+
+    list->size++;
+}
+
+static void ilist_detach(ilist_t * list, list_link_t * link)
+{
+    if (NULL == link->prev)
+    {
+        list->head = link->next;
+    }
+    else
+    {
+        link->prev->next = link->next;
+    }
+
+    if (NULL == link->next)
+    {
+        list->tail = link->prev;
+    }
+    else
+    {
+        link->next->prev = link->prev;
+    }
+
+    link->prev = NULL;
+    link->next = NULL;
+    list->size--;
+}
+
+/*** end of file ***/
@@ -1,65 +1,239 @@
+#include <string.h> // memset()
+
 #include "linked_list.h"
 #include "comparisons.h"
 #include "utilities.h"
 
+#define LIST_SORT_MAX_RUNS 34 // Pending runs never exceed log2(size) + 2
+
+/**
+ * @brief A sorted run of nodes waiting to be merged by list_sort().
+ *
+ * @param head first node of the run, linked through `next` only
+ * @param length number of nodes in the run
+ */
+typedef struct sort_run
+{
+    list_node_t * head;
+    uint32_t      length;
+} sort_run_t;
+
+/**
+ * @brief A block of nodes allocated at once by a node pool.
+ *
+ * @param next next slab in the pool's chain
+ * @param nodes the nodes carved from the slab
+ */
+typedef struct list_node_slab
+{
+    struct list_node_slab * next;
+    list_node_t             nodes[];
+} list_node_slab_t;
+
+/**
+ * @brief One slot of a hash index. Empty slots have a NULL node.
+ *
+ * @param hash hash of the node's data
+ * @param node node holding the data
+ */
+typedef struct list_index_slot
+{
+    uint64_t      hash;
+    list_node_t * node;
+} list_index_slot_t;
+
+/**
+ * @brief An open addressing hash table from values to the nodes holding
+ * them. Collisions are resolved by linear probing and removals shift later
+ * entries back, so no tombstones build up.
+ *
+ * @param slots table of slots, a power of two long
+ * @param capacity number of slots
+ * @param count number of slots in use
+ * @param hash_func function hashing the list's data
+ */
+typedef struct list_index
+{
+    list_index_slot_t * slots;
+    uint32_t            capacity;
+    uint32_t            count;
+    HASH_F              hash_func;
+} list_index_t;
+
 /**
- * @brief Create a new `list_node_t`
+ * @brief Create a new `list_node_t`, taking it from the list's pool if it has
+ * one
  *
+ * @param list The list the node is for
  * @param data The data to store in the node
  * @return list_node_t*
  */
-static list_node_t * list_node_new(void * data);
+static list_node_t * list_node_new(list_t * list, void * data);
 
 /**
- * @brief Finds a node in the linked list that matches the given data.
+ * @brief Returns a node to the list's pool, or frees it if the list has none.
+ *
+ * @param list The list the node belonged to
+ * @param node The node to release
+ */
+static void list_node_free(list_t * list, list_node_t * node);
+
+/**
+ * @brief Takes a node off the pool's free list, allocating a new slab when
+ * the free list is empty.
+ *
+ * @param pool Pointer to the pool.
+ * @return Pointer to an uninitialized node, or NULL on failure.
+ */
+static list_node_t * pool_take(list_node_pool_t * pool);
+
+/**
+ * @brief Frees every slab of a pool at once and empties its free list.
+ *
+ * @param pool Pointer to the pool.
+ */
+static void pool_release_slabs(list_node_pool_t * pool);
+
+/**
+ * @brief Splits the next natural run off a singly linked chain of nodes. A
+ * strictly descending run is reversed, which keeps the sort stable.
+ *
+ * @param compare_func Comparison function of the list.
+ * @param remaining Chain to take the run from, advanced past the run.
+ * @param length Receives the number of nodes in the run.
+ * @return Head of the run, terminated by a NULL next pointer.
+ */
+static list_node_t * take_run(CMP_F          compare_func,
+                              list_node_t ** remaining,
+                              uint32_t *     length);
+
+/**
+ * @brief Merges a run into the run before it. Ties take the node from the
+ * left run, which keeps the sort stable.
+ *
+ * @param compare_func Comparison function of the list.
+ * @param left Earlier run, which receives the merged result.
+ * @param right Later run.
+ */
+static void merge_runs(CMP_F        compare_func,
+                       sort_run_t * left,
+                       sort_run_t * right);
+
+/**
+ * @brief Returns the node at a position, walking from the head, the tail or
+ * the cached finger, whichever is closest. The finger is then left on the
+ * returned node.
  *
  * @param list Pointer to the linked list.
- * @param data Pointer to the data to be matched.
- * @return Pointer to the node containing the data if found, NULL otherwise.
+ * @param position Position of the node, less than the list size.
+ * @return Pointer to the node at the position.
  */
-static list_node_t * find_node(list_t * list, void * data);
+static list_node_t * locate_node(list_t * list, uint32_t position);
 
 /**
- * @brief Removes a given node from the linked list.
+ * @brief Links a chain of nodes into the list in front of another node. The
+ * finger survives an append at the tail and is dropped otherwise.
  *
- * This function updates the linked list to exclude the given node, freeing
- * the memory associated with the node and decrementing the list size.
+ * @param list Pointer to the linked list.
+ * @param next Node to insert in front of, or NULL to insert at the tail.
+ * @param first First node of the chain.
+ * @param last Last node of the chain, reached from `first` by `next` links.
+ * @param count Number of nodes in the chain, added to the list size.
+ */
+static void link_before(list_t *      list,
+                        list_node_t * next,
+                        list_node_t * first,
+                        list_node_t * last,
+                        uint32_t      count);
+
+/**
+ * @brief Unlinks a chain of nodes from the list, leaving the chain's outer
+ * links NULL. The finger is left to the caller.
  *
  * @param list Pointer to the linked list.
- * @param node Pointer to the node to be removed.
+ * @param first First node of the chain.
+ * @param last Last node of the chain.
+ * @param count Number of nodes in the chain, taken off the list size.
  */
-static void remove_node(list_t * list, list_node_t * node);
+static void unlink_range(list_t *      list,
+                         list_node_t * first,
+                         list_node_t * last,
+                         uint32_t      count);
+
+/**
+ * @brief Counts the nodes from `first` to `last`. The range and the nodes
+ * around it are walked in step, so the cost is the length of the range or of
+ * the rest of the list, whichever is shorter.
+ *
+ * @param list Pointer to the linked list.
+ * @param first First node of the range.
+ * @param last Last node of the range.
+ * @return Number of nodes in the range.
+ */
+static uint32_t count_range(list_t *      list,
+                            list_node_t * first,
+                            list_node_t * last);
+
+/**
+ * @brief Makes room in the list's index, if it has one, for a number of
+ * entries, rehashing it into a larger table when it would pass three
+ * quarters full.
+ *
+ * @param list Pointer to the linked list.
+ * @param count Number of entries the index must hold.
+ * @return 0 on success, non-zero value on failure.
+ */
+static int index_reserve(list_t * list, uint32_t count);
+
+/**
+ * @brief Adds a node to the list's index, if it has one.
+ *
+ * @param list Pointer to the linked list.
+ * @param node Node to add, not yet in the index.
+ * @return 0 on success, non-zero value on failure.
+ */
+static int index_add(list_t * list, list_node_t * node);
+
+/**
+ * @brief Removes a node from the list's index, if it has one.
+ *
+ * @param list Pointer to the linked list.
+ * @param node Node to remove, whose data must be unchanged since it was
+ * added.
+ */
+static void index_drop(list_t * list, list_node_t * node);
 
 /**
- * @brief Splits a list into two equal halves
+ * @brief Looks a value up in the list's index.
  *
- * @param head Pointer to the head of the list to be split.
- * @param first_half Pointer to store the head of the first half.
- * @param second_half Pointer to store the head of the second half.
+ * @param index Pointer to the index.
+ * @param compare_func Comparison function of the list.
+ * @param data Pointer to the data to be matched.
+ * @return Pointer to a node holding equal data, NULL if there is none.
  */
-static void split(list_node_t *  head,
-                  list_node_t ** first_half,
-                  list_node_t ** second_half);
+static list_node_t * index_find(list_index_t * index,
+                                CMP_F          compare_func,
+                                void *         data);
 
 /**
- * @brief Merges two sorted linked lists into a single sorted linked list.
+ * @brief Finds a node in the linked list that matches the given data.
  *
- * @param first Pointer to the head of the first sorted list.
- * @param second Pointer to the head of the second sorted list.
- * @param compare_func Pointer to the comparison function used to sort the list.
- * @return Pointer to the head of the merged sorted list.
+ * @param list Pointer to the linked list.
+ * @param data Pointer to the data to be matched.
+ * @return Pointer to the node containing the data if found, NULL otherwise.
  */
-static list_node_t * merge(list_node_t * first,
-                           list_node_t * second,
-                           CMP_F         compare_func);
+static list_node_t * find_node(list_t * list, void * data);
 
 /**
- * @brief Internal recursive function to implement merge sort on linked list.
+ * @brief Removes a given node from the linked list.
+ *
+ * This function updates the linked list to exclude the given node, freeing
+ * the memory associated with the node and decrementing the list size.
  *
- * @param head_ref Pointer to the head of the list to be sorted.
- * @param compare_func Pointer to the comparison function used to sort the list.
+ * @param list Pointer to the linked list.
+ * @param node Pointer to the node to be removed.
  */
-static void merge_sort(list_node_t ** head_ref, CMP_F compare_func);
+static void remove_node(list_t * list, list_node_t * node);
 
 list_t * list_new(FREE_F free_func, CMP_F comp_func)
 {
@@ -77,11 +251,167 @@ list_t * list_new(FREE_F free_func, CMP_F comp_func)
     new_list->tail         = NULL;
     new_list->custom_free  = (NULL == free_func) ? free : free_func;
     new_list->compare_func = (NULL == comp_func) ? int_comp : comp_func;
+    new_list->pool         = NULL;
+    new_list->owns_pool    = false;
+    new_list->finger       = NULL;
+    new_list->finger_index = 0;
+    new_list->index        = NULL;
+
+END:
+    return new_list;
+}
+
+list_t * list_new_pooled(FREE_F             free_func,
+                         CMP_F              comp_func,
+                         list_node_pool_t * pool)
+{
+    list_t * new_list = NULL;
+
+    new_list = list_new(free_func, comp_func);
+    if (NULL == new_list)
+    {
+        print_error("Unable to create new list.");
+        goto END;
+    }
+
+    new_list->pool      = pool;
+    new_list->owns_pool = (NULL == pool);
+    if (new_list->owns_pool)
+    {
+        new_list->pool = list_node_pool_new(0);
+        if (NULL == new_list->pool)
+        {
+            print_error("Unable to create node pool.");
+            free(new_list);
+            new_list = NULL;
+        }
+    }
 
 END:
     return new_list;
 }
 
+list_node_pool_t * list_node_pool_new(uint32_t slab_nodes)
+{
+    list_node_pool_t * new_pool = NULL;
+
+    new_pool = calloc(1, sizeof(list_node_pool_t));
+    if (NULL == new_pool)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    new_pool->free_nodes = NULL;
+    new_pool->slabs      = NULL;
+    new_pool->slab_nodes
+        = (0 == slab_nodes) ? LIST_POOL_DEFAULT_SLAB_NODES : slab_nodes;
+
+END:
+    return new_pool;
+}
+
+int list_node_pool_delete(list_node_pool_t ** pool_address)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == pool_address) || (NULL == *pool_address))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    pool_release_slabs(*pool_address);
+    free(*pool_address);
+    *pool_address = NULL;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int list_node_release(list_t * list, list_node_t * node)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list) || (NULL == node))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    list_node_free(list, node);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int list_enable_index(list_t * list, HASH_F hash_func)
+{
+    int            exit_code = E_FAILURE;
+    list_index_t * new_index = NULL;
+
+    if ((NULL == list) || (NULL == hash_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    new_index = calloc(1, sizeof(list_index_t));
+    if (NULL == new_index)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    new_index->slots     = NULL;
+    new_index->capacity  = 0;
+    new_index->count     = 0;
+    new_index->hash_func = hash_func;
+
+    list_disable_index(list);
+    list->index = new_index;
+
+    exit_code = index_reserve(list, list->size);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to build index.");
+        list_disable_index(list);
+        goto END;
+    }
+
+    for (list_node_t * node = list->head; NULL != node; node = node->next)
+    {
+        index_add(list, node);
+    }
+
+END:
+    return exit_code;
+}
+
+int list_disable_index(list_t * list)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (NULL != list->index)
+    {
+        free(list->index->slots);
+        free(list->index);
+        list->index = NULL;
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
 int list_push_head(list_t * list, void * data)
 {
     int           exit_code = E_FAILURE;
@@ -93,13 +423,20 @@ int list_push_head(list_t * list, void * data)
         goto END;
     }
 
-    new_node = list_node_new(data);
+    new_node = list_node_new(list, data);
     if (NULL == new_node)
     {
         print_error("Unable to create new node.");
         goto END;
     }
 
+    if (E_SUCCESS != index_add(list, new_node))
+    {
+        print_error("Unable to index new node.");
+        list_node_free(list, new_node);
+        goto END;
+    }
+
     if (NULL == list->head)
     {
         // Establish 'new_node' as the first node of an empty list
@@ -118,6 +455,7 @@ int list_push_head(list_t * list, void * data)
     }
 
     list->size += 1;
+    list->finger_index += 1; // Every node moved back by one
 
     exit_code = E_SUCCESS;
 END:
@@ -136,13 +474,20 @@ int list_push_tail(list_t * list, void * data)
         goto END;
     }
 
-    new_node = list_node_new(data);
+    new_node = list_node_new(list, data);
     if (NULL == new_node)
     {
         print_error("Unable to create new node.");
         goto END;
     }
 
+    if (E_SUCCESS != index_add(list, new_node))
+    {
+        print_error("Unable to index new node.");
+        list_node_free(list, new_node);
+        goto END;
+    }
+
     if (NULL == list->head)
     {
         // Establish 'new_node' as the first node of an empty list
@@ -179,7 +524,7 @@ int list_push_position(list_t * list, void * data, uint32_t position)
         goto END;
     }
 
-    if ((0 > position) || (position > list->size))
+    if (position > list->size)
     {
         print_error("Position out of bounds.");
         goto END;
@@ -191,34 +536,39 @@ int list_push_position(list_t * list, void * data, uint32_t position)
         exit_code = list_push_head(list, data);
         goto END;
     }
-    if (position == list->size - 1)
+    if (position == list->size)
     {
         exit_code = list_push_tail(list, data);
         goto END;
     }
 
-    new_node = list_node_new(data);
+    new_node = list_node_new(list, data);
     if (NULL == new_node)
     {
         print_error("Unable to create new node.");
         goto END;
     }
 
-    // Navigate to the specified position
-    current_node = list->head;
-    for (uint32_t idx = 0; idx < position - 1; idx++)
+    if (E_SUCCESS != index_add(list, new_node))
     {
-        current_node = current_node->next;
+        print_error("Unable to index new node.");
+        list_node_free(list, new_node);
+        goto END;
     }
 
-    // Insert the new node at the specified position
-    new_node->next           = current_node->next;
-    new_node->prev           = current_node;
-    current_node->next->prev = new_node;
-    current_node->next       = new_node;
+    // Insert the new node in front of the one currently at 'position'
+    current_node             = locate_node(list, position);
+    new_node->next           = current_node;
+    new_node->prev           = current_node->prev;
+    current_node->prev->next = new_node;
+    current_node->prev       = new_node;
 
     list->size += 1;
 
+    // The new node now sits at 'position', ahead of any later access
+    list->finger       = new_node;
+    list->finger_index = position;
+
     exit_code = E_SUCCESS;
 END:
     return exit_code;
@@ -254,6 +604,17 @@ list_node_t * list_pop_head(list_t * list)
     }
 
     head_node = list->head;
+    index_drop(list, head_node);
+
+    // Every remaining node moves up by one
+    if (list->finger == head_node)
+    {
+        list->finger = NULL;
+    }
+    else
+    {
+        list->finger_index -= 1;
+    }
 
     if (list->head == list->tail)
     {
@@ -283,6 +644,12 @@ list_node_t * list_pop_tail(list_t * list)
     }
 
     tail_node = list->tail;
+    index_drop(list, tail_node);
+
+    if (list->finger == tail_node)
+    {
+        list->finger = NULL;
+    }
 
     if (list->head == list->tail)
     {
@@ -312,7 +679,7 @@ list_node_t * list_pop_position(list_t * list, uint32_t position)
         goto END;
     }
 
-    if ((0 > position) || (position >= list->size))
+    if (position >= list->size)
     {
         print_error("Position out of bounds.");
         goto END;
@@ -330,18 +697,16 @@ list_node_t * list_pop_position(list_t * list, uint32_t position)
         goto END;
     }
 
-    current = list->head;
-    for (uint32_t idx = 0; idx < position; idx++)
-    {
-        current = current->next;
-    }
+    current = locate_node(list, position);
+    index_drop(list, current);
 
     node_to_pop         = current;
     current->prev->next = current->next;
-    if (NULL != current->next)
-    {
-        current->next->prev = current->prev;
-    }
+    current->next->prev = current->prev;
+
+    // The node after it moves up into 'position'
+    list->finger       = current->next;
+    list->finger_index = position;
 
     node_to_pop->prev = NULL;
     node_to_pop->next = NULL;
@@ -366,7 +731,7 @@ int list_remove_head(list_t * list)
     node_to_remove = list_pop_head(list);
     list->custom_free(node_to_remove->data);
     node_to_remove->data = NULL;
-    free(node_to_remove);
+    list_node_free(list, node_to_remove);
     node_to_remove = NULL;
 
     exit_code = E_SUCCESS;
@@ -388,7 +753,7 @@ int list_remove_tail(list_t * list)
     node_to_remove = list_pop_tail(list);
     list->custom_free(node_to_remove->data);
     node_to_remove->data = NULL;
-    free(node_to_remove);
+    list_node_free(list, node_to_remove);
     node_to_remove = NULL;
 
     exit_code = E_SUCCESS;
@@ -407,7 +772,7 @@ int list_remove_position(list_t * list, uint32_t position)
         goto END;
     }
 
-    if ((0 > position) || (position >= list->size))
+    if (position >= list->size)
     {
         print_error("Position out of bounds.");
         goto END;
@@ -416,7 +781,7 @@ int list_remove_position(list_t * list, uint32_t position)
     node_to_remove = list_pop_position(list, position);
     list->custom_free(node_to_remove->data);
     node_to_remove->data = NULL;
-    free(node_to_remove);
+    list_node_free(list, node_to_remove);
     node_to_remove = NULL;
 
     exit_code = E_SUCCESS;
@@ -466,17 +831,13 @@ list_node_t * list_peek_position(list_t * list, uint32_t position)
         goto END;
     }
 
-    if ((0 > position) || (position >= list->size))
+    if (position >= list->size)
     {
         print_error("Position out of bounds.");
         goto END;
     }
 
-    current_node = list->head;
-    for (uint32_t idx = 0; idx < position; idx++)
-    {
-        current_node = current_node->next;
-    }
+    current_node = locate_node(list, position);
 
 END:
     return current_node;
@@ -532,25 +893,14 @@ list_node_t * list_find_first_occurrence(list_t * list, void ** search_data)
 {
     list_node_t * current_node = NULL;
 
-    if (NULL == list)
+    if ((NULL == list) || (NULL == search_data) || (NULL == *search_data))
     {
         print_error("NULL argument passed.");
         goto END;
     }
 
-    current_node = list->head;
-
-    for (size_t idx = 0; idx < list->size; idx++)
-    {
-        if (ERROR != (list->compare_func(search_data, current_node)))
-        {
-            goto END;
-        }
-
-        current_node = current_node->next;
-    }
+    current_node = find_node(list, *search_data);
 
-    current_node = NULL; // Set back to NULL if no match was found
 END:
     return current_node;
 }
@@ -561,7 +911,7 @@ list_t * list_find_all_occurrences(list_t * list, void ** search_data)
     list_node_t * current_node = NULL;
     int           check        = E_FAILURE;
 
-    if (NULL == list)
+    if ((NULL == list) || (NULL == search_data) || (NULL == *search_data))
     {
         print_error("NULL argument passed.");
         goto END;
@@ -585,9 +935,9 @@ list_t * list_find_all_occurrences(list_t * list, void ** search_data)
     // Iterate over the whole list and store any matches in 'new_list'
     for (size_t idx = 0; idx < list->size; idx++)
     {
-        if (ERROR != (list->compare_func(search_data, current_node)))
+        if (EQUAL == list->compare_func(*search_data, current_node->data))
         {
-            check = list_push_head(new_list, current_node->data);
+            check = list_push_tail(new_list, current_node->data);
             if (E_SUCCESS != check)
             {
                 print_error("Unable to push node into list.");
@@ -595,58 +945,491 @@ list_t * list_find_all_occurrences(list_t * list, void ** search_data)
                 goto END;
             }
         }
+        current_node = current_node->next;
     }
 
 END:
     return new_list;
 }
 
-int list_sort(list_t * list)
+int list_move_to_front(list_t * list, void ** search_data)
 {
-    int exit_code = E_FAILURE;
+    int           exit_code = E_FAILURE;
+    list_node_t * node      = NULL;
 
-    if (NULL != list)
+    if ((NULL == list) || (NULL == search_data) || (NULL == *search_data))
     {
-        merge_sort(&(list->head), list->compare_func);
-        exit_code = E_SUCCESS;
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    node = find_node(list, *search_data);
+    if (NULL == node)
+    {
+        print_error("Data not found.");
+        goto END;
+    }
+
+    if (node != list->head)
+    {
+        unlink_range(list, node, node, 0);
+        link_before(list, list->head, node, node, 0);
     }
 
+    exit_code = E_SUCCESS;
+END:
     return exit_code;
 }
 
-int list_clear(list_t * list)
+void * list_cursor_begin(list_t * list, list_cursor_t * cursor)
 {
-    int           exit_code    = E_FAILURE;
-    list_node_t * current_node = NULL;
-    list_node_t * next_node    = NULL;
+    void * data = NULL;
 
-    if (NULL == list)
+    if ((NULL == list) || (NULL == cursor))
     {
         print_error("NULL argument passed.");
         goto END;
     }
 
-    current_node = list->head;
-    if (NULL == current_node)
-    {
-        print_error("Empty list.");
+    cursor->list = list;
+    cursor->node = list->head;
+    data         = list_cursor_get(cursor);
+
+END:
+    return data;
+}
+
+void * list_cursor_end(list_t * list, list_cursor_t * cursor)
+{
+    void * data = NULL;
+
+    if ((NULL == list) || (NULL == cursor))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    cursor->list = list;
+    cursor->node = list->tail;
+    data         = list_cursor_get(cursor);
+
+END:
+    return data;
+}
+
+void * list_cursor_next(list_cursor_t * cursor)
+{
+    void * data = NULL;
+
+    if ((NULL == cursor) || (NULL == cursor->node))
+    {
+        goto END;
+    }
+
+    cursor->node = cursor->node->next;
+    data         = list_cursor_get(cursor);
+
+END:
+    return data;
+}
+
+void * list_cursor_prev(list_cursor_t * cursor)
+{
+    void * data = NULL;
+
+    if ((NULL == cursor) || (NULL == cursor->node))
+    {
+        goto END;
+    }
+
+    cursor->node = cursor->node->prev;
+    data         = list_cursor_get(cursor);
+
+END:
+    return data;
+}
+
+void * list_cursor_get(list_cursor_t * cursor)
+{
+    void * data = NULL;
+
+    if ((NULL != cursor) && (NULL != cursor->node))
+    {
+        data = cursor->node->data;
+    }
+
+    return data;
+}
+
+int list_cursor_insert_before(list_cursor_t * cursor, void * data)
+{
+    int           exit_code = E_FAILURE;
+    list_node_t * new_node  = NULL;
+
+    if ((NULL == cursor) || (NULL == cursor->list) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    new_node = list_node_new(cursor->list, data);
+    if (NULL == new_node)
+    {
+        print_error("Unable to create new node.");
+        goto END;
+    }
+
+    if (E_SUCCESS != index_add(cursor->list, new_node))
+    {
+        print_error("Unable to index new node.");
+        list_node_free(cursor->list, new_node);
+        goto END;
+    }
+
+    link_before(cursor->list, cursor->node, new_node, new_node, 1);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int list_cursor_insert_after(list_cursor_t * cursor, void * data)
+{
+    int           exit_code = E_FAILURE;
+    list_node_t * new_node  = NULL;
+
+    if ((NULL == cursor) || (NULL == cursor->list) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (NULL == cursor->node)
+    {
+        print_error("Cursor is past the end of the list.");
+        goto END;
+    }
+
+    new_node = list_node_new(cursor->list, data);
+    if (NULL == new_node)
+    {
+        print_error("Unable to create new node.");
+        goto END;
+    }
+
+    if (E_SUCCESS != index_add(cursor->list, new_node))
+    {
+        print_error("Unable to index new node.");
+        list_node_free(cursor->list, new_node);
+        goto END;
+    }
+
+    link_before(cursor->list, cursor->node->next, new_node, new_node, 1);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int list_cursor_erase(list_cursor_t * cursor)
+{
+    int           exit_code = E_FAILURE;
+    list_node_t * next_node = NULL;
+
+    if ((NULL == cursor) || (NULL == cursor->list))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (NULL == cursor->node)
+    {
+        print_error("Cursor is past the end of the list.");
+        goto END;
+    }
+
+    next_node = cursor->node->next;
+    remove_node(cursor->list, cursor->node);
+    cursor->node = next_node;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int list_remove_if(list_t * list, PRED_F predicate, void * context)
+{
+    int           removed = -1;
+    list_cursor_t cursor  = { 0 };
+    void *        data    = NULL;
+
+    if ((NULL == list) || (NULL == predicate))
+    {
+        print_error("NULL argument passed.");
         goto END;
     }
 
+    removed = 0;
+    data    = list_cursor_begin(list, &cursor);
+    while (NULL != data)
+    {
+        if (predicate(data, context))
+        {
+            list_cursor_erase(&cursor);
+            data = list_cursor_get(&cursor);
+            removed++;
+        }
+        else
+        {
+            data = list_cursor_next(&cursor);
+        }
+    }
+
+END:
+    return removed;
+}
+
+int list_concat(list_t * dst, list_t * src)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == dst) || (NULL == src))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 == src->size)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    exit_code = list_splice(dst, NULL, src, src->head, src->tail);
+
+END:
+    return exit_code;
+}
+
+int list_splice(list_t *      dst,
+                list_node_t * position,
+                list_t *      src,
+                list_node_t * first,
+                list_node_t * last)
+{
+    int      exit_code = E_FAILURE;
+    uint32_t count     = 0;
+
+    if ((NULL == dst) || (NULL == src) || (NULL == first) || (NULL == last))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // Released nodes go back to the list's pool, so they cannot change pools
+    if (dst->pool != src->pool)
+    {
+        print_error("Lists use different node pools.");
+        goto END;
+    }
+
+    // A pool owned by one list dies with it, or is emptied wholesale by
+    // list_clear(), so its nodes can never move to another list
+    if ((dst != src) && (dst->owns_pool || src->owns_pool))
+    {
+        print_error("List owns its node pool.");
+        goto END;
+    }
+
+    if ((position == first) || (position == last))
+    {
+        print_error("Position is inside the range.");
+        goto END;
+    }
+
+    // A move within one list leaves its size and index alone
+    if (dst != src)
+    {
+        count = count_range(src, first, last);
+
+        if (E_SUCCESS != index_reserve(dst, dst->size + count))
+        {
+            print_error("Unable to grow index.");
+            goto END;
+        }
+
+        if ((NULL != src->index) || (NULL != dst->index))
+        {
+            for (list_node_t * node = first; node != last->next;
+                 node = node->next)
+            {
+                index_drop(src, node);
+                index_add(dst, node);
+            }
+        }
+    }
+
+    unlink_range(src, first, last, count);
+    src->finger = NULL;
+    link_before(dst, position, first, last, count);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+list_t * list_split_at(list_t * list, list_node_t * node)
+{
+    list_t *      new_list = NULL;
+    list_node_t * tail     = NULL;
+    uint32_t      count    = 0;
+
+    if ((NULL == list) || (NULL == node))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (list->owns_pool)
+    {
+        print_error("List owns its node pool.");
+        goto END;
+    }
+
+    new_list = list_new(list->custom_free, list->compare_func);
+    if (NULL == new_list)
+    {
+        print_error("Unable to create new list.");
+        goto END;
+    }
+
+    new_list->pool = list->pool;
+
+    tail  = list->tail;
+    count = count_range(list, node, tail);
+    if (NULL != list->index)
+    {
+        for (list_node_t * moved = node; NULL != moved; moved = moved->next)
+        {
+            index_drop(list, moved);
+        }
+    }
+    unlink_range(list, node, tail, count);
+    if ((NULL != list->finger) && (list->finger_index >= list->size))
+    {
+        list->finger = NULL;
+    }
+    link_before(new_list, NULL, node, tail, count);
+
+END:
+    return new_list;
+}
+
+int list_sort(list_t * list)
+{
+    int           exit_code = E_FAILURE;
+    sort_run_t    runs[LIST_SORT_MAX_RUNS];
+    int           depth     = 0;
+    list_node_t * remaining = NULL;
+    list_node_t * previous  = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (2 > list->size)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    // Work on singly linked chains, the prev links are rebuilt at the end
+    remaining = list->head;
+    while (NULL != remaining)
+    {
+        runs[depth].head = take_run(list->compare_func,
+                                    &remaining,
+                                    &runs[depth].length);
+        depth++;
+
+        // Keep each run at least twice as long as the one above it, which
+        // bounds the stack depth by log2 of the list size
+        while ((1 < depth)
+               && (runs[depth - 2].length < 2 * runs[depth - 1].length))
+        {
+            merge_runs(list->compare_func, &runs[depth - 2], &runs[depth - 1]);
+            depth--;
+        }
+    }
+
+    while (1 < depth)
+    {
+        merge_runs(list->compare_func, &runs[depth - 2], &runs[depth - 1]);
+        depth--;
+    }
+
+    list->finger = NULL;
+    list->head   = runs[0].head;
+    for (list_node_t * node = list->head; NULL != node; node = node->next)
+    {
+        node->prev = previous;
+        previous   = node;
+    }
+    list->tail = previous;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int list_clear(list_t * list)
+{
+    int           exit_code    = E_FAILURE;
+    list_node_t * current_node = NULL;
+    list_node_t * next_node    = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    current_node = list->head;
     for (size_t idx = 0; idx < list->size; idx++)
     {
         next_node = current_node->next;
 
         list->custom_free(current_node->data);
         current_node->data = NULL;
-        free(current_node);
+
+        // A list's own pool is released below in one go
+        if (!list->owns_pool)
+        {
+            list_node_free(list, current_node);
+        }
         current_node = NULL;
         current_node = next_node;
     }
 
-    list->head = NULL;
-    list->tail = NULL;
-    list->size = 0;
+    if (list->owns_pool)
+    {
+        pool_release_slabs(list->pool);
+    }
+
+    list->head   = NULL;
+    list->tail   = NULL;
+    list->size   = 0;
+    list->finger = NULL;
+
+    if (NULL != list->index)
+    {
+        memset(list->index->slots,
+               0,
+               list->index->capacity * sizeof(list_index_slot_t));
+        list->index->count = 0;
+    }
 
     exit_code = E_SUCCESS;
 END:
@@ -670,6 +1453,13 @@ int list_delete(list_t ** list_address)
         goto END;
     }
 
+    if ((*list_address)->owns_pool)
+    {
+        list_node_pool_delete(&(*list_address)->pool);
+    }
+
+    list_disable_index(*list_address);
+
     free(*list_address);
     *list_address = NULL;
 
@@ -688,7 +1478,7 @@ void custom_free(void * mem_addr)
  * NOTE: STATIC FUNCTIONS LISTED BELOW
  ***********************************************************************/
 
-static list_node_t * list_node_new(void * data)
+static list_node_t * list_node_new(list_t * list, void * data)
 {
     list_node_t * new_node = NULL;
 
@@ -698,7 +1488,14 @@ static list_node_t * list_node_new(void * data)
         goto END;
     }
 
-    new_node = calloc(1, sizeof(list_node_t));
+    if (NULL != list->pool)
+    {
+        new_node = pool_take(list->pool);
+    }
+    else
+    {
+        new_node = calloc(1, sizeof(list_node_t));
+    }
     if (NULL == new_node)
     {
         print_error("CMR failure.");
@@ -713,148 +1510,519 @@ END:
     return new_node;
 }
 
-static list_node_t * find_node(list_t * list, void * data)
+static void list_node_free(list_t * list, list_node_t * node)
 {
-    list_node_t * current_node = NULL;
-
-    if ((NULL == list) || (NULL == data))
+    if (NULL == list->pool)
     {
-        print_error("Null argument passed.");
+        free(node);
         goto END;
     }
 
-    current_node = list->head;
-    while (NULL != current_node)
+    // Push the node onto the pool's free list
+    node->data             = NULL;
+    node->prev             = NULL;
+    node->next             = list->pool->free_nodes;
+    list->pool->free_nodes = node;
+
+END:
+    return;
+}
+
+static list_node_t * pool_take(list_node_pool_t * pool)
+{
+    list_node_t *      node = NULL;
+    list_node_slab_t * slab = NULL;
+
+    if (NULL == pool->free_nodes)
     {
-        if (EQUAL == list->compare_func(data, current_node->data))
+        slab = malloc(sizeof(list_node_slab_t)
+                      + ((size_t)pool->slab_nodes * sizeof(list_node_t)));
+        if (NULL == slab)
         {
-            // Success
             goto END;
         }
-        current_node = current_node->next;
+
+        slab->next  = pool->slabs;
+        pool->slabs = slab;
+
+        // Thread the new nodes onto the free list, lowest address first
+        for (uint32_t idx = pool->slab_nodes; 0 < idx; idx--)
+        {
+            slab->nodes[idx - 1].next = pool->free_nodes;
+            pool->free_nodes          = &slab->nodes[idx - 1];
+        }
     }
 
+    node             = pool->free_nodes;
+    pool->free_nodes = node->next;
+
 END:
-    return current_node;
+    return node;
 }
 
-static void remove_node(list_t * list, list_node_t * node)
+static void pool_release_slabs(list_node_pool_t * pool)
 {
-    if ((NULL == list) || (NULL == node))
+    list_node_slab_t * slab = pool->slabs;
+    list_node_slab_t * next = NULL;
+
+    while (NULL != slab)
     {
-        print_error("NULL argument passed.");
-        goto END;
+        next = slab->next;
+        free(slab);
+        slab = next;
     }
 
-    if (NULL != node->prev)
+    pool->slabs      = NULL;
+    pool->free_nodes = NULL;
+}
+
+static list_node_t * take_run(CMP_F          compare_func,
+                              list_node_t ** remaining,
+                              uint32_t *     length)
+{
+    list_node_t * head     = *remaining;
+    list_node_t * last     = head;
+    list_node_t * next     = head->next;
+    list_node_t * reversed = NULL;
+
+    *length = 1;
+    if ((NULL != next) && (LESS_THAN == compare_func(next->data, head->data)))
+    {
+        // Strictly descending, build the run back to front
+        head->next = NULL;
+        reversed   = head;
+        while ((NULL != next)
+               && (LESS_THAN == compare_func(next->data, reversed->data)))
+        {
+            list_node_t * following = next->next;
+
+            next->next = reversed;
+            reversed   = next;
+            next       = following;
+            (*length)++;
+        }
+        head = reversed;
+    }
+    else
     {
-        node->prev->next = node->next;
+        while ((NULL != next)
+               && (LESS_THAN != compare_func(next->data, last->data)))
+        {
+            last = next;
+            next = next->next;
+            (*length)++;
+        }
+        last->next = NULL;
+    }
+
+    *remaining = next;
+    return head;
+}
+
+static void merge_runs(CMP_F        compare_func,
+                       sort_run_t * left,
+                       sort_run_t * right)
+{
+    list_node_t   merged = { 0 };
+    list_node_t * tail   = &merged;
+    list_node_t * first  = left->head;
+    list_node_t * second = right->head;
+
+    while ((NULL != first) && (NULL != second))
+    {
+        if (LESS_THAN == compare_func(second->data, first->data))
+        {
+            tail->next = second;
+            second     = second->next;
+        }
+        else
+        {
+            tail->next = first;
+            first      = first->next;
+        }
+        tail = tail->next;
+    }
+    tail->next = (NULL != first) ? first : second;
+
+    left->head = merged.next;
+    left->length += right->length;
+}
+
+static list_node_t * locate_node(list_t * list, uint32_t position)
+{
+    list_node_t * node     = list->head;
+    uint32_t      index    = 0;
+    uint32_t      distance = position;
+
+    if (list->size - 1 - position < distance)
+    {
+        node     = list->tail;
+        index    = list->size - 1;
+        distance = index - position;
+    }
+
+    if ((NULL != list->finger)
+        && (((list->finger_index > position)
+                 ? list->finger_index - position
+                 : position - list->finger_index)
+            < distance))
+    {
+        node  = list->finger;
+        index = list->finger_index;
+    }
+
+    while (index < position)
+    {
+        node = node->next;
+        index++;
+    }
+    while (index > position)
+    {
+        node = node->prev;
+        index--;
+    }
+
+    list->finger       = node;
+    list->finger_index = position;
+
+    return node;
+}
+
+static void link_before(list_t *      list,
+                        list_node_t * next,
+                        list_node_t * first,
+                        list_node_t * last,
+                        uint32_t      count)
+{
+    last->next  = next;
+    first->prev = (NULL == next) ? list->tail : next->prev;
+
+    if (NULL == first->prev)
+    {
+        list->head = first;
     }
     else
     {
-        list->head = node->next;
+        first->prev->next = first;
     }
 
-    if (node->next != NULL)
+    if (NULL == next)
     {
-        node->next->prev = node->prev;
+        list->tail = last;
     }
     else
     {
-        list->tail = node->prev;
+        next->prev = last;
+
+        // The nodes after the chain have moved, so the finger cannot be kept
+        list->finger = NULL;
     }
 
-    list->custom_free(node->data);
-    node->data = NULL;
-    free(node);
-    node = NULL;
+    list->size += count;
+}
 
-    list->size--;
+static void unlink_range(list_t *      list,
+                         list_node_t * first,
+                         list_node_t * last,
+                         uint32_t      count)
+{
+    if (NULL == first->prev)
+    {
+        list->head = last->next;
+    }
+    else
+    {
+        first->prev->next = last->next;
+    }
+
+    if (NULL == last->next)
+    {
+        list->tail = first->prev;
+    }
+    else
+    {
+        last->next->prev = first->prev;
+    }
+
+    first->prev = NULL;
+    last->next  = NULL;
+    list->size -= count;
+}
+
+static uint32_t count_range(list_t *      list,
+                            list_node_t * first,
+                            list_node_t * last)
+{
+    list_node_t * inner   = first;
+    list_node_t * before  = first->prev;
+    list_node_t * after   = last->next;
+    uint32_t      inside  = 1;
+    uint32_t      outside = 0;
+
+    while (inner != last)
+    {
+        // Every node outside the range is counted, the rest are inside it
+        if ((NULL == before) && (NULL == after))
+        {
+            inside = list->size - outside;
+            goto END;
+        }
+
+        inner = inner->next;
+        inside++;
+
+        if (NULL != before)
+        {
+            before = before->prev;
+            outside++;
+        }
+        else
+        {
+            after = after->next;
+            outside++;
+        }
+    }
 
 END:
-    return;
+    return inside;
 }
 
-static void split(list_node_t *  head,
-                  list_node_t ** first_half,
-                  list_node_t ** second_half)
+static int index_reserve(list_t * list, uint32_t count)
 {
-    list_node_t * slow = head;
-    list_node_t * fast = head->next;
+    int                 exit_code    = E_SUCCESS;
+    list_index_t *      index        = list->index;
+    list_index_slot_t * old_slots    = NULL;
+    uint32_t            old_capacity = 0;
+    uint32_t            capacity     = LIST_INDEX_MIN_SLOTS;
+
+    if ((NULL == index)
+        || ((uint64_t)count * 4 <= (uint64_t)index->capacity * 3))
+    {
+        goto END;
+    }
+
+    while ((uint64_t)capacity * 3 < (uint64_t)count * 4)
+    {
+        capacity *= 2;
+    }
+
+    old_slots    = index->slots;
+    old_capacity = index->capacity;
+
+    index->slots = calloc(capacity, sizeof(list_index_slot_t));
+    if (NULL == index->slots)
+    {
+        index->slots = old_slots;
+        exit_code    = E_FAILURE;
+        goto END;
+    }
 
-    // Split the list into two halves by advancing 'fast' two nodes, and 'slow'
-    // one node
-    while (NULL != fast)
+    index->capacity = capacity;
+    index->count    = 0;
+
+    // Stored hashes let the entries move without calling the hash function
+    for (uint32_t idx = 0; idx < old_capacity; idx++)
     {
-        fast = fast->next;
-        if (NULL != fast)
+        if (NULL != old_slots[idx].node)
         {
-            slow = slow->next;
-            fast = fast->next;
+            uint32_t slot = (uint32_t)old_slots[idx].hash & (capacity - 1);
+
+            while (NULL != index->slots[slot].node)
+            {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            index->slots[slot] = old_slots[idx];
+            index->count++;
         }
     }
+    free(old_slots);
 
-    *first_half  = head;
-    *second_half = slow->next;
-    slow->next   = NULL;
+END:
+    return exit_code;
 }
 
-static list_node_t * merge(list_node_t * first,
-                           list_node_t * second,
-                           CMP_F         compare_func)
+static int index_add(list_t * list, list_node_t * node)
 {
-    list_node_t * result = NULL;
+    int            exit_code = E_SUCCESS;
+    list_index_t * index     = list->index;
+    uint64_t       hash      = 0;
+    uint32_t       slot      = 0;
 
-    if (NULL == first)
+    if (NULL == index)
     {
-        result = second;
         goto END;
     }
 
-    if (NULL == second)
+    exit_code = index_reserve(list, index->count + 1);
+    if (E_SUCCESS != exit_code)
     {
-        result = first;
         goto END;
     }
 
-    // 'first' is less than 'second'
-    if (LESS_THAN == compare_func(first->data, second->data))
+    hash = index->hash_func(node->data);
+    slot = (uint32_t)hash & (index->capacity - 1);
+    while (NULL != index->slots[slot].node)
     {
-        result             = first;
-        result->next       = merge(first->next, second, compare_func);
-        result->next->prev = result;
-        result->prev       = NULL;
+        slot = (slot + 1) & (index->capacity - 1);
     }
-    // 'first' is greater than or equal to 'second'
-    else
+
+    index->slots[slot].hash = hash;
+    index->slots[slot].node = node;
+    index->count++;
+
+END:
+    return exit_code;
+}
+
+static void index_drop(list_t * list, list_node_t * node)
+{
+    list_index_t * index = list->index;
+    uint32_t       mask  = 0;
+    uint32_t       hole  = 0;
+    uint32_t       slot  = 0;
+
+    if ((NULL == index) || (0 == index->count))
+    {
+        goto END;
+    }
+
+    mask = index->capacity - 1;
+    hole = (uint32_t)index->hash_func(node->data) & mask;
+    while (node != index->slots[hole].node)
+    {
+        if (NULL == index->slots[hole].node)
+        {
+            goto END;
+        }
+        hole = (hole + 1) & mask;
+    }
+
+    // Shift back every later entry of the probe run that may fill the hole
+    slot = hole;
+    for (;;)
     {
-        result             = second;
-        result->next       = merge(first, second->next, compare_func);
-        result->next->prev = result;
-        result->prev       = NULL;
+        uint32_t home = 0;
+
+        slot = (slot + 1) & mask;
+        if (NULL == index->slots[slot].node)
+        {
+            break;
+        }
+
+        home = (uint32_t)index->slots[slot].hash & mask;
+        if (((slot - home) & mask) >= ((slot - hole) & mask))
+        {
+            index->slots[hole] = index->slots[slot];
+            hole               = slot;
+        }
     }
 
+    index->slots[hole].node = NULL;
+    index->count--;
+
 END:
-    return result;
+    return;
 }
 
-static void merge_sort(list_node_t ** head_ref, CMP_F compare_func)
+static list_node_t * index_find(list_index_t * index,
+                                CMP_F          compare_func,
+                                void *         data)
 {
-    list_node_t * head = *head_ref;
-    list_node_t * first_half;
-    list_node_t * second_half;
+    list_node_t * found_node = NULL;
+    uint64_t      hash       = index->hash_func(data);
+    uint32_t      mask       = index->capacity - 1;
 
-    if ((NULL == head) || (NULL == head->next))
+    if (0 == index->capacity)
     {
-        return;
+        goto END;
     }
 
-    split(head, &first_half, &second_half);
+    for (uint32_t slot = (uint32_t)hash & mask;
+         NULL != index->slots[slot].node;
+         slot = (slot + 1) & mask)
+    {
+        if ((hash == index->slots[slot].hash)
+            && (EQUAL == compare_func(data, index->slots[slot].node->data)))
+        {
+            found_node = index->slots[slot].node;
+            break;
+        }
+    }
 
-    merge_sort(&first_half, compare_func);
-    merge_sort(&second_half, compare_func);
+END:
+    return found_node;
+}
 
-    *head_ref = merge(first_half, second_half, compare_func);
+static list_node_t * find_node(list_t * list, void * data)
+{
+    list_node_t * current_node = NULL;
+
+    if ((NULL == list) || (NULL == data))
+    {
+        print_error("Null argument passed.");
+        goto END;
+    }
+
+    if (NULL != list->index)
+    {
+        current_node = index_find(list->index, list->compare_func, data);
+        goto END;
+    }
+
+    current_node = list->head;
+    while (NULL != current_node)
+    {
+        if (EQUAL == list->compare_func(data, current_node->data))
+        {
+            // Success
+            goto END;
+        }
+        current_node = current_node->next;
+    }
+
+END:
+    return current_node;
+}
+
+static void remove_node(list_t * list, list_node_t * node)
+{
+    if ((NULL == list) || (NULL == node))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // The node's position is unknown, so the finger cannot be adjusted
+    list->finger = NULL;
+    index_drop(list, node);
+
+    if (NULL != node->prev)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        list->head = node->next;
+    }
+
+    if (node->next != NULL)
+    {
+        node->next->prev = node->prev;
+    }
+    else
+    {
+        list->tail = node->prev;
+    }
+
+    list->custom_free(node->data);
+    node->data = NULL;
+    list_node_free(list, node);
+    node = NULL;
+
+    list->size--;
+
+END:
+    return;
 }
 
 /*** end of file ***/
@@ -0,0 +1,512 @@
+#define _GNU_SOURCE // mremap()
+
+#include <errno.h>
+#include <fcntl.h>  // open()
+#include <limits.h> // INT_MAX
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h> // memcpy(), strerror()
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h> // ftruncate(), close()
+
+#include "mapped_vector.h"
+#include "utilities.h"
+
+#define MAPPED_VECTOR_MAGIC        "DSAMVEC" // Identifies a mapped vector file
+#define MAPPED_VECTOR_VERSION      1         // Bumped on layout changes
+#define MAPPED_VECTOR_MIN_CAPACITY 64        // Values a new file has room for
+#define MAPPED_VECTOR_SORTED       0x1U      // Header flag for is_sorted
+
+/**
+ * @brief Layout of the header at the start of a mapped vector file. Fields
+ * are fixed-width and stored in native byte order.
+ */
+typedef struct mapped_vector_header
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t elem_size;
+    uint64_t size;
+    uint64_t capacity;
+    uint32_t key_type;
+} mapped_vector_header_t;
+
+_Static_assert(sizeof(mapped_vector_header_t) <= MAPPED_VECTOR_HEADER_SIZE,
+               "Mapped vector header does not fit its reserved space.");
+
+/**
+ * @brief Maps an open backing file and points the view at its values.
+ *
+ * @param mapped Pointer to the mapped vector, with `fd` and `read_only` set.
+ * @param map_size Length of the file to map.
+ * @return Status code indicating success (E_SUCCESS) or failure (E_FAILURE).
+ */
+static int mapped_vector_map(mapped_vector_t * mapped, size_t map_size);
+
+/**
+ * @brief Checks that a mapped header describes a file this vector can use.
+ *
+ * @param mapped Pointer to the mapped vector.
+ * @param elem_size Element size the caller expects.
+ * @return Status code indicating success (E_SUCCESS) or failure (E_FAILURE).
+ */
+static int mapped_vector_validate(mapped_vector_t * mapped, size_t elem_size);
+
+/**
+ * @brief Extends the backing file and the mapping to hold exactly `capacity`
+ * values. The mapping may move.
+ *
+ * @param mapped Pointer to the mapped vector.
+ * @param capacity New capacity.
+ * @return Status code indicating success (E_SUCCESS) or failure (E_FAILURE).
+ */
+static int mapped_vector_remap(mapped_vector_t * mapped, int capacity);
+
+/**
+ * @brief Makes room for `count` more values, growing by the growth factor.
+ *
+ * @param mapped Pointer to the mapped vector.
+ * @param count Number of values about to be appended.
+ * @return Status code indicating success (E_SUCCESS) or failure (E_FAILURE).
+ */
+static int mapped_vector_grow(mapped_vector_t * mapped, int count);
+
+/**
+ * @brief Returns the file length needed for `capacity` values.
+ *
+ * @param elem_size Size in bytes of one value.
+ * @param capacity Number of values.
+ * @return Length of the file in bytes.
+ */
+static size_t mapped_vector_file_size(size_t elem_size, int capacity);
+
+/**
+ * @brief Copies the view's size, capacity and flags into the header.
+ *
+ * @param mapped Pointer to the mapped vector.
+ */
+static void mapped_vector_write_header(mapped_vector_t * mapped);
+
+mapped_vector_t * mapped_vector_open(const char * path,
+                                     size_t       elem_size,
+                                     CMP_F        compare_func,
+                                     bool         read_only)
+{
+    mapped_vector_t * mapped    = NULL;
+    struct stat       file_info = { 0 };
+    bool              is_new    = false;
+
+    if ((NULL == path) || (NULL == compare_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if ((0 == elem_size) || (elem_size > INT_MAX))
+    {
+        print_error("Invalid element size.");
+        goto END;
+    }
+
+    mapped = calloc(1, sizeof(mapped_vector_t));
+    if (NULL == mapped)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    mapped->read_only = read_only;
+    mapped->fd = open(path, read_only ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
+    if (-1 == mapped->fd)
+    {
+        print_errno("Unable to open mapped vector file.", strerror(errno));
+        goto FAIL;
+    }
+
+    if (-1 == fstat(mapped->fd, &file_info))
+    {
+        print_errno("Unable to stat mapped vector file.", strerror(errno));
+        goto FAIL;
+    }
+
+    // An empty file is a new vector, sized for a first batch of values
+    is_new = (0 == file_info.st_size);
+    if (is_new)
+    {
+        if (read_only)
+        {
+            print_error("Mapped vector file is empty.");
+            goto FAIL;
+        }
+
+        file_info.st_size = (off_t)mapped_vector_file_size(
+            elem_size, MAPPED_VECTOR_MIN_CAPACITY);
+        if (-1 == ftruncate(mapped->fd, file_info.st_size))
+        {
+            print_errno("Unable to size mapped vector file.", strerror(errno));
+            goto FAIL;
+        }
+    }
+
+    if (MAPPED_VECTOR_HEADER_SIZE > file_info.st_size)
+    {
+        print_error("Mapped vector file is truncated.");
+        goto FAIL;
+    }
+
+    if (E_SUCCESS != mapped_vector_map(mapped, (size_t)file_info.st_size))
+    {
+        goto FAIL;
+    }
+
+    if (is_new)
+    {
+        mapped_vector_header_t * header = mapped->map;
+
+        memcpy(header->magic, MAPPED_VECTOR_MAGIC, sizeof(header->magic));
+        header->version   = MAPPED_VECTOR_VERSION;
+        header->elem_size = elem_size;
+        header->capacity  = MAPPED_VECTOR_MIN_CAPACITY;
+    }
+
+    if (E_SUCCESS != mapped_vector_validate(mapped, elem_size))
+    {
+        goto FAIL;
+    }
+
+    mapped->vector.compare_func = compare_func;
+    goto END;
+
+FAIL:
+    if (NULL != mapped->map)
+    {
+        munmap(mapped->map, mapped->map_size);
+    }
+    if (-1 != mapped->fd)
+    {
+        close(mapped->fd);
+    }
+    free(mapped);
+    mapped = NULL;
+
+END:
+    return mapped;
+}
+
+vector_t * mapped_vector_view(mapped_vector_t * mapped)
+{
+    vector_t * view = NULL;
+
+    if (NULL == mapped)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    view = &mapped->vector;
+
+END:
+    return view;
+}
+
+int mapped_vector_reserve(mapped_vector_t * mapped, int capacity)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == mapped)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (mapped->read_only)
+    {
+        print_error("Mapped vector is read-only.");
+        goto END;
+    }
+
+    if (capacity <= mapped->vector.capacity)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    exit_code = mapped_vector_remap(mapped, capacity);
+
+END:
+    return exit_code;
+}
+
+int mapped_vector_append(mapped_vector_t * mapped, void * data)
+{
+    return mapped_vector_append_many(mapped, data, 1);
+}
+
+int mapped_vector_append_many(mapped_vector_t * mapped, void * data, int count)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == mapped) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (mapped->read_only)
+    {
+        print_error("Mapped vector is read-only.");
+        goto END;
+    }
+
+    if ((0 > count) || (count > INT_MAX - mapped->vector.size))
+    {
+        print_error("Invalid element count.");
+        goto END;
+    }
+
+    exit_code = mapped_vector_grow(mapped, count);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to grow mapped vector.");
+        goto END;
+    }
+
+    // The view has room now, so the vector functions never reallocate
+    if (1 == count)
+    {
+        exit_code = vector_append(&mapped->vector, data);
+    }
+    else
+    {
+        exit_code = vector_append_many(&mapped->vector, data, count);
+    }
+
+END:
+    return exit_code;
+}
+
+int mapped_vector_sync(mapped_vector_t * mapped)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == mapped)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (mapped->read_only)
+    {
+        print_error("Mapped vector is read-only.");
+        goto END;
+    }
+
+    mapped_vector_write_header(mapped);
+    if (-1 == msync(mapped->map, mapped->map_size, MS_SYNC))
+    {
+        print_errno("Unable to sync mapped vector.", strerror(errno));
+        goto END;
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int mapped_vector_close(mapped_vector_t ** mapped)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == mapped) || (NULL == *mapped))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = E_SUCCESS;
+    if (!(*mapped)->read_only)
+    {
+        exit_code = mapped_vector_sync(*mapped);
+    }
+
+    // Release everything even if the final sync failed
+    munmap((*mapped)->map, (*mapped)->map_size);
+    close((*mapped)->fd);
+    free(*mapped);
+    *mapped = NULL;
+
+END:
+    return exit_code;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static int mapped_vector_map(mapped_vector_t * mapped, size_t map_size)
+{
+    int    exit_code = E_FAILURE;
+    void * map       = NULL;
+
+    // A private writable mapping lets read-only users sort and edit in place
+    map = mmap(NULL,
+               map_size,
+               PROT_READ | PROT_WRITE,
+               mapped->read_only ? MAP_PRIVATE : MAP_SHARED,
+               mapped->fd,
+               0);
+    if (MAP_FAILED == map)
+    {
+        print_errno("Unable to map vector file.", strerror(errno));
+        goto END;
+    }
+
+    mapped->map      = map;
+    mapped->map_size = map_size;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+static int mapped_vector_validate(mapped_vector_t * mapped, size_t elem_size)
+{
+    int                      exit_code = E_FAILURE;
+    mapped_vector_header_t * header    = mapped->map;
+    vector_t *               view      = &mapped->vector;
+
+    if ((0 != memcmp(header->magic, MAPPED_VECTOR_MAGIC, sizeof(header->magic)))
+        || (MAPPED_VECTOR_VERSION != header->version))
+    {
+        print_error("Not a mapped vector file.");
+        goto END;
+    }
+
+    if (elem_size != header->elem_size)
+    {
+        print_error("Element size does not match the file.");
+        goto END;
+    }
+
+    if ((header->size > header->capacity) || (header->capacity > INT_MAX)
+        || (mapped->map_size
+            < mapped_vector_file_size(elem_size, (int)header->capacity)))
+    {
+        print_error("Mapped vector file is corrupt.");
+        goto END;
+    }
+
+    // Only plain values are stored, so there is nothing for vector_clear()
+    // to release
+    view->values = (unsigned char *)mapped->map + MAPPED_VECTOR_HEADER_SIZE;
+
+    view->size          = (int)header->size;
+    view->capacity      = (int)header->capacity;
+    view->elem_size     = elem_size;
+    view->growth_factor = VECTOR_DEFAULT_GROWTH_FACTOR;
+    view->key_type      = VECTOR_KEY_NONE;
+    view->is_sorted     = (0 != (header->flags & MAPPED_VECTOR_SORTED));
+    view->fixed_storage = true;
+    view->custom_free   = NULL;
+
+    if (E_SUCCESS != vector_set_key_type(view, (vector_key_t)header->key_type))
+    {
+        view->key_type = VECTOR_KEY_NONE;
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+static int mapped_vector_remap(mapped_vector_t * mapped, int capacity)
+{
+    int    exit_code = E_FAILURE;
+    size_t new_size  = 0;
+    void * new_map   = NULL;
+
+    new_size = mapped_vector_file_size(mapped->vector.elem_size, capacity);
+    if (-1 == ftruncate(mapped->fd, (off_t)new_size))
+    {
+        print_errno("Unable to extend mapped vector file.", strerror(errno));
+        goto END;
+    }
+
+#ifdef __linux__
+    new_map = mremap(mapped->map, mapped->map_size, new_size, MREMAP_MAYMOVE);
+    if (MAP_FAILED == new_map)
+    {
+        print_errno("Unable to remap vector file.", strerror(errno));
+        goto END;
+    }
+#else
+    // Without mremap() map the file again; the shared pages carry the data
+    new_map = mmap(
+        NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, mapped->fd, 0);
+    if (MAP_FAILED == new_map)
+    {
+        print_errno("Unable to remap vector file.", strerror(errno));
+        goto END;
+    }
+    munmap(mapped->map, mapped->map_size);
+#endif
+
+    mapped->map             = new_map;
+    mapped->map_size        = new_size;
+    mapped->vector.values   = (unsigned char *)new_map
+                            + MAPPED_VECTOR_HEADER_SIZE;
+    mapped->vector.capacity = capacity;
+    mapped_vector_write_header(mapped);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+static int mapped_vector_grow(mapped_vector_t * mapped, int count)
+{
+    int        exit_code    = E_SUCCESS;
+    vector_t * view         = &mapped->vector;
+    double     new_capacity = 0;
+
+    if (count <= view->capacity - view->size)
+    {
+        goto END;
+    }
+
+    // Grow geometrically like vector_resize(), so appends stay amortized O(1)
+    new_capacity = view->capacity * view->growth_factor;
+    if (new_capacity < (double)view->size + count)
+    {
+        new_capacity = (double)view->size + count;
+    }
+    if (new_capacity > INT_MAX)
+    {
+        new_capacity = INT_MAX;
+    }
+
+    exit_code = mapped_vector_remap(mapped, (int)new_capacity);
+
+END:
+    return exit_code;
+}
+
+static size_t mapped_vector_file_size(size_t elem_size, int capacity)
+{
+    return MAPPED_VECTOR_HEADER_SIZE + (elem_size * (size_t)capacity);
+}
+
+static void mapped_vector_write_header(mapped_vector_t * mapped)
+{
+    mapped_vector_header_t * header = mapped->map;
+    vector_t *               view   = &mapped->vector;
+
+    header->size     = (uint64_t)view->size;
+    header->capacity = (uint64_t)view->capacity;
+    header->key_type = (uint32_t)view->key_type;
+    header->flags    = view->is_sorted ? MAPPED_VECTOR_SORTED : 0;
+}
+
+/*** end of file ***/
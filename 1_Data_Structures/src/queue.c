@@ -0,0 +1,672 @@
+#include "queue.h"
+#include "utilities.h"
+
+/**
+ * @brief The hazard record this thread last used and the id of its queue.
+ * Comparing ids before touching the record keeps a thread from using a
+ * record of a queue that has since been deleted.
+ */
+static _Thread_local struct
+{
+    uint64_t         queue_id;
+    queue_hazard_t * record;
+} queue_hint;
+
+/**
+ * @brief Source of queue ids. Zero is never handed out, so a fresh thread's
+ * hint matches no queue.
+ */
+static atomic_uint_fast64_t queue_next_id = 1;
+
+/**
+ * @brief Claims a hazard record for the calling thread, trying the record it
+ * used last before searching the queue's list and finally adding a new one.
+ *
+ * @param queue Pointer to the queue.
+ * @return Pointer to the claimed record, or NULL on allocation failure.
+ */
+static queue_hazard_t * queue_hazard_acquire(queue_t * queue);
+
+/**
+ * @brief Clears a record's hazard pointers and gives it up.
+ *
+ * @param record Pointer to the record.
+ */
+static void queue_hazard_release(queue_hazard_t * record);
+
+/**
+ * @brief Tries to claim a hazard record.
+ *
+ * @param record Pointer to the record.
+ * @return true if the calling thread now holds the record.
+ */
+static bool queue_hazard_claim(queue_hazard_t * record);
+
+/**
+ * @brief Loads a node pointer and publishes it in a hazard slot. The load is
+ * repeated until it agrees with the published value, after which the node
+ * cannot be freed while the slot holds it.
+ *
+ * @param record Record holding the hazard slot.
+ * @param slot Index of the hazard slot.
+ * @param source Pointer to load.
+ * @return The protected node.
+ */
+static queue_node_t * queue_protect(queue_hazard_t *          record,
+                                    int                       slot,
+                                    _Atomic(queue_node_t *) * source);
+
+/**
+ * @brief Links a chain of nodes after the tail of the queue.
+ *
+ * @param queue Pointer to the queue.
+ * @param record Hazard record held by the calling thread.
+ * @param first First node of the chain.
+ * @param last Last node of the chain, whose next pointer is NULL.
+ */
+static void queue_link(queue_t *        queue,
+                       queue_hazard_t * record,
+                       queue_node_t *   first,
+                       queue_node_t *   last);
+
+/**
+ * @brief Removes the item at the front of the queue.
+ *
+ * @param queue Pointer to the queue.
+ * @param record Hazard record held by the calling thread.
+ * @return Pointer to the item, NULL if the queue is empty.
+ */
+static void * queue_take(queue_t * queue, queue_hazard_t * record);
+
+/**
+ * @brief Hands a removed node to the record's retired list. Once the list
+ * holds twice as many nodes as all threads can have published, a reclaim
+ * scan runs, and the list grows if the scan leaves it full. The thread
+ * never waits on another thread's hazards unless memory runs out.
+ *
+ * @param queue Pointer to the queue.
+ * @param record Hazard record held by the calling thread.
+ * @param node Node removed from the queue.
+ */
+static void queue_retire(queue_t *        queue,
+                         queue_hazard_t * record,
+                         queue_node_t *   node);
+
+/**
+ * @brief Frees every retired node of a record that no thread has published
+ * in a hazard slot, keeping the rest for a later scan.
+ *
+ * @param queue Pointer to the queue.
+ * @param record Hazard record held by the calling thread.
+ */
+static void queue_reclaim(queue_t * queue, queue_hazard_t * record);
+
+/**
+ * @brief Checks whether any thread has a node published in a hazard slot.
+ *
+ * @param queue Pointer to the queue.
+ * @param node Node to look for.
+ * @return true if the node is protected.
+ */
+static bool queue_is_hazard(queue_t * queue, queue_node_t * node);
+
+queue_t * queue_new(FREE_F free_func)
+{
+    queue_t *      new_queue = NULL;
+    queue_node_t * dummy     = NULL;
+
+    new_queue = aligned_alloc(QUEUE_CACHE_LINE, sizeof(queue_t));
+    if (NULL == new_queue)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    dummy = calloc(1, sizeof(queue_node_t));
+    if (NULL == dummy)
+    {
+        print_error("CMR failure.");
+        free(new_queue);
+        new_queue = NULL;
+        goto END;
+    }
+
+    atomic_init(&dummy->next, NULL);
+    atomic_init(&new_queue->head, dummy);
+    atomic_init(&new_queue->tail, dummy);
+    atomic_init(&new_queue->hazards, NULL);
+    atomic_init(&new_queue->record_count, 0);
+    new_queue->id
+        = atomic_fetch_add_explicit(&queue_next_id, 1, memory_order_relaxed);
+    new_queue->custom_free = free_func;
+
+END:
+    return new_queue;
+}
+
+int queue_enqueue(queue_t * queue, void * data)
+{
+    return queue_enqueue_batch(queue, &data, 1);
+}
+
+int queue_enqueue_batch(queue_t * queue, void ** items, uint32_t count)
+{
+    int              exit_code = E_FAILURE;
+    queue_hazard_t * record    = NULL;
+    queue_node_t *   first     = NULL;
+    queue_node_t *   last      = NULL;
+    queue_node_t *   new_node  = NULL;
+
+    if ((NULL == queue) || (NULL == items))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // Build the chain privately so it can be published in one step
+    for (uint32_t idx = 0; idx < count; idx++)
+    {
+        if (NULL == items[idx])
+        {
+            print_error("NULL argument passed.");
+            goto END;
+        }
+
+        new_node = malloc(sizeof(queue_node_t));
+        if (NULL == new_node)
+        {
+            print_error("CMR failure.");
+            goto END;
+        }
+
+        atomic_init(&new_node->next, NULL);
+        new_node->data = items[idx];
+
+        if (NULL == last)
+        {
+            first = new_node;
+        }
+        else
+        {
+            atomic_store_explicit(&last->next, new_node, memory_order_relaxed);
+        }
+        last = new_node;
+    }
+
+    if (NULL == first)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    record = queue_hazard_acquire(queue);
+    if (NULL == record)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    queue_link(queue, record, first, last);
+    queue_hazard_release(record);
+    first = NULL;
+
+    exit_code = E_SUCCESS;
+END:
+    while (NULL != first)
+    {
+        new_node = first;
+        first    = atomic_load_explicit(&first->next, memory_order_relaxed);
+        free(new_node);
+    }
+    return exit_code;
+}
+
+void * queue_dequeue(queue_t * queue)
+{
+    void * data = NULL;
+
+    if (1 != queue_dequeue_batch(queue, &data, 1))
+    {
+        data = NULL;
+    }
+
+    return data;
+}
+
+int queue_dequeue_batch(queue_t * queue, void ** items, uint32_t max_items)
+{
+    int              count  = -1;
+    queue_hazard_t * record = NULL;
+    void *           data   = NULL;
+
+    if ((NULL == queue) || (NULL == items))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    record = queue_hazard_acquire(queue);
+    if (NULL == record)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    count = 0;
+    while ((uint32_t)count < max_items)
+    {
+        data = queue_take(queue, record);
+        if (NULL == data)
+        {
+            break;
+        }
+        items[count] = data;
+        count++;
+    }
+
+    queue_hazard_release(record);
+
+END:
+    return count;
+}
+
+bool queue_is_empty(queue_t * queue)
+{
+    bool             is_empty = true;
+    queue_hazard_t * record   = NULL;
+    queue_node_t *   head     = NULL;
+
+    if (NULL == queue)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    record = queue_hazard_acquire(queue);
+    if (NULL == record)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    head     = queue_protect(record, 0, &queue->head);
+    is_empty = (NULL
+                == atomic_load_explicit(&head->next, memory_order_acquire));
+    queue_hazard_release(record);
+
+END:
+    return is_empty;
+}
+
+int queue_clear(queue_t * queue)
+{
+    int              exit_code = E_FAILURE;
+    queue_hazard_t * record    = NULL;
+    void *           data      = NULL;
+
+    if (NULL == queue)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    record = queue_hazard_acquire(queue);
+    if (NULL == record)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    data = queue_take(queue, record);
+    while (NULL != data)
+    {
+        if (NULL != queue->custom_free)
+        {
+            queue->custom_free(data);
+        }
+        data = queue_take(queue, record);
+    }
+
+    queue_hazard_release(record);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int queue_delete(queue_t ** queue_address)
+{
+    int              exit_code = E_FAILURE;
+    queue_hazard_t * record    = NULL;
+    queue_hazard_t * next      = NULL;
+
+    if ((NULL == queue_address) || (NULL == *queue_address))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = queue_clear(*queue_address);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to clear queue.");
+        goto END;
+    }
+
+    // No other thread is left, so every retired node can go
+    record = atomic_load_explicit(&(*queue_address)->hazards,
+                                  memory_order_acquire);
+    while (NULL != record)
+    {
+        next = record->next;
+        for (uint32_t idx = 0; idx < record->retired_count; idx++)
+        {
+            free(record->retired[idx]);
+        }
+        free(record->retired);
+        free(record);
+        record = next;
+    }
+
+    free(atomic_load_explicit(&(*queue_address)->head, memory_order_relaxed));
+    free(*queue_address);
+    *queue_address = NULL;
+
+END:
+    return exit_code;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static queue_hazard_t * queue_hazard_acquire(queue_t * queue)
+{
+    queue_hazard_t * record = NULL;
+
+    if ((queue->id == queue_hint.queue_id)
+        && queue_hazard_claim(queue_hint.record))
+    {
+        record = queue_hint.record;
+        goto END;
+    }
+
+    for (record = atomic_load_explicit(&queue->hazards, memory_order_acquire);
+         NULL != record;
+         record = record->next)
+    {
+        if (queue_hazard_claim(record))
+        {
+            goto HINT;
+        }
+    }
+
+    record = calloc(1, sizeof(queue_hazard_t));
+    if (NULL == record)
+    {
+        goto END;
+    }
+
+    for (int slot = 0; slot < QUEUE_HAZARDS; slot++)
+    {
+        atomic_init(&record->hazards[slot], NULL);
+    }
+    atomic_init(&record->active, true);
+
+    // Records are only ever pushed, so a plain push needs no ABA guard
+    record->next = atomic_load_explicit(&queue->hazards, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&queue->hazards,
+                                                  &record->next,
+                                                  record,
+                                                  memory_order_release,
+                                                  memory_order_relaxed))
+    {
+    }
+    atomic_fetch_add_explicit(&queue->record_count, 1, memory_order_relaxed);
+
+HINT:
+    queue_hint.queue_id = queue->id;
+    queue_hint.record   = record;
+END:
+    return record;
+}
+
+static void queue_hazard_release(queue_hazard_t * record)
+{
+    for (int slot = 0; slot < QUEUE_HAZARDS; slot++)
+    {
+        atomic_store_explicit(&record->hazards[slot], NULL,
+                              memory_order_release);
+    }
+    atomic_store_explicit(&record->active, false, memory_order_release);
+}
+
+static bool queue_hazard_claim(queue_hazard_t * record)
+{
+    bool expected = false;
+
+    // A cheap load first keeps busy records from bouncing between caches
+    return (!atomic_load_explicit(&record->active, memory_order_relaxed))
+           && atomic_compare_exchange_strong_explicit(&record->active,
+                                                      &expected,
+                                                      true,
+                                                      memory_order_acquire,
+                                                      memory_order_relaxed);
+}
+
+static queue_node_t * queue_protect(queue_hazard_t *          record,
+                                    int                       slot,
+                                    _Atomic(queue_node_t *) * source)
+{
+    queue_node_t * node      = atomic_load(source);
+    queue_node_t * confirmed = NULL;
+
+    // Sequentially consistent, so the reclaim scan cannot miss the hazard
+    // once the source is seen unchanged
+    for (;;)
+    {
+        atomic_store(&record->hazards[slot], node);
+        confirmed = atomic_load(source);
+        if (confirmed == node)
+        {
+            break;
+        }
+        node = confirmed;
+    }
+
+    return node;
+}
+
+static void queue_link(queue_t *        queue,
+                       queue_hazard_t * record,
+                       queue_node_t *   first,
+                       queue_node_t *   last)
+{
+    queue_node_t * tail = NULL;
+    queue_node_t * next = NULL;
+
+    for (;;)
+    {
+        tail = queue_protect(record, 0, &queue->tail);
+        next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+        if (NULL != next)
+        {
+            // Another enqueue is halfway done, so help it move the tail on
+            atomic_compare_exchange_weak_explicit(&queue->tail,
+                                                  &tail,
+                                                  next,
+                                                  memory_order_release,
+                                                  memory_order_relaxed);
+            continue;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&tail->next,
+                                                  &next,
+                                                  first,
+                                                  memory_order_release,
+                                                  memory_order_relaxed))
+        {
+            break;
+        }
+    }
+
+    // Failure means another thread has already moved the tail past it
+    atomic_compare_exchange_strong_explicit(&queue->tail,
+                                            &tail,
+                                            last,
+                                            memory_order_release,
+                                            memory_order_relaxed);
+}
+
+static void * queue_take(queue_t * queue, queue_hazard_t * record)
+{
+    void *         data = NULL;
+    queue_node_t * head = NULL;
+    queue_node_t * tail = NULL;
+    queue_node_t * next = NULL;
+
+    for (;;)
+    {
+        head = queue_protect(record, 0, &queue->head);
+        tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        next = queue_protect(record, 1, &head->next);
+
+        // The head may have moved on, and its node been retired, between
+        // protecting it and protecting its successor
+        if (head != atomic_load(&queue->head))
+        {
+            continue;
+        }
+
+        if (NULL == next)
+        {
+            break;
+        }
+
+        if (head == tail)
+        {
+            // The tail lags behind a finished link, so move it on first
+            atomic_compare_exchange_weak_explicit(&queue->tail,
+                                                  &tail,
+                                                  next,
+                                                  memory_order_release,
+                                                  memory_order_relaxed);
+            continue;
+        }
+
+        // The successor becomes the new dummy, so its data is read before
+        // another consumer can take it
+        data = next->data;
+        if (atomic_compare_exchange_weak_explicit(&queue->head,
+                                                  &head,
+                                                  next,
+                                                  memory_order_acq_rel,
+                                                  memory_order_relaxed))
+        {
+            atomic_store_explicit(&record->hazards[0], NULL,
+                                  memory_order_release);
+            queue_retire(queue, record, head);
+            break;
+        }
+        data = NULL;
+    }
+
+    return data;
+}
+
+static void queue_retire(queue_t *        queue,
+                         queue_hazard_t * record,
+                         queue_node_t *   node)
+{
+    uint32_t        threshold = QUEUE_RETIRE_THRESHOLD;
+    uint32_t        capacity  = 0;
+    queue_node_t ** retired   = NULL;
+
+    // At most hazards * records nodes can be published, so a scan at twice
+    // that frees at least as many nodes as it could have to keep
+    threshold += 2 * QUEUE_HAZARDS
+                 * atomic_load_explicit(&queue->record_count,
+                                        memory_order_relaxed);
+    if (threshold <= record->retired_count)
+    {
+        queue_reclaim(queue, record);
+    }
+
+    if (record->retired_count == record->retired_capacity)
+    {
+        capacity = record->retired_capacity * 2;
+        if (QUEUE_RETIRE_THRESHOLD > capacity)
+        {
+            capacity = QUEUE_RETIRE_THRESHOLD;
+        }
+
+        retired = realloc(record->retired, capacity * sizeof(queue_node_t *));
+        if (NULL != retired)
+        {
+            record->retired          = retired;
+            record->retired_capacity = capacity;
+        }
+    }
+
+    if (record->retired_count < record->retired_capacity)
+    {
+        record->retired[record->retired_count] = node;
+        record->retired_count++;
+    }
+    else
+    {
+        // Out of memory: wait until no thread has the node published and
+        // free it, the one case where an operation waits on another thread
+        while (queue_is_hazard(queue, node))
+        {
+        }
+        free(node);
+    }
+}
+
+static void queue_reclaim(queue_t * queue, queue_hazard_t * record)
+{
+    uint32_t kept = 0;
+
+    for (uint32_t idx = 0; idx < record->retired_count; idx++)
+    {
+        queue_node_t * node = record->retired[idx];
+
+        if (queue_is_hazard(queue, node))
+        {
+            record->retired[kept] = node;
+            kept++;
+        }
+        else
+        {
+            free(node);
+        }
+    }
+
+    record->retired_count = kept;
+}
+
+static bool queue_is_hazard(queue_t * queue, queue_node_t * node)
+{
+    bool             is_hazard = false;
+    queue_hazard_t * record    = NULL;
+
+    for (record = atomic_load(&queue->hazards);
+         (NULL != record) && (!is_hazard);
+         record = record->next)
+    {
+        for (int slot = 0; slot < QUEUE_HAZARDS; slot++)
+        {
+            if (node == atomic_load(&record->hazards[slot]))
+            {
+                is_hazard = true;
+                break;
+            }
+        }
+    }
+
+    return is_hazard;
+}
+
+/*** end of file ***/
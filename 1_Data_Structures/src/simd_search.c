@@ -0,0 +1,549 @@
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "simd_search.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SEARCH_X86 1
+#include <immintrin.h>
+#else
+#define SEARCH_X86 0
+#endif
+
+#define SEARCH_UNDETECTED -1 // Level not yet read from the CPU
+
+/**
+ * @brief Scans an array for a key and records the indices of up to `limit`
+ * matches.
+ */
+typedef int (*SCAN_I32_F)(const int32_t *, int, int32_t, int *, int);
+typedef int (*SCAN_I64_F)(const int64_t *, int, int64_t, int *, int);
+typedef int (*SCAN_FLOAT_F)(const float *, int, float, int *, int);
+
+/**
+ * @brief The kernels for one instruction set.
+ */
+typedef struct search_kernels
+{
+    SCAN_I32_F   scan_i32;
+    SCAN_I64_F   scan_i64;
+    SCAN_FLOAT_F scan_float;
+} search_kernels_t;
+
+/**
+ * @brief Records the set bits of a compare mask as indices, returning from
+ * the enclosing kernel once `limit` matches are found.
+ */
+#define SEARCH_COLLECT(mask, base)                                             \
+    while (0 != (mask))                                                        \
+    {                                                                          \
+        indices[found++] = (base) + __builtin_ctzll(mask);                     \
+        if (found == limit)                                                    \
+        {                                                                      \
+            return found;                                                      \
+        }                                                                      \
+        (mask) &= (mask)-1;                                                    \
+    }
+
+/**
+ * @brief Scalar loop over the elements from `idx` onwards, used on its own
+ * and for the tail a vector kernel leaves over.
+ */
+#define SEARCH_TAIL()                                                          \
+    for (; idx < count; idx++)                                                 \
+    {                                                                          \
+        if (array[idx] == key)                                                 \
+        {                                                                      \
+            indices[found++] = idx;                                            \
+            if (found == limit)                                                \
+            {                                                                  \
+                break;                                                         \
+            }                                                                  \
+        }                                                                      \
+    }
+
+static atomic_int active_level = SEARCH_UNDETECTED;
+
+/**
+ * @brief Reads the widest instruction set the CPU and OS support.
+ *
+ * @return The detected search level.
+ */
+static search_level_t search_detect_level(void);
+
+/**
+ * @brief Returns the kernels for the active search level.
+ *
+ * @return Pointer to the kernel table entry.
+ */
+static const search_kernels_t * search_kernels(void);
+
+static int scan_i32_scalar(
+    const int32_t * array, int count, int32_t key, int * indices, int limit);
+static int scan_i64_scalar(
+    const int64_t * array, int count, int64_t key, int * indices, int limit);
+static int scan_float_scalar(
+    const float * array, int count, float key, int * indices, int limit);
+
+#if SEARCH_X86
+static int scan_i32_sse2(
+    const int32_t * array, int count, int32_t key, int * indices, int limit);
+static int scan_i64_sse2(
+    const int64_t * array, int count, int64_t key, int * indices, int limit);
+static int scan_float_sse2(
+    const float * array, int count, float key, int * indices, int limit);
+static int scan_i32_avx2(
+    const int32_t * array, int count, int32_t key, int * indices, int limit);
+static int scan_i64_avx2(
+    const int64_t * array, int count, int64_t key, int * indices, int limit);
+static int scan_float_avx2(
+    const float * array, int count, float key, int * indices, int limit);
+static int scan_i32_avx512(
+    const int32_t * array, int count, int32_t key, int * indices, int limit);
+static int scan_i64_avx512(
+    const int64_t * array, int count, int64_t key, int * indices, int limit);
+static int scan_float_avx512(
+    const float * array, int count, float key, int * indices, int limit);
+#endif
+
+static const search_kernels_t search_table[] = {
+    [SEARCH_SCALAR] = { scan_i32_scalar, scan_i64_scalar, scan_float_scalar },
+#if SEARCH_X86
+    [SEARCH_SSE2]   = { scan_i32_sse2, scan_i64_sse2, scan_float_sse2 },
+    [SEARCH_AVX2]   = { scan_i32_avx2, scan_i64_avx2, scan_float_avx2 },
+    [SEARCH_AVX512] = { scan_i32_avx512, scan_i64_avx512, scan_float_avx512 },
+#else
+    [SEARCH_SSE2]   = { scan_i32_scalar, scan_i64_scalar, scan_float_scalar },
+    [SEARCH_AVX2]   = { scan_i32_scalar, scan_i64_scalar, scan_float_scalar },
+    [SEARCH_AVX512] = { scan_i32_scalar, scan_i64_scalar, scan_float_scalar },
+#endif
+};
+
+search_level_t search_get_level(void)
+{
+    int level = atomic_load_explicit(&active_level, memory_order_relaxed);
+
+    if (SEARCH_UNDETECTED == level)
+    {
+        level = (int)search_detect_level();
+        atomic_store_explicit(&active_level, level, memory_order_relaxed);
+    }
+
+    return (search_level_t)level;
+}
+
+search_level_t search_set_level(search_level_t level)
+{
+    search_level_t supported = search_detect_level();
+
+    if (level > supported)
+    {
+        level = supported;
+    }
+    if (level < SEARCH_SCALAR)
+    {
+        level = SEARCH_SCALAR;
+    }
+
+    atomic_store_explicit(&active_level, (int)level, memory_order_relaxed);
+
+    return level;
+}
+
+int search_find_i32(const int32_t * array, int count, int32_t key)
+{
+    int index = -1;
+
+    if ((NULL == array) || (0 >= count))
+    {
+        goto END;
+    }
+
+    if (0 == search_kernels()->scan_i32(array, count, key, &index, 1))
+    {
+        index = -1;
+    }
+
+END:
+    return index;
+}
+
+int search_find_i64(const int64_t * array, int count, int64_t key)
+{
+    int index = -1;
+
+    if ((NULL == array) || (0 >= count))
+    {
+        goto END;
+    }
+
+    if (0 == search_kernels()->scan_i64(array, count, key, &index, 1))
+    {
+        index = -1;
+    }
+
+END:
+    return index;
+}
+
+int search_find_float(const float * array, int count, float key)
+{
+    int index = -1;
+
+    if ((NULL == array) || (0 >= count))
+    {
+        goto END;
+    }
+
+    if (0 == search_kernels()->scan_float(array, count, key, &index, 1))
+    {
+        index = -1;
+    }
+
+END:
+    return index;
+}
+
+int search_find_all_i32(const int32_t * array,
+                        int             count,
+                        int32_t         key,
+                        int *           indices)
+{
+    int found = 0;
+
+    if ((NULL == array) || (NULL == indices) || (0 >= count))
+    {
+        goto END;
+    }
+
+    found = search_kernels()->scan_i32(array, count, key, indices, count);
+
+END:
+    return found;
+}
+
+int search_find_all_i64(const int64_t * array,
+                        int             count,
+                        int64_t         key,
+                        int *           indices)
+{
+    int found = 0;
+
+    if ((NULL == array) || (NULL == indices) || (0 >= count))
+    {
+        goto END;
+    }
+
+    found = search_kernels()->scan_i64(array, count, key, indices, count);
+
+END:
+    return found;
+}
+
+int search_find_all_float(const float * array,
+                          int           count,
+                          float         key,
+                          int *         indices)
+{
+    int found = 0;
+
+    if ((NULL == array) || (NULL == indices) || (0 >= count))
+    {
+        goto END;
+    }
+
+    found = search_kernels()->scan_float(array, count, key, indices, count);
+
+END:
+    return found;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static search_level_t search_detect_level(void)
+{
+    search_level_t level = SEARCH_SCALAR;
+
+#if SEARCH_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        level = SEARCH_AVX512;
+    }
+    else if (__builtin_cpu_supports("avx2"))
+    {
+        level = SEARCH_AVX2;
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        level = SEARCH_SSE2;
+    }
+#endif
+
+    return level;
+}
+
+static const search_kernels_t * search_kernels(void)
+{
+    return &search_table[search_get_level()];
+}
+
+static int scan_i32_scalar(
+    const int32_t * array, int count, int32_t key, int * indices, int limit)
+{
+    int found = 0;
+    int idx   = 0;
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+static int scan_i64_scalar(
+    const int64_t * array, int count, int64_t key, int * indices, int limit)
+{
+    int found = 0;
+    int idx   = 0;
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+static int scan_float_scalar(
+    const float * array, int count, float key, int * indices, int limit)
+{
+    int found = 0;
+    int idx   = 0;
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+#if SEARCH_X86
+
+__attribute__((target("sse2"))) static int scan_i32_sse2(
+    const int32_t * array, int count, int32_t key, int * indices, int limit)
+{
+    int     found  = 0;
+    int     idx    = 0;
+    __m128i needle = _mm_set1_epi32(key);
+
+    for (; idx + 4 <= count; idx += 4)
+    {
+        __m128i  block = _mm_loadu_si128((const __m128i *)(array + idx));
+        __m128i  equal = _mm_cmpeq_epi32(block, needle);
+        uint64_t mask  = (uint64_t)_mm_movemask_ps(_mm_castsi128_ps(equal));
+
+        SEARCH_COLLECT(mask, idx)
+    }
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+__attribute__((target("sse2"))) static int scan_i64_sse2(
+    const int64_t * array, int count, int64_t key, int * indices, int limit)
+{
+    int     found  = 0;
+    int     idx    = 0;
+    __m128i needle = _mm_set1_epi64x(key);
+
+    for (; idx + 2 <= count; idx += 2)
+    {
+        __m128i  block = _mm_loadu_si128((const __m128i *)(array + idx));
+        __m128i  equal = _mm_cmpeq_epi32(block, needle);
+        uint64_t mask  = 0;
+
+        // SSE2 has no 64-bit compare, so both 32-bit halves must match
+        equal = _mm_and_si128(
+            equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+        mask = (uint64_t)_mm_movemask_pd(_mm_castsi128_pd(equal));
+
+        SEARCH_COLLECT(mask, idx)
+    }
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+__attribute__((target("sse2"))) static int scan_float_sse2(
+    const float * array, int count, float key, int * indices, int limit)
+{
+    int    found  = 0;
+    int    idx    = 0;
+    __m128 needle = _mm_set1_ps(key);
+
+    for (; idx + 4 <= count; idx += 4)
+    {
+        __m128   block = _mm_loadu_ps(array + idx);
+        uint64_t mask  = (uint64_t)_mm_movemask_ps(_mm_cmpeq_ps(block, needle));
+
+        SEARCH_COLLECT(mask, idx)
+    }
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+__attribute__((target("avx2"))) static int scan_i32_avx2(
+    const int32_t * array, int count, int32_t key, int * indices, int limit)
+{
+    int     found  = 0;
+    int     idx    = 0;
+    __m256i needle = _mm256_set1_epi32(key);
+
+    // Test two registers per iteration and only decode when either matched
+    for (; idx + 16 <= count; idx += 16)
+    {
+        __m256i lo = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256((const __m256i *)(array + idx)), needle);
+        __m256i hi = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256((const __m256i *)(array + idx + 8)), needle);
+
+        if (_mm256_testz_si256(_mm256_or_si256(lo, hi),
+                               _mm256_or_si256(lo, hi)))
+        {
+            continue;
+        }
+
+        uint64_t mask =
+            (uint64_t)(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(lo))
+            | ((uint64_t)(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(hi))
+               << 8);
+
+        SEARCH_COLLECT(mask, idx)
+    }
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+__attribute__((target("avx2"))) static int scan_i64_avx2(
+    const int64_t * array, int count, int64_t key, int * indices, int limit)
+{
+    int     found  = 0;
+    int     idx    = 0;
+    __m256i needle = _mm256_set1_epi64x(key);
+
+    for (; idx + 8 <= count; idx += 8)
+    {
+        __m256i lo = _mm256_cmpeq_epi64(
+            _mm256_loadu_si256((const __m256i *)(array + idx)), needle);
+        __m256i hi = _mm256_cmpeq_epi64(
+            _mm256_loadu_si256((const __m256i *)(array + idx + 4)), needle);
+
+        if (_mm256_testz_si256(_mm256_or_si256(lo, hi),
+                               _mm256_or_si256(lo, hi)))
+        {
+            continue;
+        }
+
+        uint64_t mask =
+            (uint64_t)(uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(lo))
+            | ((uint64_t)(uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(hi))
+               << 4);
+
+        SEARCH_COLLECT(mask, idx)
+    }
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+__attribute__((target("avx2"))) static int scan_float_avx2(
+    const float * array, int count, float key, int * indices, int limit)
+{
+    int    found  = 0;
+    int    idx    = 0;
+    __m256 needle = _mm256_set1_ps(key);
+
+    for (; idx + 16 <= count; idx += 16)
+    {
+        __m256 lo =
+            _mm256_cmp_ps(_mm256_loadu_ps(array + idx), needle, _CMP_EQ_OQ);
+        __m256 hi =
+            _mm256_cmp_ps(_mm256_loadu_ps(array + idx + 8), needle, _CMP_EQ_OQ);
+        uint64_t mask = (uint64_t)(uint32_t)_mm256_movemask_ps(lo)
+                        | ((uint64_t)(uint32_t)_mm256_movemask_ps(hi) << 8);
+
+        SEARCH_COLLECT(mask, idx)
+    }
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+__attribute__((target("avx512f"))) static int scan_i32_avx512(
+    const int32_t * array, int count, int32_t key, int * indices, int limit)
+{
+    int     found  = 0;
+    int     idx    = 0;
+    __m512i needle = _mm512_set1_epi32(key);
+
+    for (; idx + 16 <= count; idx += 16)
+    {
+        uint64_t mask = _mm512_cmpeq_epi32_mask(
+            _mm512_loadu_si512((const void *)(array + idx)), needle);
+
+        SEARCH_COLLECT(mask, idx)
+    }
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+__attribute__((target("avx512f"))) static int scan_i64_avx512(
+    const int64_t * array, int count, int64_t key, int * indices, int limit)
+{
+    int     found  = 0;
+    int     idx    = 0;
+    __m512i needle = _mm512_set1_epi64(key);
+
+    for (; idx + 8 <= count; idx += 8)
+    {
+        uint64_t mask = _mm512_cmpeq_epi64_mask(
+            _mm512_loadu_si512((const void *)(array + idx)), needle);
+
+        SEARCH_COLLECT(mask, idx)
+    }
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+__attribute__((target("avx512f"))) static int scan_float_avx512(
+    const float * array, int count, float key, int * indices, int limit)
+{
+    int    found  = 0;
+    int    idx    = 0;
+    __m512 needle = _mm512_set1_ps(key);
+
+    for (; idx + 16 <= count; idx += 16)
+    {
+        uint64_t mask = _mm512_cmp_ps_mask(
+            _mm512_loadu_ps(array + idx), needle, _CMP_EQ_OQ);
+
+        SEARCH_COLLECT(mask, idx)
+    }
+
+    SEARCH_TAIL()
+
+    return found;
+}
+
+#endif
+
+/*** end of file ***/
@@ -0,0 +1,1515 @@
+#define _POSIX_C_SOURCE 200809L // sysconf()
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h> // malloc(), free()
+#include <string.h> // memcpy()
+#include <unistd.h> // sysconf()
+
+#include "sorts.h"
+#include "utilities.h"
+
+#define INSERTION_SORT_THRESHOLD     24  // Partitions below this use insertion
+#define NINTHER_THRESHOLD            128 // Partitions above this use a ninther
+#define PARTIAL_INSERTION_SORT_LIMIT 8   // Moves allowed before giving up
+#define MERGE_RUN_LENGTH             16  // Initial run length of merge sort
+#define RADIX_BITS                   8   // Bits sorted per radix pass
+#define RADIX_BUCKETS                (1 << RADIX_BITS)
+#define RADIX_THRESHOLD              256 // Smaller inputs use introsort
+#define SWAP_CHUNK                   64  // Bytes swapped per step
+#define PARALLEL_SORT_CUTOFF         (1 << 15) // Elements per thread, minimum
+
+SORTS_DEFINE_INTROSORT(sort_small_u32, uint32_t, SORTS_LESS)
+SORTS_DEFINE_INTROSORT(sort_small_u64, uint64_t, SORTS_LESS)
+
+/**
+ * @brief State shared by the generic comparison sorts.
+ *
+ * @param elem_size size in bytes of one element
+ * @param compare_func user comparison function
+ * @param indirect when true elements are pointers and the data they point to
+ * is compared
+ * @param scratch temporary storage for one element
+ */
+typedef struct sort_ctx
+{
+    size_t          elem_size;
+    CMP_F           compare_func;
+    bool            indirect;
+    unsigned char * scratch;
+} sort_ctx_t;
+
+/**
+ * @brief Checks whether the element at `first` sorts before the one at
+ * `second`.
+ *
+ * @param ctx Sort state.
+ * @param first Address of the first element.
+ * @param second Address of the second element.
+ * @return true if `first` is LESS_THAN `second`.
+ */
+static bool sort_less(sort_ctx_t * ctx, void * first, void * second);
+
+/**
+ * @brief Swaps two elements of any size.
+ *
+ * @param first Address of the first element.
+ * @param second Address of the second element.
+ * @param elem_size Size in bytes of one element.
+ */
+static void sort_swap(void * first, void * second, size_t elem_size);
+
+/**
+ * @brief Sorts two elements in place.
+ */
+static void sort2(sort_ctx_t *    ctx,
+                  unsigned char * first,
+                  unsigned char * second);
+
+/**
+ * @brief Sorts three elements in place.
+ */
+static void sort3(sort_ctx_t *    ctx,
+                  unsigned char * first,
+                  unsigned char * second,
+                  unsigned char * third);
+
+/**
+ * @brief Sorts [begin, end) with insertion sort.
+ *
+ * @param ctx Sort state.
+ * @param begin First element.
+ * @param end One past the last element.
+ * @param guarded false if an element not greater than any in the range is
+ * known to sit right before `begin`, which removes a bounds check.
+ */
+static void insertion_sort(sort_ctx_t *    ctx,
+                           unsigned char * begin,
+                           unsigned char * end,
+                           bool            guarded);
+
+/**
+ * @brief Attempts to sort [begin, end) with insertion sort, giving up once
+ * too many elements had to be moved.
+ *
+ * @return true if the range is now sorted, false if it gave up.
+ */
+static bool partial_insertion_sort(sort_ctx_t *    ctx,
+                                   unsigned char * begin,
+                                   unsigned char * end);
+
+/**
+ * @brief Sorts [begin, end) with heapsort, the O(n log n) fallback of pdqsort.
+ */
+static void heap_sort(sort_ctx_t *    ctx,
+                      unsigned char * begin,
+                      unsigned char * end);
+
+/**
+ * @brief Partitions [begin, end) around the element at `begin`, placing
+ * elements equal to it on the right.
+ *
+ * @param already_partitioned Set to true if no elements had to be swapped.
+ * @return Final position of the pivot.
+ */
+static unsigned char * partition_right(sort_ctx_t *    ctx,
+                                       unsigned char * begin,
+                                       unsigned char * end,
+                                       bool *          already_partitioned);
+
+/**
+ * @brief Partitions [begin, end) around the element at `begin`, placing
+ * elements equal to it on the left. Used when many elements equal the pivot.
+ *
+ * @return Final position of the pivot.
+ */
+static unsigned char * partition_left(sort_ctx_t *    ctx,
+                                      unsigned char * begin,
+                                      unsigned char * end);
+
+/**
+ * @brief Main pattern-defeating quicksort loop.
+ *
+ * @param ctx Sort state.
+ * @param begin First element.
+ * @param end One past the last element.
+ * @param bad_allowed Number of unbalanced partitions tolerated before falling
+ * back to heapsort.
+ * @param leftmost true if [begin, end) is the leftmost partition.
+ */
+static void pdq_loop(sort_ctx_t *    ctx,
+                     unsigned char * begin,
+                     unsigned char * end,
+                     int             bad_allowed,
+                     bool            leftmost);
+
+/**
+ * @brief Runs pdqsort over an array once the context is set up.
+ */
+static int pdq_sort(sort_ctx_t * ctx, void * base, size_t count);
+
+/**
+ * @brief Runs the stable merge sort over an array once the context is set up.
+ */
+static int merge_sort(sort_ctx_t * ctx, void * base, size_t count);
+
+/**
+ * @brief One unit of work of the parallel sort.
+ *
+ * A task either sorts `source[first, last)` in place, or merges the runs
+ * `source[first, middle)` and `source[middle, last)` and writes the part of
+ * the result that lands in `dest[out_first, out_last)`.
+ *
+ * @param ctx private copy of the sort state
+ * @param source array the task reads from
+ * @param dest array merged output is written to
+ * @param first start of the left run
+ * @param middle start of the right run
+ * @param last end of the right run
+ * @param out_first start of the output slice this task produces
+ * @param out_last end of the output slice this task produces
+ * @param exit_code result of the task
+ */
+typedef struct sort_task
+{
+    sort_ctx_t      ctx;
+    unsigned char * source;
+    unsigned char * dest;
+    size_t          first;
+    size_t          middle;
+    size_t          last;
+    size_t          out_first;
+    size_t          out_last;
+    int             exit_code;
+} sort_task_t;
+
+/**
+ * @brief Runs the parallel sort over an array once the context is set up.
+ */
+static int parallel_sort(sort_ctx_t * ctx,
+                         void *       base,
+                         size_t       count,
+                         int          nthreads);
+
+/**
+ * @brief Runs each task on its own thread and waits for all of them. A task
+ * whose thread cannot be created runs on the calling thread instead.
+ *
+ * @param tasks Array of tasks.
+ * @param num_tasks Number of tasks.
+ * @param routine Thread entry point, receives a `sort_task_t *`.
+ * @return E_SUCCESS if every task succeeded, E_FAILURE otherwise.
+ */
+static int run_sort_tasks(sort_task_t * tasks,
+                          size_t        num_tasks,
+                          void *(*routine)(void *));
+
+/**
+ * @brief Thread entry point that pdqsorts one slice.
+ */
+static void * sort_slice_task(void * arg);
+
+/**
+ * @brief Thread entry point that merges one slice of two adjacent runs.
+ */
+static void * merge_slice_task(void * arg);
+
+/**
+ * @brief Finds how many elements of the left run are among the first `rank`
+ * elements of the stable merge of two runs.
+ *
+ * @param ctx Sort state.
+ * @param left First element of the left run.
+ * @param left_count Number of elements in the left run.
+ * @param right First element of the right run.
+ * @param right_count Number of elements in the right run.
+ * @param rank Position in the merged output.
+ * @return Number of left run elements before `rank`.
+ */
+static size_t merge_co_rank(sort_ctx_t *    ctx,
+                            unsigned char * left,
+                            size_t          left_count,
+                            unsigned char * right,
+                            size_t          right_count,
+                            size_t          rank);
+
+/**
+ * @brief Sorts 32-bit keys by LSD radix sort using a scratch buffer.
+ */
+static void radix_sort32(uint32_t * keys, uint32_t * scratch, size_t count);
+
+/**
+ * @brief Sorts 64-bit keys by LSD radix sort using a scratch buffer.
+ */
+static void radix_sort64(uint64_t * keys, uint64_t * scratch, size_t count);
+
+int sort_pdq(void * base, size_t count, size_t elem_size, CMP_F compare_func)
+{
+    int        exit_code = E_FAILURE;
+    sort_ctx_t ctx       = { elem_size, compare_func, false, NULL };
+
+    if ((NULL == base) || (NULL == compare_func) || (0 == elem_size))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = pdq_sort(&ctx, base, count);
+
+END:
+    return exit_code;
+}
+
+int sort_pdq_ptrs(void ** array, size_t count, CMP_F compare_func)
+{
+    int        exit_code = E_FAILURE;
+    sort_ctx_t ctx       = { sizeof(void *), compare_func, true, NULL };
+
+    if ((NULL == array) || (NULL == compare_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = pdq_sort(&ctx, array, count);
+
+END:
+    return exit_code;
+}
+
+int sort_merge(void * base, size_t count, size_t elem_size, CMP_F compare_func)
+{
+    int        exit_code = E_FAILURE;
+    sort_ctx_t ctx       = { elem_size, compare_func, false, NULL };
+
+    if ((NULL == base) || (NULL == compare_func) || (0 == elem_size))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = merge_sort(&ctx, base, count);
+
+END:
+    return exit_code;
+}
+
+int sort_merge_ptrs(void ** array, size_t count, CMP_F compare_func)
+{
+    int        exit_code = E_FAILURE;
+    sort_ctx_t ctx       = { sizeof(void *), compare_func, true, NULL };
+
+    if ((NULL == array) || (NULL == compare_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = merge_sort(&ctx, array, count);
+
+END:
+    return exit_code;
+}
+
+int sort_parallel(void * base,
+                  size_t count,
+                  size_t elem_size,
+                  CMP_F  compare_func,
+                  int    nthreads)
+{
+    int        exit_code = E_FAILURE;
+    sort_ctx_t ctx       = { elem_size, compare_func, false, NULL };
+
+    if ((NULL == base) || (NULL == compare_func) || (0 == elem_size))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = parallel_sort(&ctx, base, count, nthreads);
+
+END:
+    return exit_code;
+}
+
+int sort_parallel_ptrs(void ** array,
+                       size_t  count,
+                       CMP_F   compare_func,
+                       int     nthreads)
+{
+    int        exit_code = E_FAILURE;
+    sort_ctx_t ctx       = { sizeof(void *), compare_func, true, NULL };
+
+    if ((NULL == array) || (NULL == compare_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = parallel_sort(&ctx, array, count, nthreads);
+
+END:
+    return exit_code;
+}
+
+int sort_radix_u32(uint32_t * array, size_t count)
+{
+    int        exit_code = E_FAILURE;
+    uint32_t * scratch   = NULL;
+
+    if (NULL == array)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (RADIX_THRESHOLD > count)
+    {
+        sort_small_u32(array, count);
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    scratch = malloc(count * sizeof(uint32_t));
+    if (NULL == scratch)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    radix_sort32(array, scratch, count);
+    free(scratch);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int sort_radix_u64(uint64_t * array, size_t count)
+{
+    int        exit_code = E_FAILURE;
+    uint64_t * scratch   = NULL;
+
+    if (NULL == array)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (RADIX_THRESHOLD > count)
+    {
+        sort_small_u64(array, count);
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    scratch = malloc(count * sizeof(uint64_t));
+    if (NULL == scratch)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    radix_sort64(array, scratch, count);
+    free(scratch);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int sort_radix_i32(int32_t * array, size_t count)
+{
+    int        exit_code = E_FAILURE;
+    uint32_t * keys      = (uint32_t *)array;
+
+    if (NULL == array)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // Flipping the sign bit makes two's complement order match unsigned order
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        keys[idx] ^= UINT32_C(0x80000000);
+    }
+
+    exit_code = sort_radix_u32(keys, count);
+
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        keys[idx] ^= UINT32_C(0x80000000);
+    }
+
+END:
+    return exit_code;
+}
+
+int sort_radix_i64(int64_t * array, size_t count)
+{
+    int        exit_code = E_FAILURE;
+    uint64_t * keys      = (uint64_t *)array;
+
+    if (NULL == array)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        keys[idx] ^= UINT64_C(0x8000000000000000);
+    }
+
+    exit_code = sort_radix_u64(keys, count);
+
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        keys[idx] ^= UINT64_C(0x8000000000000000);
+    }
+
+END:
+    return exit_code;
+}
+
+int sort_radix_float(float * array, size_t count)
+{
+    int        exit_code = E_FAILURE;
+    uint32_t * keys      = NULL;
+    uint32_t   mask      = 0;
+
+    if (NULL == array)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (2 > count)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    keys = malloc(count * sizeof(uint32_t));
+    if (NULL == keys)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    // Negative floats get every bit flipped, positive ones only the sign bit,
+    // so that the unsigned order of the bit patterns is the numeric order
+    memcpy(keys, array, count * sizeof(uint32_t));
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        mask = (0 != (keys[idx] >> 31)) ? UINT32_MAX : UINT32_C(0x80000000);
+        keys[idx] ^= mask;
+    }
+
+    exit_code = sort_radix_u32(keys, count);
+
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        mask = (0 != (keys[idx] >> 31)) ? UINT32_C(0x80000000) : UINT32_MAX;
+        keys[idx] ^= mask;
+    }
+    memcpy(array, keys, count * sizeof(uint32_t));
+
+    free(keys);
+
+END:
+    return exit_code;
+}
+
+int sort_radix_double(double * array, size_t count)
+{
+    int        exit_code = E_FAILURE;
+    uint64_t * keys      = NULL;
+    uint64_t   mask      = 0;
+
+    if (NULL == array)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (2 > count)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    keys = malloc(count * sizeof(uint64_t));
+    if (NULL == keys)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    memcpy(keys, array, count * sizeof(uint64_t));
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        mask = (0 != (keys[idx] >> 63)) ? UINT64_MAX
+                                        : UINT64_C(0x8000000000000000);
+        keys[idx] ^= mask;
+    }
+
+    exit_code = sort_radix_u64(keys, count);
+
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        mask = (0 != (keys[idx] >> 63)) ? UINT64_C(0x8000000000000000)
+                                        : UINT64_MAX;
+        keys[idx] ^= mask;
+    }
+    memcpy(array, keys, count * sizeof(uint64_t));
+
+    free(keys);
+
+END:
+    return exit_code;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static bool sort_less(sort_ctx_t * ctx, void * first, void * second)
+{
+    if (ctx->indirect)
+    {
+        first  = *(void **)first;
+        second = *(void **)second;
+    }
+
+    return LESS_THAN == ctx->compare_func(first, second);
+}
+
+static void sort_swap(void * first, void * second, size_t elem_size)
+{
+    unsigned char   chunk[SWAP_CHUNK];
+    unsigned char * lhs = first;
+    unsigned char * rhs = second;
+
+    while (0 < elem_size)
+    {
+        size_t step = (SWAP_CHUNK < elem_size) ? SWAP_CHUNK : elem_size;
+
+        memcpy(chunk, lhs, step);
+        memcpy(lhs, rhs, step);
+        memcpy(rhs, chunk, step);
+
+        lhs += step;
+        rhs += step;
+        elem_size -= step;
+    }
+}
+
+static void sort2(sort_ctx_t *    ctx,
+                  unsigned char * first,
+                  unsigned char * second)
+{
+    if (sort_less(ctx, second, first))
+    {
+        sort_swap(first, second, ctx->elem_size);
+    }
+}
+
+static void sort3(sort_ctx_t *    ctx,
+                  unsigned char * first,
+                  unsigned char * second,
+                  unsigned char * third)
+{
+    sort2(ctx, first, second);
+    sort2(ctx, second, third);
+    sort2(ctx, first, second);
+}
+
+static void insertion_sort(sort_ctx_t *    ctx,
+                           unsigned char * begin,
+                           unsigned char * end,
+                           bool            guarded)
+{
+    size_t size = ctx->elem_size;
+
+    if (begin == end)
+    {
+        return;
+    }
+
+    for (unsigned char * cur = begin + size; cur != end; cur += size)
+    {
+        unsigned char * sift   = cur;
+        unsigned char * sift_1 = cur - size;
+
+        if (!sort_less(ctx, sift, sift_1))
+        {
+            continue;
+        }
+
+        // Hold the element aside and slide larger ones up until its slot
+        memcpy(ctx->scratch, sift, size);
+        do
+        {
+            memcpy(sift, sift_1, size);
+            sift -= size;
+            sift_1 -= size;
+        } while ((!guarded || (sift != begin))
+                 && sort_less(ctx, ctx->scratch, sift_1));
+        memcpy(sift, ctx->scratch, size);
+    }
+}
+
+static bool partial_insertion_sort(sort_ctx_t *    ctx,
+                                   unsigned char * begin,
+                                   unsigned char * end)
+{
+    size_t size  = ctx->elem_size;
+    size_t limit = 0;
+
+    if (begin == end)
+    {
+        return true;
+    }
+
+    for (unsigned char * cur = begin + size; cur != end; cur += size)
+    {
+        unsigned char * sift   = cur;
+        unsigned char * sift_1 = cur - size;
+
+        if (PARTIAL_INSERTION_SORT_LIMIT < limit)
+        {
+            return false;
+        }
+
+        if (!sort_less(ctx, sift, sift_1))
+        {
+            continue;
+        }
+
+        memcpy(ctx->scratch, sift, size);
+        do
+        {
+            memcpy(sift, sift_1, size);
+            sift -= size;
+            sift_1 -= size;
+        } while ((sift != begin) && sort_less(ctx, ctx->scratch, sift_1));
+        memcpy(sift, ctx->scratch, size);
+
+        limit += (size_t)(cur - sift) / size;
+    }
+
+    return true;
+}
+
+static void heap_sort(sort_ctx_t *    ctx,
+                      unsigned char * begin,
+                      unsigned char * end)
+{
+    size_t size  = ctx->elem_size;
+    size_t count = (size_t)(end - begin) / size;
+
+    for (size_t idx = count / 2; 0 < idx; idx--)
+    {
+        size_t root = idx - 1;
+
+        for (size_t child = (2 * root) + 1; child < count;
+             child        = (2 * root) + 1)
+        {
+            if ((child + 1 < count)
+                && sort_less(ctx, begin + (child * size),
+                             begin + ((child + 1) * size)))
+            {
+                child++;
+            }
+            if (!sort_less(ctx, begin + (root * size), begin + (child * size)))
+            {
+                break;
+            }
+            sort_swap(begin + (root * size), begin + (child * size), size);
+            root = child;
+        }
+    }
+
+    for (size_t last = count - 1; 0 < last; last--)
+    {
+        size_t root = 0;
+
+        sort_swap(begin, begin + (last * size), size);
+
+        for (size_t child = 1; child < last; child = (2 * root) + 1)
+        {
+            if ((child + 1 < last)
+                && sort_less(ctx, begin + (child * size),
+                             begin + ((child + 1) * size)))
+            {
+                child++;
+            }
+            if (!sort_less(ctx, begin + (root * size), begin + (child * size)))
+            {
+                break;
+            }
+            sort_swap(begin + (root * size), begin + (child * size), size);
+            root = child;
+        }
+    }
+}
+
+static unsigned char * partition_right(sort_ctx_t *    ctx,
+                                       unsigned char * begin,
+                                       unsigned char * end,
+                                       bool *          already_partitioned)
+{
+    size_t          size  = ctx->elem_size;
+    unsigned char * pivot = ctx->scratch;
+    unsigned char * first = begin;
+    unsigned char * last  = end;
+    unsigned char * pivot_pos;
+
+    memcpy(pivot, begin, size);
+
+    // The median-of-3 guarantees an element >= pivot exists to stop on
+    do
+    {
+        first += size;
+    } while (sort_less(ctx, first, pivot));
+
+    // Without a swap yet there is no sentinel on the right, so bound the scan
+    if (first - size == begin)
+    {
+        while (first < last)
+        {
+            last -= size;
+            if (sort_less(ctx, last, pivot))
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        do
+        {
+            last -= size;
+        } while (!sort_less(ctx, last, pivot));
+    }
+
+    *already_partitioned = (first >= last);
+
+    while (first < last)
+    {
+        sort_swap(first, last, size);
+        do
+        {
+            first += size;
+        } while (sort_less(ctx, first, pivot));
+        do
+        {
+            last -= size;
+        } while (!sort_less(ctx, last, pivot));
+    }
+
+    pivot_pos = first - size;
+    memcpy(begin, pivot_pos, size);
+    memcpy(pivot_pos, pivot, size);
+
+    return pivot_pos;
+}
+
+static unsigned char * partition_left(sort_ctx_t *    ctx,
+                                      unsigned char * begin,
+                                      unsigned char * end)
+{
+    size_t          size  = ctx->elem_size;
+    unsigned char * pivot = ctx->scratch;
+    unsigned char * first = begin;
+    unsigned char * last  = end;
+
+    memcpy(pivot, begin, size);
+
+    do
+    {
+        last -= size;
+    } while (sort_less(ctx, pivot, last));
+
+    if (last + size == end)
+    {
+        while (first < last)
+        {
+            first += size;
+            if (sort_less(ctx, pivot, first))
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        do
+        {
+            first += size;
+        } while (!sort_less(ctx, pivot, first));
+    }
+
+    while (first < last)
+    {
+        sort_swap(first, last, size);
+        do
+        {
+            last -= size;
+        } while (sort_less(ctx, pivot, last));
+        do
+        {
+            first += size;
+        } while (!sort_less(ctx, pivot, first));
+    }
+
+    memcpy(begin, last, size);
+    memcpy(last, pivot, size);
+
+    return last;
+}
+
+static void pdq_loop(sort_ctx_t *    ctx,
+                     unsigned char * begin,
+                     unsigned char * end,
+                     int             bad_allowed,
+                     bool            leftmost)
+{
+    size_t es = ctx->elem_size;
+
+    for (;;)
+    {
+        size_t          count               = (size_t)(end - begin) / es;
+        size_t          half                = count / 2;
+        bool            already_partitioned = false;
+        unsigned char * pivot_pos           = NULL;
+        size_t          l_size              = 0;
+        size_t          r_size              = 0;
+
+        if (INSERTION_SORT_THRESHOLD > count)
+        {
+            insertion_sort(ctx, begin, end, leftmost);
+            return;
+        }
+
+        // Pick the pivot with a median of 3, or a ninther for large ranges,
+        // and move it to the start of the range
+        if (NINTHER_THRESHOLD < count)
+        {
+            sort3(ctx, begin, begin + (half * es), end - es);
+            sort3(ctx, begin + es, begin + ((half - 1) * es), end - (2 * es));
+            sort3(ctx,
+                  begin + (2 * es),
+                  begin + ((half + 1) * es),
+                  end - (3 * es));
+            sort3(ctx,
+                  begin + ((half - 1) * es),
+                  begin + (half * es),
+                  begin + ((half + 1) * es));
+            sort_swap(begin, begin + (half * es), es);
+        }
+        else
+        {
+            sort3(ctx, begin + (half * es), begin, end - es);
+        }
+
+        // If the pivot equals the element before this range, every element
+        // equal to it can be put to the left and skipped
+        if (!leftmost && !sort_less(ctx, begin - es, begin))
+        {
+            begin = partition_left(ctx, begin, end) + es;
+            continue;
+        }
+
+        pivot_pos = partition_right(ctx, begin, end, &already_partitioned);
+        l_size    = (size_t)(pivot_pos - begin) / es;
+        r_size    = (size_t)(end - (pivot_pos + es)) / es;
+
+        if ((l_size < count / 8) || (r_size < count / 8))
+        {
+            // Too many bad partitions means an adversarial input
+            if (0 == --bad_allowed)
+            {
+                heap_sort(ctx, begin, end);
+                return;
+            }
+
+            // Break up patterns by swapping a few elements around
+            if (INSERTION_SORT_THRESHOLD <= l_size)
+            {
+                sort_swap(begin, begin + ((l_size / 4) * es), es);
+                sort_swap(pivot_pos - es, pivot_pos - ((l_size / 4) * es), es);
+                if (NINTHER_THRESHOLD < l_size)
+                {
+                    sort_swap(begin + es, begin + ((l_size / 4 + 1) * es), es);
+                    sort_swap(begin + (2 * es),
+                              begin + ((l_size / 4 + 2) * es),
+                              es);
+                    sort_swap(pivot_pos - (2 * es),
+                              pivot_pos - ((l_size / 4 + 1) * es),
+                              es);
+                    sort_swap(pivot_pos - (3 * es),
+                              pivot_pos - ((l_size / 4 + 2) * es),
+                              es);
+                }
+            }
+
+            if (INSERTION_SORT_THRESHOLD <= r_size)
+            {
+                sort_swap(pivot_pos + es,
+                          pivot_pos + ((1 + r_size / 4) * es),
+                          es);
+                sort_swap(end - es, end - ((r_size / 4) * es), es);
+                if (NINTHER_THRESHOLD < r_size)
+                {
+                    sort_swap(pivot_pos + (2 * es),
+                              pivot_pos + ((2 + r_size / 4) * es),
+                              es);
+                    sort_swap(pivot_pos + (3 * es),
+                              pivot_pos + ((3 + r_size / 4) * es),
+                              es);
+                    sort_swap(end - (2 * es),
+                              end - ((1 + r_size / 4) * es),
+                              es);
+                    sort_swap(end - (3 * es),
+                              end - ((2 + r_size / 4) * es),
+                              es);
+                }
+            }
+        }
+        else if (already_partitioned
+                 && partial_insertion_sort(ctx, begin, pivot_pos)
+                 && partial_insertion_sort(ctx, pivot_pos + es, end))
+        {
+            // A balanced partition that needed no swaps is likely sorted
+            return;
+        }
+
+        // Recurse into the left part, loop on the right one
+        pdq_loop(ctx, begin, pivot_pos, bad_allowed, leftmost);
+        begin    = pivot_pos + es;
+        leftmost = false;
+    }
+}
+
+static int pdq_sort(sort_ctx_t * ctx, void * base, size_t count)
+{
+    int exit_code   = E_FAILURE;
+    int bad_allowed = 0;
+
+    if (2 > count)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    ctx->scratch = malloc(ctx->elem_size);
+    if (NULL == ctx->scratch)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    // Allow log2(count) bad partitions before switching to heapsort
+    for (size_t len = count; 1 < len; len >>= 1)
+    {
+        bad_allowed++;
+    }
+
+    pdq_loop(ctx,
+             base,
+             (unsigned char *)base + (count * ctx->elem_size),
+             bad_allowed,
+             true);
+
+    free(ctx->scratch);
+    ctx->scratch = NULL;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+static int merge_sort(sort_ctx_t * ctx, void * base, size_t count)
+{
+    int             exit_code = E_FAILURE;
+    size_t          es        = ctx->elem_size;
+    unsigned char * buffer    = NULL;
+    unsigned char * source    = base;
+    unsigned char * dest      = NULL;
+
+    if (2 > count)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    buffer = malloc((count * es) + es);
+    if (NULL == buffer)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    // The last slot of the buffer doubles as insertion sort scratch space
+    ctx->scratch = buffer + (count * es);
+    dest         = buffer;
+
+    // Sort short runs in place first, insertion sort keeps them stable
+    for (size_t start = 0; start < count; start += MERGE_RUN_LENGTH)
+    {
+        size_t stop = start + MERGE_RUN_LENGTH;
+
+        if (stop > count)
+        {
+            stop = count;
+        }
+        insertion_sort(ctx, source + (start * es), source + (stop * es), true);
+    }
+
+    // Merge pairs of runs back and forth between the array and the buffer
+    for (size_t width = MERGE_RUN_LENGTH; width < count; width *= 2)
+    {
+        unsigned char * swap = NULL;
+
+        for (size_t start = 0; start < count; start += 2 * width)
+        {
+            size_t mid   = (start + width < count) ? start + width : count;
+            size_t stop  = (mid + width < count) ? mid + width : count;
+            size_t left  = start;
+            size_t right = mid;
+            size_t out   = start;
+
+            // Taking from the left run on ties keeps the merge stable
+            while ((left < mid) && (right < stop))
+            {
+                if (sort_less(ctx, source + (right * es), source + (left * es)))
+                {
+                    memcpy(dest + (out * es), source + (right * es), es);
+                    right++;
+                }
+                else
+                {
+                    memcpy(dest + (out * es), source + (left * es), es);
+                    left++;
+                }
+                out++;
+            }
+
+            memcpy(dest + (out * es), source + (left * es), (mid - left) * es);
+            out += mid - left;
+            memcpy(dest + (out * es),
+                   source + (right * es),
+                   (stop - right) * es);
+        }
+
+        swap   = source;
+        source = dest;
+        dest   = swap;
+    }
+
+    if (source != base)
+    {
+        memcpy(base, source, count * es);
+    }
+
+    free(buffer);
+    ctx->scratch = NULL;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+static int parallel_sort(sort_ctx_t * ctx,
+                         void *       base,
+                         size_t       count,
+                         int          nthreads)
+{
+    int             exit_code = E_FAILURE;
+    size_t          es        = ctx->elem_size;
+    size_t          num_runs  = 0;
+    size_t *        bounds    = NULL;
+    sort_task_t *   tasks     = NULL;
+    unsigned char * buffer    = NULL;
+    unsigned char * source    = base;
+    unsigned char * dest      = NULL;
+
+    if (0 >= nthreads)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads    = (0 < online) ? (int)online : 1;
+    }
+
+    // Give every thread at least PARALLEL_SORT_CUTOFF elements, small inputs
+    // are cheaper to sort on the calling thread
+    num_runs = count / PARALLEL_SORT_CUTOFF;
+    if (num_runs > (size_t)nthreads)
+    {
+        num_runs = (size_t)nthreads;
+    }
+    if (2 > num_runs)
+    {
+        exit_code = pdq_sort(ctx, base, count);
+        goto END;
+    }
+
+    bounds = calloc(num_runs + 1, sizeof(size_t));
+    tasks  = calloc((size_t)nthreads + num_runs + 1, sizeof(sort_task_t));
+    buffer = malloc(count * es);
+    if ((NULL == bounds) || (NULL == tasks) || (NULL == buffer))
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    // Sort equal slices of the array, one per thread
+    for (size_t run = 0; run <= num_runs; run++)
+    {
+        bounds[run] = (count / num_runs) * run;
+    }
+    bounds[num_runs] = count;
+
+    for (size_t run = 0; run < num_runs; run++)
+    {
+        tasks[run].ctx    = *ctx;
+        tasks[run].source = source;
+        tasks[run].first  = bounds[run];
+        tasks[run].last   = bounds[run + 1];
+    }
+
+    exit_code = run_sort_tasks(tasks, num_runs, sort_slice_task);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to sort slices.");
+        goto END;
+    }
+
+    // Merge adjacent runs pairwise, splitting each merge across the threads
+    // so that every round keeps all of them busy
+    dest = buffer;
+    while (1 < num_runs)
+    {
+        size_t          num_pairs = (num_runs + 1) / 2;
+        size_t          parts     = (size_t)nthreads / num_pairs;
+        size_t          num_tasks = 0;
+        unsigned char * swap      = NULL;
+
+        if (0 == parts)
+        {
+            parts = 1;
+        }
+
+        for (size_t pair = 0; pair < num_pairs; pair++)
+        {
+            size_t first  = bounds[2 * pair];
+            size_t middle = bounds[(2 * pair) + 1];
+            size_t last   = ((2 * pair) + 2 <= num_runs)
+                                ? bounds[(2 * pair) + 2]
+                                : middle;
+            size_t length = last - first;
+
+            // A trailing run without a partner is merged with an empty run
+            for (size_t part = 0; part < parts; part++)
+            {
+                sort_task_t * task = &tasks[num_tasks++];
+
+                task->ctx       = *ctx;
+                task->source    = source;
+                task->dest      = dest;
+                task->first     = first;
+                task->middle    = middle;
+                task->last      = last;
+                task->out_first = first + ((length / parts) * part);
+                task->out_last  = (part + 1 == parts)
+                                      ? last
+                                      : first + ((length / parts) * (part + 1));
+            }
+
+            bounds[pair] = first;
+        }
+        bounds[num_pairs] = count;
+
+        exit_code = run_sort_tasks(tasks, num_tasks, merge_slice_task);
+        if (E_SUCCESS != exit_code)
+        {
+            print_error("Unable to merge slices.");
+            goto END;
+        }
+
+        num_runs = num_pairs;
+        swap     = source;
+        source   = dest;
+        dest     = swap;
+    }
+
+    if (source != base)
+    {
+        memcpy(base, source, count * es);
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    free(bounds);
+    free(tasks);
+    free(buffer);
+    return exit_code;
+}
+
+static int run_sort_tasks(sort_task_t * tasks,
+                          size_t        num_tasks,
+                          void *(*routine)(void *))
+{
+    int         exit_code = E_SUCCESS;
+    pthread_t * threads   = NULL;
+    bool *      started   = NULL;
+
+    threads = calloc(num_tasks, sizeof(pthread_t));
+    started = calloc(num_tasks, sizeof(bool));
+    if ((NULL == threads) || (NULL == started))
+    {
+        print_error("CMR failure.");
+        exit_code = E_FAILURE;
+        goto END;
+    }
+
+    // The calling thread takes the first task itself
+    for (size_t idx = 1; idx < num_tasks; idx++)
+    {
+        started[idx] =
+            (0 == pthread_create(&threads[idx], NULL, routine, &tasks[idx]));
+    }
+
+    for (size_t idx = 0; idx < num_tasks; idx++)
+    {
+        if (started[idx])
+        {
+            pthread_join(threads[idx], NULL);
+        }
+        else
+        {
+            routine(&tasks[idx]);
+        }
+
+        if (E_SUCCESS != tasks[idx].exit_code)
+        {
+            exit_code = E_FAILURE;
+        }
+    }
+
+END:
+    free(threads);
+    free(started);
+    return exit_code;
+}
+
+static void * sort_slice_task(void * arg)
+{
+    sort_task_t * task = arg;
+    size_t        es   = task->ctx.elem_size;
+
+    task->exit_code = pdq_sort(&task->ctx,
+                               task->source + (task->first * es),
+                               task->last - task->first);
+
+    return NULL;
+}
+
+static void * merge_slice_task(void * arg)
+{
+    sort_task_t *   task        = arg;
+    sort_ctx_t *    ctx         = &task->ctx;
+    size_t          es          = ctx->elem_size;
+    unsigned char * left        = task->source + (task->first * es);
+    unsigned char * right       = task->source + (task->middle * es);
+    size_t          left_count  = task->middle - task->first;
+    size_t          right_count = task->last - task->middle;
+    size_t          out         = task->out_first;
+    size_t          left_idx    = 0;
+    size_t          right_idx   = 0;
+    size_t          left_end    = 0;
+    size_t          right_end   = 0;
+
+    // Locate where this task's output slice starts and ends in both runs
+    left_idx  = merge_co_rank(ctx,
+                             left,
+                             left_count,
+                             right,
+                             right_count,
+                             task->out_first - task->first);
+    right_idx = (task->out_first - task->first) - left_idx;
+    left_end  = merge_co_rank(ctx,
+                             left,
+                             left_count,
+                             right,
+                             right_count,
+                             task->out_last - task->first);
+    right_end = (task->out_last - task->first) - left_end;
+
+    while ((left_idx < left_end) && (right_idx < right_end))
+    {
+        if (sort_less(ctx, right + (right_idx * es), left + (left_idx * es)))
+        {
+            memcpy(task->dest + (out * es), right + (right_idx * es), es);
+            right_idx++;
+        }
+        else
+        {
+            memcpy(task->dest + (out * es), left + (left_idx * es), es);
+            left_idx++;
+        }
+        out++;
+    }
+
+    memcpy(task->dest + (out * es),
+           left + (left_idx * es),
+           (left_end - left_idx) * es);
+    out += left_end - left_idx;
+    memcpy(task->dest + (out * es),
+           right + (right_idx * es),
+           (right_end - right_idx) * es);
+
+    task->exit_code = E_SUCCESS;
+    return NULL;
+}
+
+static size_t merge_co_rank(sort_ctx_t *    ctx,
+                            unsigned char * left,
+                            size_t          left_count,
+                            unsigned char * right,
+                            size_t          right_count,
+                            size_t          rank)
+{
+    size_t es   = ctx->elem_size;
+    size_t low  = (rank > right_count) ? rank - right_count : 0;
+    size_t high = (rank < left_count) ? rank : left_count;
+
+    // Smallest split where the last right element taken sorts before the
+    // next left element, ties going to the left run
+    while (low < high)
+    {
+        size_t mid       = low + ((high - low) / 2);
+        size_t right_idx = rank - mid;
+
+        if ((0 == right_idx)
+            || sort_less(
+                ctx, right + ((right_idx - 1) * es), left + (mid * es)))
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1;
+        }
+    }
+
+    return low;
+}
+
+static void radix_sort32(uint32_t * keys, uint32_t * scratch, size_t count)
+{
+    size_t     histogram[sizeof(uint32_t)][RADIX_BUCKETS] = { { 0 } };
+    uint32_t * source                                     = keys;
+    uint32_t * dest                                       = scratch;
+
+    // Count every digit of every key in a single pass
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        for (size_t digit = 0; digit < sizeof(uint32_t); digit++)
+        {
+            size_t bucket =
+                (keys[idx] >> (digit * RADIX_BITS)) & (RADIX_BUCKETS - 1);
+            histogram[digit][bucket]++;
+        }
+    }
+
+    for (size_t digit = 0; digit < sizeof(uint32_t); digit++)
+    {
+        size_t   offset = 0;
+        unsigned shift  = digit * RADIX_BITS;
+        uint32_t first  = (source[0] >> shift) & (RADIX_BUCKETS - 1);
+
+        // Skip passes where every key has the same digit
+        if (count == histogram[digit][first])
+        {
+            continue;
+        }
+
+        for (size_t bucket = 0; bucket < RADIX_BUCKETS; bucket++)
+        {
+            size_t bucket_size       = histogram[digit][bucket];
+            histogram[digit][bucket] = offset;
+            offset += bucket_size;
+        }
+
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            uint32_t bucket = (source[idx] >> shift) & (RADIX_BUCKETS - 1);
+            dest[histogram[digit][bucket]++] = source[idx];
+        }
+
+        uint32_t * swap = source;
+        source          = dest;
+        dest            = swap;
+    }
+
+    if (source != keys)
+    {
+        memcpy(keys, source, count * sizeof(uint32_t));
+    }
+}
+
+static void radix_sort64(uint64_t * keys, uint64_t * scratch, size_t count)
+{
+    size_t     histogram[sizeof(uint64_t)][RADIX_BUCKETS] = { { 0 } };
+    uint64_t * source                                     = keys;
+    uint64_t * dest                                       = scratch;
+
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        for (size_t digit = 0; digit < sizeof(uint64_t); digit++)
+        {
+            size_t bucket =
+                (keys[idx] >> (digit * RADIX_BITS)) & (RADIX_BUCKETS - 1);
+            histogram[digit][bucket]++;
+        }
+    }
+
+    for (size_t digit = 0; digit < sizeof(uint64_t); digit++)
+    {
+        size_t   offset = 0;
+        unsigned shift  = digit * RADIX_BITS;
+        uint64_t first  = (source[0] >> shift) & (RADIX_BUCKETS - 1);
+
+        if (count == histogram[digit][first])
+        {
+            continue;
+        }
+
+        for (size_t bucket = 0; bucket < RADIX_BUCKETS; bucket++)
+        {
+            size_t bucket_size       = histogram[digit][bucket];
+            histogram[digit][bucket] = offset;
+            offset += bucket_size;
+        }
+
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            uint64_t bucket = (source[idx] >> shift) & (RADIX_BUCKETS - 1);
+            dest[histogram[digit][bucket]++] = source[idx];
+        }
+
+        uint64_t * swap = source;
+        source          = dest;
+        dest            = swap;
+    }
+
+    if (source != keys)
+    {
+        memcpy(keys, source, count * sizeof(uint64_t));
+    }
+}
+
+/*** end of file ***/
@@ -0,0 +1,821 @@
+#include <stddef.h> // offsetof()
+#include <string.h> // memmove(), memcpy()
+
+#include "sorts.h"
+#include "unrolled_list.h"
+#include "utilities.h"
+
+#define ULIST_DEFAULT_NODE_BYTES (2 * ULIST_CACHE_LINE) // Default node size
+
+/**
+ * @brief Returns the allocation size of a node holding `items` items,
+ * rounded up to whole cache lines.
+ *
+ * @param items Number of items the node must hold.
+ * @return Size of the node in bytes.
+ */
+static size_t ulist_node_bytes(uint32_t items);
+
+/**
+ * @brief Allocates an empty, unlinked node on a cache line boundary.
+ *
+ * @param list Pointer to the list the node is for.
+ * @return Pointer to the new node, or NULL on failure.
+ */
+static ulist_node_t * ulist_node_new(ulist_t * list);
+
+/**
+ * @brief Links a node into the list directly after another node.
+ *
+ * @param list Pointer to the list.
+ * @param prev Node to link after, or NULL to link at the head.
+ * @param node Node to link.
+ */
+static void ulist_link_after(ulist_t *      list,
+                             ulist_node_t * prev,
+                             ulist_node_t * node);
+
+/**
+ * @brief Unlinks a node from the list and frees it. Its items are not freed.
+ *
+ * @param list Pointer to the list.
+ * @param node Node to unlink.
+ */
+static void ulist_unlink_node(ulist_t * list, ulist_node_t * node);
+
+/**
+ * @brief Finds the node holding the item at a position, skipping whole nodes
+ * from whichever end of the list is nearer.
+ *
+ * @param list Pointer to the list.
+ * @param position Position of the item, less than the list size.
+ * @param offset Receives the index of the item within the node.
+ * @return Pointer to the node holding the item.
+ */
+static ulist_node_t * ulist_locate(ulist_t *  list,
+                                   uint32_t   position,
+                                   uint32_t * offset);
+
+/**
+ * @brief Inserts an item into a node, splitting the node in half first if it
+ * is full.
+ *
+ * @param list Pointer to the list.
+ * @param node Node to insert into.
+ * @param offset Index within the node to insert at, up to its count.
+ * @param data Data to insert.
+ * @return Status code indicating success (E_SUCCESS) or failure (E_FAILURE).
+ */
+static int ulist_insert_at(ulist_t *      list,
+                           ulist_node_t * node,
+                           uint32_t       offset,
+                           void *         data);
+
+/**
+ * @brief Removes an item from a node, then frees the node if it is empty or
+ * merges it with, or refills it from, a neighbour if it is under half full.
+ *
+ * @param list Pointer to the list.
+ * @param node Node holding the item.
+ * @param offset Index of the item within the node.
+ * @return The removed data.
+ */
+static void * ulist_remove_at(ulist_t *      list,
+                              ulist_node_t * node,
+                              uint32_t       offset);
+
+ulist_t * ulist_new(FREE_F free_func, CMP_F comp_func, uint32_t node_items)
+{
+    ulist_t * new_list = NULL;
+    size_t    bytes    = 0;
+
+    if ((NULL == free_func) || (NULL == comp_func))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    new_list = calloc(1, sizeof(ulist_t));
+    if (NULL == new_list)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    // Use every slot that fits in the cache lines the node occupies
+    bytes = (0 == node_items) ? ULIST_DEFAULT_NODE_BYTES
+                              : ulist_node_bytes(node_items);
+
+    new_list->size         = 0;
+    new_list->head         = NULL;
+    new_list->tail         = NULL;
+    new_list->node_items   = (uint32_t)((bytes - offsetof(ulist_node_t, items))
+                                      / sizeof(void *));
+    new_list->custom_free  = free_func;
+    new_list->compare_func = comp_func;
+
+END:
+    return new_list;
+}
+
+int ulist_push_head(ulist_t * list, void * data)
+{
+    int            exit_code = E_FAILURE;
+    ulist_node_t * node      = NULL;
+
+    if ((NULL == list) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // Start a new node rather than split a full head, so runs of head
+    // pushes leave full nodes behind
+    node = list->head;
+    if ((NULL == node) || (list->node_items == node->count))
+    {
+        node = ulist_node_new(list);
+        if (NULL == node)
+        {
+            print_error("Unable to create new node.");
+            goto END;
+        }
+        ulist_link_after(list, NULL, node);
+    }
+
+    exit_code = ulist_insert_at(list, node, 0, data);
+
+END:
+    return exit_code;
+}
+
+int ulist_push_tail(ulist_t * list, void * data)
+{
+    int            exit_code = E_FAILURE;
+    ulist_node_t * node      = NULL;
+
+    if ((NULL == list) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    node = list->tail;
+    if ((NULL == node) || (list->node_items == node->count))
+    {
+        node = ulist_node_new(list);
+        if (NULL == node)
+        {
+            print_error("Unable to create new node.");
+            goto END;
+        }
+        ulist_link_after(list, list->tail, node);
+    }
+
+    exit_code = ulist_insert_at(list, node, node->count, data);
+
+END:
+    return exit_code;
+}
+
+int ulist_push_position(ulist_t * list, void * data, uint32_t position)
+{
+    int            exit_code = E_FAILURE;
+    ulist_node_t * node      = NULL;
+    uint32_t       offset    = 0;
+
+    if ((NULL == list) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (position > list->size)
+    {
+        print_error("Position out of bounds.");
+        goto END;
+    }
+
+    if (0 == position)
+    {
+        exit_code = ulist_push_head(list, data);
+        goto END;
+    }
+
+    if (position == list->size)
+    {
+        exit_code = ulist_push_tail(list, data);
+        goto END;
+    }
+
+    node      = ulist_locate(list, position, &offset);
+    exit_code = ulist_insert_at(list, node, offset, data);
+
+END:
+    return exit_code;
+}
+
+int ulist_emptycheck(ulist_t * list)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 == list->size)
+    {
+        exit_code = E_SUCCESS;
+    }
+
+END:
+    return exit_code;
+}
+
+void * ulist_pop_head(ulist_t * list)
+{
+    void * data = NULL;
+
+    if ((NULL == list) || (NULL == list->head))
+    {
+        print_error("List is empty.");
+        goto END;
+    }
+
+    data = ulist_remove_at(list, list->head, 0);
+
+END:
+    return data;
+}
+
+void * ulist_pop_tail(ulist_t * list)
+{
+    void * data = NULL;
+
+    if ((NULL == list) || (NULL == list->tail))
+    {
+        print_error("List is empty.");
+        goto END;
+    }
+
+    data = ulist_remove_at(list, list->tail, list->tail->count - 1);
+
+END:
+    return data;
+}
+
+void * ulist_pop_position(ulist_t * list, uint32_t position)
+{
+    void *         data   = NULL;
+    ulist_node_t * node   = NULL;
+    uint32_t       offset = 0;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (position >= list->size)
+    {
+        print_error("Position out of bounds.");
+        goto END;
+    }
+
+    node = ulist_locate(list, position, &offset);
+    data = ulist_remove_at(list, node, offset);
+
+END:
+    return data;
+}
+
+int ulist_remove_head(ulist_t * list)
+{
+    int    exit_code = E_FAILURE;
+    void * data      = NULL;
+
+    data = ulist_pop_head(list);
+    if (NULL == data)
+    {
+        goto END;
+    }
+
+    list->custom_free(data);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int ulist_remove_tail(ulist_t * list)
+{
+    int    exit_code = E_FAILURE;
+    void * data      = NULL;
+
+    data = ulist_pop_tail(list);
+    if (NULL == data)
+    {
+        goto END;
+    }
+
+    list->custom_free(data);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int ulist_remove_position(ulist_t * list, uint32_t position)
+{
+    int    exit_code = E_FAILURE;
+    void * data      = NULL;
+
+    data = ulist_pop_position(list, position);
+    if (NULL == data)
+    {
+        goto END;
+    }
+
+    list->custom_free(data);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * ulist_peek_head(ulist_t * list)
+{
+    void * data = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (NULL != list->head)
+    {
+        data = list->head->items[0];
+    }
+
+END:
+    return data;
+}
+
+void * ulist_peek_tail(ulist_t * list)
+{
+    void * data = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (NULL != list->tail)
+    {
+        data = list->tail->items[list->tail->count - 1];
+    }
+
+END:
+    return data;
+}
+
+void * ulist_peek_position(ulist_t * list, uint32_t position)
+{
+    void *         data   = NULL;
+    ulist_node_t * node   = NULL;
+    uint32_t       offset = 0;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (position >= list->size)
+    {
+        print_error("Position out of bounds.");
+        goto END;
+    }
+
+    node = ulist_locate(list, position, &offset);
+    data = node->items[offset];
+
+END:
+    return data;
+}
+
+int ulist_remove_data(ulist_t * list, void * item_to_remove)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list) || (NULL == item_to_remove))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (ulist_node_t * node = list->head; NULL != node; node = node->next)
+    {
+        for (uint32_t idx = 0; idx < node->count; idx++)
+        {
+            if (EQUAL == list->compare_func(item_to_remove, node->items[idx]))
+            {
+                list->custom_free(ulist_remove_at(list, node, idx));
+                exit_code = E_SUCCESS;
+                goto END;
+            }
+        }
+    }
+
+    print_error("Item not found.");
+END:
+    return exit_code;
+}
+
+int ulist_foreach_call(ulist_t * list, ACT_F action_function)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list) || (NULL == action_function))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (ulist_node_t * node = list->head; NULL != node; node = node->next)
+    {
+        for (uint32_t idx = 0; idx < node->count; idx++)
+        {
+            action_function(node->items[idx]);
+        }
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * ulist_find_first_occurrence(ulist_t * list, void * search_data)
+{
+    void * found_data = NULL;
+
+    if ((NULL == list) || (NULL == search_data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (ulist_node_t * node = list->head; NULL != node; node = node->next)
+    {
+        for (uint32_t idx = 0; idx < node->count; idx++)
+        {
+            if (EQUAL == list->compare_func(search_data, node->items[idx]))
+            {
+                found_data = node->items[idx];
+                goto END;
+            }
+        }
+    }
+
+END:
+    return found_data;
+}
+
+int ulist_sort(ulist_t * list)
+{
+    int      exit_code  = E_FAILURE;
+    void **  data_array = NULL;
+    uint32_t position   = 0;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (2 > list->size)
+    {
+        exit_code = E_SUCCESS;
+        goto END;
+    }
+
+    data_array = calloc(list->size, sizeof(void *));
+    if (NULL == data_array)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    // Each node is already a small array, so gather them with block copies
+    for (ulist_node_t * node = list->head; NULL != node; node = node->next)
+    {
+        memcpy(&data_array[position],
+               node->items,
+               node->count * sizeof(void *));
+        position += node->count;
+    }
+
+    exit_code = sort_merge_ptrs(data_array, list->size, list->compare_func);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to sort list data.");
+        goto END;
+    }
+
+    position = 0;
+    for (ulist_node_t * node = list->head; NULL != node; node = node->next)
+    {
+        memcpy(node->items,
+               &data_array[position],
+               node->count * sizeof(void *));
+        position += node->count;
+    }
+
+END:
+    free(data_array);
+    return exit_code;
+}
+
+int ulist_clear(ulist_t * list)
+{
+    int            exit_code = E_FAILURE;
+    ulist_node_t * next_node = NULL;
+
+    if (NULL == list)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    for (ulist_node_t * node = list->head; NULL != node; node = next_node)
+    {
+        next_node = node->next;
+        for (uint32_t idx = 0; idx < node->count; idx++)
+        {
+            list->custom_free(node->items[idx]);
+        }
+        free(node);
+    }
+
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int ulist_delete(ulist_t ** list_address)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == list_address) || (NULL == *list_address))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    exit_code = ulist_clear(*list_address);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to clear list.");
+        goto END;
+    }
+
+    free(*list_address);
+    *list_address = NULL;
+
+END:
+    return exit_code;
+}
+
+/***********************************************************************
+ * NOTE: STATIC FUNCTIONS LISTED BELOW
+ ***********************************************************************/
+
+static size_t ulist_node_bytes(uint32_t items)
+{
+    size_t bytes = offsetof(ulist_node_t, items) + (items * sizeof(void *));
+
+    return ((bytes + ULIST_CACHE_LINE - 1) / ULIST_CACHE_LINE)
+           * ULIST_CACHE_LINE;
+}
+
+static ulist_node_t * ulist_node_new(ulist_t * list)
+{
+    ulist_node_t * new_node = NULL;
+
+    new_node
+        = aligned_alloc(ULIST_CACHE_LINE, ulist_node_bytes(list->node_items));
+    if (NULL == new_node)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    new_node->prev  = NULL;
+    new_node->next  = NULL;
+    new_node->count = 0;
+
+END:
+    return new_node;
+}
+
+static void ulist_link_after(ulist_t *      list,
+                             ulist_node_t * prev,
+                             ulist_node_t * node)
+{
+    node->prev = prev;
+    node->next = (NULL == prev) ? list->head : prev->next;
+
+    if (NULL == prev)
+    {
+        list->head = node;
+    }
+    else
+    {
+        prev->next = node;
+    }
+
+    if (NULL == node->next)
+    {
+        list->tail = node;
+    }
+    else
+    {
+        node->next->prev = node;
+    }
+}
+
+static void ulist_unlink_node(ulist_t * list, ulist_node_t * node)
+{
+    if (NULL == node->prev)
+    {
+        list->head = node->next;
+    }
+    else
+    {
+        node->prev->next = node->next;
+    }
+
+    if (NULL == node->next)
+    {
+        list->tail = node->prev;
+    }
+    else
+    {
+        node->next->prev = node->prev;
+    }
+
+    free(node);
+}
+
+static ulist_node_t * ulist_locate(ulist_t *  list,
+                                   uint32_t   position,
+                                   uint32_t * offset)
+{
+    ulist_node_t * node      = NULL;
+    uint32_t       remaining = 0;
+
+    if (position < list->size / 2)
+    {
+        node      = list->head;
+        remaining = position;
+        while (remaining >= node->count)
+        {
+            remaining -= node->count;
+            node = node->next;
+        }
+        *offset = remaining;
+    }
+    else
+    {
+        // Count the item's distance from the tail, 1 being the tail itself
+        node      = list->tail;
+        remaining = list->size - position;
+        while (remaining > node->count)
+        {
+            remaining -= node->count;
+            node = node->prev;
+        }
+        *offset = node->count - remaining;
+    }
+
+    return node;
+}
+
+static int ulist_insert_at(ulist_t *      list,
+                           ulist_node_t * node,
+                           uint32_t       offset,
+                           void *         data)
+{
+    int            exit_code = E_FAILURE;
+    ulist_node_t * new_node  = NULL;
+    uint32_t       half      = 0;
+
+    if (list->node_items == node->count)
+    {
+        new_node = ulist_node_new(list);
+        if (NULL == new_node)
+        {
+            print_error("Unable to split node.");
+            goto END;
+        }
+
+        // Move the upper half of the items into the new node
+        half = node->count / 2;
+        memcpy(new_node->items,
+               &node->items[half],
+               (node->count - half) * sizeof(void *));
+        new_node->count = node->count - half;
+        node->count     = half;
+        ulist_link_after(list, node, new_node);
+
+        if (offset > half)
+        {
+            node = new_node;
+            offset -= half;
+        }
+    }
+
+    memmove(&node->items[offset + 1],
+            &node->items[offset],
+            (node->count - offset) * sizeof(void *));
+    node->items[offset] = data;
+    node->count++;
+    list->size++;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+static void * ulist_remove_at(ulist_t *      list,
+                              ulist_node_t * node,
+                              uint32_t       offset)
+{
+    void *         data  = node->items[offset];
+    ulist_node_t * other = NULL;
+    uint32_t       half  = list->node_items / 2;
+    uint32_t       moved = 0;
+
+    node->count--;
+    memmove(&node->items[offset],
+            &node->items[offset + 1],
+            (node->count - offset) * sizeof(void *));
+    list->size--;
+
+    if (0 == node->count)
+    {
+        ulist_unlink_node(list, node);
+        goto END;
+    }
+
+    if (node->count >= half)
+    {
+        goto END;
+    }
+
+    other = node->next;
+    if ((NULL != other) && (node->count + other->count <= list->node_items))
+    {
+        // Absorb the next node entirely
+        memcpy(&node->items[node->count],
+               other->items,
+               other->count * sizeof(void *));
+        node->count += other->count;
+        ulist_unlink_node(list, other);
+    }
+    else if (NULL != other)
+    {
+        // The next node is well filled, so borrow enough to reach half
+        moved = half - node->count;
+        memcpy(&node->items[node->count], other->items, moved * sizeof(void *));
+        memmove(other->items,
+                &other->items[moved],
+                (other->count - moved) * sizeof(void *));
+        node->count += moved;
+        other->count -= moved;
+    }
+    else if ((NULL != node->prev)
+             && (node->prev->count + node->count <= list->node_items))
+    {
+        // The tail node folds back into its predecessor
+        other = node->prev;
+        memcpy(&other->items[other->count],
+               node->items,
+               node->count * sizeof(void *));
+        other->count += node->count;
+        ulist_unlink_node(list, node);
+    }
+
+END:
+    return data;
+}
+
+/*** end of file ***/
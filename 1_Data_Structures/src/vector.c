@@ -1,21 +1,35 @@
-#include <stdlib.h> // qsort()
-#include <string.h> // memmove()
+#include <limits.h> // INT_MAX
+#include <stdlib.h>
+#include <string.h> // memmove(), memcpy()
 
+#include "simd_search.h"
+#include "sorts.h"
 #include "utilities.h"
 #include "vector.h"
 
 #define LEFT  0 // Used for shifting elements left
 #define RIGHT 1 // Used for shifting elements right
 
-typedef int (*VECTOR_CMP)(const void *, const void *);
+#define VECTOR_MIN_CAPACITY 8 // Capacity given to an empty vector that grows
 
 /**
- * @brief Resizes the vector, doubling its capacity.
+ * @brief Grows the vector by its growth factor, or further if needed to hold
+ * `min_capacity` elements.
  *
  * @param vector Pointer to the vector to be resized.
+ * @param min_capacity Minimum capacity the vector must have afterwards.
  * @return Status code indicating success (E_SUCCESS) or failure (E_FAILURE).
  */
-static int vector_resize(vector_t * vector);
+static int vector_resize(vector_t * vector, int min_capacity);
+
+/**
+ * @brief Reallocates the element buffer to hold exactly `capacity` elements.
+ *
+ * @param vector Pointer to the vector.
+ * @param capacity New capacity, must not be less than the current size.
+ * @return Status code indicating success (E_SUCCESS) or failure (E_FAILURE).
+ */
+static int vector_set_capacity(vector_t * vector, int capacity);
 
 /**
  * @brief Shifts elements in the vector either to the right or left from a given
@@ -46,6 +60,99 @@ static int vector_shift_elements_right(vector_t * vector, int index);
  */
 static int vector_shift_elements_left(vector_t * vector, int index);
 
+/**
+ * @brief Removes the elements the predicate does not match to `keep` in one
+ * stable pass, releasing each removed element.
+ *
+ * @param vector Pointer to the vector.
+ * @param predicate Function called with each element and the context.
+ * @param context Caller data passed to the predicate.
+ * @param keep Predicate result of the elements that stay.
+ * @return Number of elements removed.
+ */
+static int vector_compact(vector_t * vector,
+                          PRED_F     predicate,
+                          void *     context,
+                          bool       keep);
+
+/**
+ * @brief Allocates a vector and its element buffer.
+ *
+ * @param elem_size Size of one inline value, or 0 for a pointer vector.
+ * @param free_func Function used to release removed elements.
+ * @param comp_func Function used to compare elements.
+ * @param initial_capacity Initial capacity of the vector.
+ * @return Pointer to the new vector, or NULL on failure.
+ */
+static vector_t * vector_create(size_t elem_size,
+                                FREE_F free_func,
+                                CMP_F  comp_func,
+                                int    initial_capacity);
+
+/**
+ * @brief Returns the number of bytes each slot of the vector occupies.
+ *
+ * @param vector Pointer to the vector.
+ * @return `elem_size` for typed vectors, `sizeof(void *)` otherwise.
+ */
+static size_t vector_stride(vector_t * vector);
+
+/**
+ * @brief Returns the address of the slot at the given index.
+ *
+ * @param vector Pointer to the vector.
+ * @param index Index of the slot.
+ * @return Address of the slot inside the element buffer.
+ */
+static void * vector_slot(vector_t * vector, int index);
+
+/**
+ * @brief Returns the element at the given index as seen by callers.
+ *
+ * @param vector Pointer to the vector.
+ * @param index Index of the element.
+ * @return The stored pointer for pointer vectors, or the address of the value
+ * for typed vectors.
+ */
+static void * vector_value_at(vector_t * vector, int index);
+
+/**
+ * @brief Scans the vector for elements equal to the search data, with the
+ * SIMD kernels when the vector has a key type.
+ *
+ * @param vector Pointer to the vector.
+ * @param search_data Pointer to the data to search for.
+ * @param indices Receives the indices of the matches.
+ * @param limit Maximum number of matches to record, 1 or the vector size.
+ * @return Number of matches recorded.
+ */
+static int vector_scan(vector_t * vector,
+                       void *     search_data,
+                       int *      indices,
+                       int        limit);
+
+/**
+ * @brief Binary searches a sorted vector for the boundary of the elements
+ * that compare equal to the search data.
+ *
+ * @param vector Pointer to the vector.
+ * @param search_data Pointer to the data to search for.
+ * @param upper False for the first element not less than the search data,
+ * true for the first element greater than it.
+ * @return Index of the boundary, the vector size if there is none.
+ */
+static int vector_bound(vector_t * vector, void * search_data, bool upper);
+
+/**
+ * @brief Stores data into the slot at the given index.
+ *
+ * @param vector Pointer to the vector.
+ * @param index Index of the slot.
+ * @param data The pointer to store, or the address of the value to copy for
+ * typed vectors.
+ */
+static void vector_store(vector_t * vector, int index, void * data);
+
 vector_t * vector_new(FREE_F free_func, CMP_F comp_func, int initial_capacity)
 {
     vector_t * new_vector = NULL;
@@ -56,27 +163,33 @@ vector_t * vector_new(FREE_F free_func, CMP_F comp_func, int initial_capacity)
         goto END;
     }
 
-    // Create the vector
-    new_vector = calloc(1, sizeof(vector_t));
-    if (NULL == new_vector)
+    new_vector = vector_create(0, free_func, comp_func, initial_capacity);
+
+END:
+    return new_vector;
+}
+
+vector_t * vector_new_typed(size_t elem_size,
+                            FREE_F free_func,
+                            CMP_F  comp_func,
+                            int    initial_capacity)
+{
+    vector_t * new_vector = NULL;
+
+    if (NULL == comp_func)
     {
-        print_error("CMR failure.");
+        print_error("NULL argument passed.");
         goto END;
     }
 
-    // Allocate space for each element
-    new_vector->elements = calloc(initial_capacity, sizeof(void *));
-    if (NULL == new_vector->elements)
+    if (0 == elem_size)
     {
-        free(new_vector);
-        new_vector = NULL;
+        print_error("Element size must be non-zero.");
         goto END;
     }
 
-    new_vector->capacity     = initial_capacity;
-    new_vector->size         = 0;
-    new_vector->custom_free  = free_func;
-    new_vector->compare_func = comp_func;
+    new_vector =
+        vector_create(elem_size, free_func, comp_func, initial_capacity);
 
 END:
     return new_vector;
@@ -92,20 +205,35 @@ int vector_append(vector_t * vector, void * data)
         goto END;
     }
 
-    // Insert data at the end of the vector
-    exit_code = vector_insert(vector, data, vector->size);
-    if (E_SUCCESS != exit_code)
+    if (vector->size == vector->capacity)
     {
-        print_error("Unable to insert element.");
-        goto END;
+        exit_code = vector_resize(vector, vector->size + 1);
+        if (E_SUCCESS != exit_code)
+        {
+            print_error("Unable to resize vector.");
+            goto END;
+        }
     }
 
+    // Appending in order keeps a sorted vector sorted
+    if (vector->is_sorted && (0 < vector->size)
+        && (LESS_THAN
+            == vector->compare_func(data,
+                                    vector_value_at(vector, vector->size - 1))))
+    {
+        vector->is_sorted = false;
+    }
+
+    // Write straight into the first free slot, nothing needs shifting
+    vector_store(vector, vector->size, data);
+    vector->size++;
+
     exit_code = E_SUCCESS;
 END:
     return exit_code;
 }
 
-int vector_insert(vector_t * vector, void * data, int index)
+int vector_append_many(vector_t * vector, void * data, int count)
 {
     int exit_code = E_FAILURE;
 
@@ -115,85 +243,74 @@ int vector_insert(vector_t * vector, void * data, int index)
         goto END;
     }
 
-    if ((0 > index) || index > vector->size)
+    if ((0 > count) || (count > INT_MAX - vector->size))
     {
-        print_error("Position out of bounds.");
+        print_error("Invalid element count.");
         goto END;
     }
 
-    if (vector->size == vector->capacity)
+    if (vector->size + count > vector->capacity)
     {
-        exit_code = vector_resize(vector);
+        exit_code = vector_resize(vector, vector->size + count);
         if (E_SUCCESS != exit_code)
         {
+            print_error("Unable to resize vector.");
             goto END;
         }
     }
 
-    exit_code = vector_shift_elements_right(vector, index);
-    if (E_SUCCESS != exit_code)
-    {
-        print_error("Unable to shift elements right.");
-        goto END;
-    }
-
-    vector->elements[index] = data;
+    // Both storage modes lay elements out back to back, so one copy suffices
+    memcpy(vector_slot(vector, vector->size),
+           data,
+           (size_t)count * vector_stride(vector));
+    vector->size += count;
+    vector->is_sorted = vector->is_sorted && (0 == count);
 
     exit_code = E_SUCCESS;
 END:
     return exit_code;
 }
 
-bool vector_is_empty(vector_t * vector)
+int vector_append_vector(vector_t * vector, vector_t * source)
 {
-    int is_empty = false;
+    int exit_code = E_FAILURE;
 
-    if (NULL == vector)
+    if ((NULL == vector) || (NULL == source))
     {
         print_error("NULL argument passed.");
         goto END;
     }
 
-    if (0 == vector->size)
+    if (vector->elem_size != source->elem_size)
     {
-        is_empty = true;
+        print_error("Element sizes do not match.");
+        goto END;
     }
 
-END:
-    return is_empty;
-}
-
-void * vector_pop(vector_t * vector)
-{
-    int    exit_code = E_FAILURE;
-    void * temp      = NULL;
-    void * element   = NULL;
-
-    if (NULL == vector)
+    if (source->size > INT_MAX - vector->size)
     {
-        print_error("NULL argument passed.");
+        print_error("Invalid element count.");
         goto END;
     }
 
-    temp = vector->elements[vector->size - 1];
-
-    exit_code = vector_shift_elements_left(vector, vector->size);
+    // Reserve first: if source is the vector itself, growing it moves the
+    // values, so they are only read once no reallocation can follow
+    exit_code = vector_reserve(vector, vector->size + source->size);
     if (E_SUCCESS != exit_code)
     {
-        print_error("Unable to shift elements left.");
+        print_error("Unable to resize vector.");
         goto END;
     }
 
-    element = temp;
+    exit_code = vector_append_many(vector, source->values, source->size);
 
 END:
-    return element;
+    return exit_code;
 }
 
-int vector_remove(vector_t * vector, int index)
+int vector_reserve(vector_t * vector, int capacity)
 {
-    int    exit_code = E_FAILURE;
-    void * temp      = NULL;
+    int exit_code = E_FAILURE;
 
     if (NULL == vector)
     {
@@ -201,31 +318,27 @@ int vector_remove(vector_t * vector, int index)
         goto END;
     }
 
-    if ((0 > index) || index > vector->size)
+    if (0 > capacity)
     {
-        print_error("Index out of bounds.");
+        print_error("Invalid capacity.");
         goto END;
     }
 
-    temp = vector->elements[index];
-
-    exit_code = vector_shift_elements_left(vector, index);
-    if (E_SUCCESS != exit_code)
+    if (capacity <= vector->capacity)
     {
-        print_error("Unable to shift elements left.");
+        exit_code = E_SUCCESS;
         goto END;
     }
 
-    vector->custom_free(temp);
+    exit_code = vector_set_capacity(vector, capacity);
 
-    exit_code = E_SUCCESS;
 END:
     return exit_code;
 }
 
-void * vector_get_element(vector_t * vector, int index)
+int vector_shrink_to_fit(vector_t * vector)
 {
-    void * element = NULL;
+    int exit_code = E_FAILURE;
 
     if (NULL == vector)
     {
@@ -233,167 +346,194 @@ void * vector_get_element(vector_t * vector, int index)
         goto END;
     }
 
-    if ((0 > index) || index > vector->size)
+    if (vector->size == vector->capacity)
     {
-        print_error("Index out of bounds.");
+        exit_code = E_SUCCESS;
         goto END;
     }
 
-    element = vector->elements[index];
+    exit_code = vector_set_capacity(vector, vector->size);
 
 END:
-    return element;
+    return exit_code;
 }
 
-int vector_set_element(vector_t * vector, void * data, int index)
+int vector_set_growth_factor(vector_t * vector, double growth_factor)
 {
     int exit_code = E_FAILURE;
 
-    if ((NULL == vector) || (NULL == data))
+    if (NULL == vector)
     {
         print_error("NULL argument passed.");
         goto END;
     }
 
-    if ((0 > index) || index > vector->size)
+    if (!(growth_factor > 1.0))
     {
-        print_error("Index out of bounds.");
+        print_error("Growth factor must be greater than 1.0.");
         goto END;
     }
 
-    vector->elements[index] = data;
+    vector->growth_factor = growth_factor;
 
     exit_code = E_SUCCESS;
 END:
     return exit_code;
 }
 
-int vector_size(vector_t * vector)
+int vector_insert(vector_t * vector, void * data, int index)
 {
-    int size = -1;
+    int exit_code = E_FAILURE;
 
-    if (NULL == vector)
+    if ((NULL == vector) || (NULL == data))
     {
         print_error("NULL argument passed.");
         goto END;
     }
 
-    size = vector->size;
-END:
-    return size;
-}
+    if ((0 > index) || index > vector->size)
+    {
+        print_error("Position out of bounds.");
+        goto END;
+    }
 
-int vector_capacity(vector_t * vector)
-{
-    int capacity = -1;
+    if (vector->size == vector->capacity)
+    {
+        exit_code = vector_resize(vector, vector->size + 1);
+        if (E_SUCCESS != exit_code)
+        {
+            goto END;
+        }
+    }
 
-    if (NULL == vector)
+    exit_code = vector_shift_elements_right(vector, index);
+    if (E_SUCCESS != exit_code)
     {
-        print_error("NULL argument passed.");
+        print_error("Unable to shift elements right.");
         goto END;
     }
 
-    capacity = vector->capacity;
+    vector_store(vector, index, data);
+    vector->is_sorted = false;
+
+    exit_code = E_SUCCESS;
 END:
-    return capacity;
+    return exit_code;
 }
 
-int vector_iterate(vector_t * vector, ACT_F action_function)
+int vector_remove_if(vector_t * vector, PRED_F predicate, void * context)
 {
-    int exit_code = E_FAILURE;
+    int removed = -1;
 
-    if ((NULL == vector) || (NULL == action_function))
+    if ((NULL == vector) || (NULL == predicate))
     {
         print_error("NULL argument passed.");
         goto END;
     }
 
-    // Iterate through each element and call the action function
-    for (int idx = 0; idx < vector->size; idx++)
-    {
-        action_function(vector->elements[idx]);
-    }
+    removed = vector_compact(vector, predicate, context, false);
 
-    exit_code = E_SUCCESS;
 END:
-    return exit_code;
+    return removed;
 }
 
-void * vector_find_first_occurrence(vector_t * vector, void ** search_data)
+int vector_retain(vector_t * vector, PRED_F predicate, void * context)
 {
-    void * found_element = NULL;
+    int removed = -1;
 
-    if ((NULL == vector) || (NULL == search_data))
+    if ((NULL == vector) || (NULL == predicate))
     {
         print_error("NULL argument passed.");
         goto END;
     }
 
-    for (int idx = 0; idx < vector->size; idx++)
-    {
-        if (EQUAL == vector->compare_func(search_data, vector->elements[idx]))
-        {
-            found_element = vector->elements[idx];
-            goto END;
-        }
-    }
+    removed = vector_compact(vector, predicate, context, true);
 
 END:
-    return found_element;
+    return removed;
 }
 
-vector_t * vector_find_all_occurrences(vector_t * vector, void ** search_data)
+int vector_remove_range(vector_t * vector, int first, int last)
 {
-    vector_t * result_vector = NULL;
-    int        exit_code     = E_FAILURE;
+    int removed = -1;
 
-    if ((NULL == vector) || (NULL == search_data))
+    if (NULL == vector)
     {
         print_error("NULL argument passed.");
         goto END;
     }
 
-    if (0 == vector->size)
+    if ((0 > first) || (first > last) || (last > vector->size))
     {
-        print_error("Empty vector.");
+        print_error("Range out of bounds.");
         goto END;
     }
 
-    result_vector =
-        vector_new(vector->custom_free, vector->compare_func, vector->size);
-    if (NULL == result_vector)
+    if (NULL != vector->custom_free)
     {
-        print_error("Unable to create result vector.");
+        for (int idx = first; idx < last; idx++)
+        {
+            vector->custom_free(vector_value_at(vector, idx));
+        }
+    }
+
+    // Close the gap with one move of the tail
+    memmove(vector_slot(vector, first),
+            vector_slot(vector, last),
+            (size_t)(vector->size - last) * vector_stride(vector));
+    vector->size -= last - first;
+    removed = last - first;
+
+END:
+    return removed;
+}
+
+int vector_dedup_sorted(vector_t * vector)
+{
+    int removed = -1;
+    int kept    = 0;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
         goto END;
     }
 
     for (int idx = 0; idx < vector->size; idx++)
     {
-        if (EQUAL == vector->compare_func(search_data, vector->elements[idx]))
+        void * element = vector_value_at(vector, idx);
+
+        if ((0 < kept)
+            && (EQUAL
+                == vector->compare_func(vector_value_at(vector, kept - 1),
+                                        element)))
         {
-            exit_code = vector_append(result_vector, vector->elements[idx]);
-            if (E_SUCCESS != exit_code)
+            if (NULL != vector->custom_free)
             {
-                print_error("Unable to append element.");
-                vector_delete(&vector);
-                goto END;
+                vector->custom_free(element);
             }
+            continue;
         }
-    }
 
-    // If no occurrences were found, free the result vector and return NULL
-    if (0 == result_vector->size)
-    {
-        vector_delete(&result_vector);
+        if (kept != idx)
+        {
+            memcpy(vector_slot(vector, kept),
+                   vector_slot(vector, idx),
+                   vector_stride(vector));
+        }
+        kept++;
     }
 
+    removed      = vector->size - kept;
+    vector->size = kept;
+
 END:
-    return result_vector;
+    return removed;
 }
 
-int vector_sort(vector_t * vector)
+bool vector_is_empty(vector_t * vector)
 {
-    int exit_code = E_FAILURE;
+    int is_empty = false;
 
     if (NULL == vector)
     {
@@ -401,19 +541,20 @@ int vector_sort(vector_t * vector)
         goto END;
     }
 
-    qsort(vector->elements,
-          vector->size,
-          sizeof(void *),
-          (VECTOR_CMP)vector->compare_func);
+    if (0 == vector->size)
+    {
+        is_empty = true;
+    }
 
-    exit_code = E_SUCCESS;
 END:
-    return exit_code;
+    return is_empty;
 }
 
-int vector_clear(vector_t * vector)
+void * vector_pop(vector_t * vector)
 {
-    int exit_code = E_FAILURE;
+    int    exit_code = E_FAILURE;
+    void * temp      = NULL;
+    void * element   = NULL;
 
     if (NULL == vector)
     {
@@ -421,28 +562,572 @@ int vector_clear(vector_t * vector)
         goto END;
     }
 
-    // Call the custom free function on each element
-    for (int idx = 0; idx < vector->size; idx++)
+    if (0 == vector->size)
     {
-        vector->custom_free(vector->elements[idx]);
+        print_error("Empty vector.");
+        goto END;
     }
 
-    // Reset the size
-    vector->size = 0;
+    temp = vector_value_at(vector, vector->size - 1);
+
+    exit_code = vector_shift_elements_left(vector, vector->size - 1);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to shift elements left.");
+        goto END;
+    }
+
+    element = temp;
 
-    exit_code = E_SUCCESS;
 END:
-    return exit_code;
+    return element;
 }
 
-void vector_delete(vector_t ** vector)
+int vector_remove(vector_t * vector, int index)
 {
     int exit_code = E_FAILURE;
 
-    if (NULL == vector || NULL == *vector)
+    if (NULL == vector)
     {
         print_error("NULL argument passed.");
-        return;
+        goto END;
+    }
+
+    if ((0 > index) || index >= vector->size)
+    {
+        print_error("Index out of bounds.");
+        goto END;
+    }
+
+    // Release the element before its slot is overwritten by the shift
+    if (NULL != vector->custom_free)
+    {
+        vector->custom_free(vector_value_at(vector, index));
+    }
+
+    exit_code = vector_shift_elements_left(vector, index);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to shift elements left.");
+        goto END;
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * vector_get_element(vector_t * vector, int index)
+{
+    void * element = NULL;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if ((0 > index) || index >= vector->size)
+    {
+        print_error("Index out of bounds.");
+        goto END;
+    }
+
+    element = vector_value_at(vector, index);
+
+END:
+    return element;
+}
+
+int vector_set_element(vector_t * vector, void * data, int index)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == vector) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if ((0 > index) || index >= vector->size)
+    {
+        print_error("Index out of bounds.");
+        goto END;
+    }
+
+    vector_store(vector, index, data);
+    vector->is_sorted = false;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int vector_size(vector_t * vector)
+{
+    int size = -1;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    size = vector->size;
+END:
+    return size;
+}
+
+int vector_capacity(vector_t * vector)
+{
+    int capacity = -1;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    capacity = vector->capacity;
+END:
+    return capacity;
+}
+
+int vector_iterate(vector_t * vector, ACT_F action_function)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == vector) || (NULL == action_function))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // Iterate through each element and call the action function
+    for (int idx = 0; idx < vector->size; idx++)
+    {
+        action_function(vector_value_at(vector, idx));
+    }
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void * vector_find_first_occurrence(vector_t * vector, void ** search_data)
+{
+    void * found_element = NULL;
+    int    index         = -1;
+
+    if ((NULL == vector) || (NULL == search_data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    index = vector_find_index(vector, search_data);
+    if (0 <= index)
+    {
+        found_element = vector_value_at(vector, index);
+    }
+
+END:
+    return found_element;
+}
+
+vector_t * vector_find_all_occurrences(vector_t * vector, void ** search_data)
+{
+    vector_t * result_vector = NULL;
+    int *      indices       = NULL;
+    int        count         = 0;
+
+    if ((NULL == vector) || (NULL == search_data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 == vector->size)
+    {
+        print_error("Empty vector.");
+        goto END;
+    }
+
+    // If no occurrences were found, return NULL
+    indices = vector_find_all_indices(vector, search_data, &count);
+    if (NULL == indices)
+    {
+        goto END;
+    }
+
+    // A typed result holds copies, so it must not release what they own
+    result_vector = vector_create(vector->elem_size,
+                                  (0 == vector->elem_size) ? vector->custom_free
+                                                           : NULL,
+                                  vector->compare_func,
+                                  count);
+    if (NULL == result_vector)
+    {
+        print_error("Unable to create result vector.");
+        goto END;
+    }
+
+    result_vector->key_type = vector->key_type;
+    for (int idx = 0; idx < count; idx++)
+    {
+        vector_store(
+            result_vector, idx, vector_value_at(vector, indices[idx]));
+    }
+    result_vector->size = count;
+
+END:
+    free(indices);
+    return result_vector;
+}
+
+int vector_set_key_type(vector_t * vector, vector_key_t key_type)
+{
+    int    exit_code = E_FAILURE;
+    size_t key_size  = 0;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    switch (key_type)
+    {
+        case VECTOR_KEY_NONE:
+            key_size = vector->elem_size;
+            break;
+
+        case VECTOR_KEY_INT32:
+            key_size = sizeof(int32_t);
+            break;
+
+        case VECTOR_KEY_INT64:
+            key_size = sizeof(int64_t);
+            break;
+
+        case VECTOR_KEY_FLOAT:
+            key_size = sizeof(float);
+            break;
+
+        default:
+            print_error("Invalid key type.");
+            goto END;
+    }
+
+    if ((0 == vector->elem_size) || (key_size != vector->elem_size))
+    {
+        print_error("Key type does not match the element size.");
+        goto END;
+    }
+
+    vector->key_type = key_type;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int vector_find_index(vector_t * vector, void * search_data)
+{
+    int index = -1;
+
+    if ((NULL == vector) || (NULL == search_data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (vector->is_sorted)
+    {
+        index = vector_bound(vector, search_data, false);
+        if ((index == vector->size)
+            || (EQUAL
+                != vector->compare_func(search_data,
+                                        vector_value_at(vector, index))))
+        {
+            index = -1;
+        }
+    }
+    else if (0 == vector_scan(vector, search_data, &index, 1))
+    {
+        index = -1;
+    }
+
+END:
+    return index;
+}
+
+int * vector_find_all_indices(vector_t * vector,
+                              void *     search_data,
+                              int *      count)
+{
+    int * indices = NULL;
+    int   found   = 0;
+
+    if ((NULL == vector) || (NULL == search_data) || (NULL == count))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    *count = 0;
+    if (0 == vector->size)
+    {
+        goto END;
+    }
+
+    indices = malloc((size_t)vector->size * sizeof(int));
+    if (NULL == indices)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    if (vector->is_sorted)
+    {
+        int first = vector_bound(vector, search_data, false);
+        int last  = vector_bound(vector, search_data, true);
+        for (int idx = first; idx < last; idx++)
+        {
+            indices[found++] = idx;
+        }
+    }
+    else
+    {
+        found = vector_scan(vector, search_data, indices, vector->size);
+    }
+    if (0 == found)
+    {
+        free(indices);
+        indices = NULL;
+        goto END;
+    }
+
+    *count = found;
+
+END:
+    return indices;
+}
+
+int vector_sort(vector_t * vector)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 == vector->elem_size)
+    {
+        exit_code = sort_pdq_ptrs(
+            vector->elements, vector->size, vector->compare_func);
+    }
+    else
+    {
+        exit_code = sort_pdq(vector->values,
+                             vector->size,
+                             vector->elem_size,
+                             vector->compare_func);
+    }
+
+    vector->is_sorted = (E_SUCCESS == exit_code);
+
+END:
+    return exit_code;
+}
+
+int vector_sort_parallel(vector_t * vector, int nthreads)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (0 == vector->elem_size)
+    {
+        exit_code = sort_parallel_ptrs(
+            vector->elements, vector->size, vector->compare_func, nthreads);
+    }
+    else
+    {
+        exit_code = sort_parallel(vector->values,
+                                  vector->size,
+                                  vector->elem_size,
+                                  vector->compare_func,
+                                  nthreads);
+    }
+
+    vector->is_sorted = (E_SUCCESS == exit_code);
+
+END:
+    return exit_code;
+}
+
+bool vector_is_sorted(vector_t * vector)
+{
+    bool is_sorted = false;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    is_sorted = vector->is_sorted;
+
+END:
+    return is_sorted;
+}
+
+int vector_lower_bound(vector_t * vector, void * search_data)
+{
+    int index = -1;
+
+    if ((NULL == vector) || (NULL == search_data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (!vector->is_sorted)
+    {
+        print_error("Vector is not sorted.");
+        goto END;
+    }
+
+    index = vector_bound(vector, search_data, false);
+
+END:
+    return index;
+}
+
+int vector_upper_bound(vector_t * vector, void * search_data)
+{
+    int index = -1;
+
+    if ((NULL == vector) || (NULL == search_data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (!vector->is_sorted)
+    {
+        print_error("Vector is not sorted.");
+        goto END;
+    }
+
+    index = vector_bound(vector, search_data, true);
+
+END:
+    return index;
+}
+
+int vector_equal_range(vector_t * vector,
+                       void *     search_data,
+                       int *      first,
+                       int *      last)
+{
+    int exit_code = E_FAILURE;
+
+    if ((NULL == vector) || (NULL == search_data) || (NULL == first)
+        || (NULL == last))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (!vector->is_sorted)
+    {
+        print_error("Vector is not sorted.");
+        goto END;
+    }
+
+    *first = vector_bound(vector, search_data, false);
+    *last  = vector_bound(vector, search_data, true);
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+int vector_insert_sorted(vector_t * vector, void * data)
+{
+    int exit_code = E_FAILURE;
+    int index     = 0;
+
+    if ((NULL == vector) || (NULL == data))
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    if (!vector->is_sorted)
+    {
+        print_error("Vector is not sorted.");
+        goto END;
+    }
+
+    index     = vector_bound(vector, data, true);
+    exit_code = vector_insert(vector, data, index);
+    if (E_SUCCESS != exit_code)
+    {
+        print_error("Unable to insert element.");
+        goto END;
+    }
+
+    // vector_insert() cannot know the position keeps the order
+    vector->is_sorted = true;
+
+END:
+    return exit_code;
+}
+
+int vector_clear(vector_t * vector)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == vector)
+    {
+        print_error("NULL argument passed.");
+        goto END;
+    }
+
+    // Call the custom free function on each element
+    if (NULL != vector->custom_free)
+    {
+        for (int idx = 0; idx < vector->size; idx++)
+        {
+            vector->custom_free(vector_value_at(vector, idx));
+        }
+    }
+
+    // Reset the size
+    vector->size = 0;
+
+    exit_code = E_SUCCESS;
+END:
+    return exit_code;
+}
+
+void vector_delete(vector_t ** vector)
+{
+    int exit_code = E_FAILURE;
+
+    if (NULL == vector || NULL == *vector)
+    {
+        print_error("NULL argument passed.");
+        return;
     }
 
     // Clear all elements
@@ -453,8 +1138,11 @@ void vector_delete(vector_t ** vector)
         goto END;
     }
 
-    // Free the elements array
-    free((*vector)->elements);
+    // Free the element buffer, unless it is borrowed
+    if (!(*vector)->fixed_storage)
+    {
+        free((*vector)->values);
+    }
 
     // Free the vector itself
     free(*vector);
@@ -470,10 +1158,10 @@ END:
  * NOTE: STATIC FUNCTIONS LISTED BELOW
  ***********************************************************************/
 
-static int vector_resize(vector_t * vector)
+static int vector_resize(vector_t * vector, int min_capacity)
 {
-    int     exit_code     = E_FAILURE;
-    void ** resized_array = NULL;
+    int    exit_code    = E_FAILURE;
+    double new_capacity = 0;
 
     if (NULL == vector)
     {
@@ -481,17 +1169,66 @@ static int vector_resize(vector_t * vector)
         goto END;
     }
 
-    // Attempt to double the capacity of the array vector
-    resized_array =
-        realloc(vector->elements, (vector->capacity * 2) * (sizeof(void *)));
+    // Grow geometrically so that a run of appends costs amortized O(1)
+    new_capacity = vector->capacity * vector->growth_factor;
+    if (new_capacity < (double)vector->capacity + 1)
+    {
+        new_capacity = (double)vector->capacity + 1;
+    }
+    if (new_capacity < VECTOR_MIN_CAPACITY)
+    {
+        new_capacity = VECTOR_MIN_CAPACITY;
+    }
+    if (new_capacity < min_capacity)
+    {
+        new_capacity = min_capacity;
+    }
+    if (new_capacity > INT_MAX)
+    {
+        new_capacity = INT_MAX;
+    }
+
+    if ((int)new_capacity <= vector->capacity)
+    {
+        print_error("Vector is at its maximum capacity.");
+        goto END;
+    }
+
+    exit_code = vector_set_capacity(vector, (int)new_capacity);
+
+END:
+    return exit_code;
+}
+
+static int vector_set_capacity(vector_t * vector, int capacity)
+{
+    int             exit_code     = E_FAILURE;
+    unsigned char * resized_array = NULL;
+    size_t          num_slots     = 0;
+
+    if ((NULL == vector) || (capacity < vector->size))
+    {
+        print_error("Invalid capacity.");
+        goto END;
+    }
+
+    if (vector->fixed_storage)
+    {
+        print_error("Vector storage is fixed.");
+        goto END;
+    }
+
+    // Keep at least one slot so realloc() never sees a zero size
+    num_slots     = (0 == capacity) ? 1 : (size_t)capacity;
+    resized_array = realloc(vector->values, num_slots * vector_stride(vector));
     if (NULL == resized_array)
     {
         print_error("Failed to reallocate array vector.");
         goto END;
     }
 
-    vector->capacity *= 2;
-    vector->elements = resized_array;
+    vector->capacity = capacity;
+    vector->values   = resized_array;
 
     exit_code = E_SUCCESS;
 END:
@@ -500,11 +1237,10 @@ END:
 
 static int vector_shift_elements(vector_t * vector, int index, int direction)
 {
-    int     exit_code         = E_FAILURE;
-    void ** source            = NULL;
-    void ** destination       = NULL;
-    int     elements_to_shift = 0;
-    int     num_bytes         = 0;
+    int    exit_code         = E_FAILURE;
+    void * source            = NULL;
+    void * destination       = NULL;
+    int    elements_to_shift = 0;
 
     if (NULL == vector)
     {
@@ -518,20 +1254,24 @@ static int vector_shift_elements(vector_t * vector, int index, int direction)
         goto END;
     }
 
-    elements_to_shift = vector->size - index;
-    num_bytes         = elements_to_shift * sizeof(*vector->elements);
-
     // Determine whether to shift elements right or left
     switch (direction)
     {
         case RIGHT:
-            source      = &vector->elements[index];
-            destination = &vector->elements[index + 1];
+            elements_to_shift = vector->size - index;
+            source            = vector_slot(vector, index);
+            destination       = vector_slot(vector, index + 1);
             break;
 
         case LEFT:
-            source      = &vector->elements[index + 1];
-            destination = &vector->elements[index];
+            if (index == vector->size)
+            {
+                print_error("Position out of bounds.");
+                goto END;
+            }
+            elements_to_shift = vector->size - index - 1;
+            source            = vector_slot(vector, index + 1);
+            destination       = vector_slot(vector, index);
             break;
 
         default:
@@ -540,7 +1280,7 @@ static int vector_shift_elements(vector_t * vector, int index, int direction)
     }
 
     // Perform the shift
-    memmove(destination, source, num_bytes);
+    memmove(destination, source, elements_to_shift * vector_stride(vector));
 
     exit_code = E_SUCCESS;
 END:
@@ -582,3 +1322,224 @@ static int vector_shift_elements_left(vector_t * vector, int index)
 END:
     return exit_code;
 }
+
+static int vector_compact(vector_t * vector,
+                          PRED_F     predicate,
+                          void *     context,
+                          bool       keep)
+{
+    int kept    = 0;
+    int removed = 0;
+
+    for (int idx = 0; idx < vector->size; idx++)
+    {
+        void * element = vector_value_at(vector, idx);
+
+        if (keep != predicate(element, context))
+        {
+            if (NULL != vector->custom_free)
+            {
+                vector->custom_free(element);
+            }
+            continue;
+        }
+
+        // Slots before idx are already processed, so moving down is safe
+        if (kept != idx)
+        {
+            memcpy(vector_slot(vector, kept),
+                   vector_slot(vector, idx),
+                   vector_stride(vector));
+        }
+        kept++;
+    }
+
+    removed      = vector->size - kept;
+    vector->size = kept;
+
+    return removed;
+}
+
+static vector_t * vector_create(size_t elem_size,
+                                FREE_F free_func,
+                                CMP_F  comp_func,
+                                int    initial_capacity)
+{
+    vector_t * new_vector = NULL;
+
+    // Create the vector
+    new_vector = calloc(1, sizeof(vector_t));
+    if (NULL == new_vector)
+    {
+        print_error("CMR failure.");
+        goto END;
+    }
+
+    new_vector->elem_size = elem_size;
+
+    // Allocate space for each element, a zero capacity still gets one slot
+    new_vector->values = calloc((0 < initial_capacity) ? initial_capacity : 1,
+                                vector_stride(new_vector));
+    if (NULL == new_vector->values)
+    {
+        free(new_vector);
+        new_vector = NULL;
+        goto END;
+    }
+
+    new_vector->capacity      = (0 < initial_capacity) ? initial_capacity : 0;
+    new_vector->size          = 0;
+    new_vector->growth_factor = VECTOR_DEFAULT_GROWTH_FACTOR;
+    new_vector->custom_free   = free_func;
+    new_vector->compare_func  = comp_func;
+
+END:
+    return new_vector;
+}
+
+static size_t vector_stride(vector_t * vector)
+{
+    return (0 == vector->elem_size) ? sizeof(void *) : vector->elem_size;
+}
+
+static void * vector_slot(vector_t * vector, int index)
+{
+    return vector->values + ((size_t)index * vector_stride(vector));
+}
+
+static void * vector_value_at(vector_t * vector, int index)
+{
+    void * element = NULL;
+
+    if (0 == vector->elem_size)
+    {
+        element = vector->elements[index];
+    }
+    else
+    {
+        element = vector_slot(vector, index);
+    }
+
+    return element;
+}
+
+static int vector_scan(vector_t * vector,
+                       void *     search_data,
+                       int *      indices,
+                       int        limit)
+{
+    int found = 0;
+
+    switch (vector->key_type)
+    {
+        case VECTOR_KEY_INT32:
+            if (1 == limit)
+            {
+                indices[0] = search_find_i32((const int32_t *)vector->values,
+                                             vector->size,
+                                             *(int32_t *)search_data);
+                found      = (0 <= indices[0]) ? 1 : 0;
+            }
+            else
+            {
+                found = search_find_all_i32((const int32_t *)vector->values,
+                                            vector->size,
+                                            *(int32_t *)search_data,
+                                            indices);
+            }
+            break;
+
+        case VECTOR_KEY_INT64:
+            if (1 == limit)
+            {
+                indices[0] = search_find_i64((const int64_t *)vector->values,
+                                             vector->size,
+                                             *(int64_t *)search_data);
+                found      = (0 <= indices[0]) ? 1 : 0;
+            }
+            else
+            {
+                found = search_find_all_i64((const int64_t *)vector->values,
+                                            vector->size,
+                                            *(int64_t *)search_data,
+                                            indices);
+            }
+            break;
+
+        case VECTOR_KEY_FLOAT:
+            if (1 == limit)
+            {
+                indices[0] = search_find_float((const float *)vector->values,
+                                               vector->size,
+                                               *(float *)search_data);
+                found      = (0 <= indices[0]) ? 1 : 0;
+            }
+            else
+            {
+                found = search_find_all_float((const float *)vector->values,
+                                              vector->size,
+                                              *(float *)search_data,
+                                              indices);
+            }
+            break;
+
+        default:
+            for (int idx = 0; (idx < vector->size) && (found < limit); idx++)
+            {
+                if (EQUAL == vector->compare_func(search_data,
+                                                  vector_value_at(vector, idx)))
+                {
+                    indices[found++] = idx;
+                }
+            }
+            break;
+    }
+
+    return found;
+}
+
+static int vector_bound(vector_t * vector, void * search_data, bool upper)
+{
+    int low  = 0;
+    int high = vector->size;
+
+    // Only LESS_THAN is trusted, matching the order the sorts establish
+    while (low < high)
+    {
+        int    mid     = low + ((high - low) / 2);
+        void * element = vector_value_at(vector, mid);
+        bool   before  = false;
+
+        if (upper)
+        {
+            before = (LESS_THAN != vector->compare_func(search_data, element));
+        }
+        else
+        {
+            before = (LESS_THAN == vector->compare_func(element, search_data));
+        }
+
+        if (before)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+static void vector_store(vector_t * vector, int index, void * data)
+{
+    if (0 == vector->elem_size)
+    {
+        vector->elements[index] = data;
+    }
+    else
+    {
+        memcpy(vector_slot(vector, index), data, vector->elem_size);
+    }
+}
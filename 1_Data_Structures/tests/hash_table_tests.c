@@ -0,0 +1,335 @@
+/** @file hash_table_tests.c
+ *
+ * @brief Tests for the Swiss-table hash map: ownership, the choice between
+ * an empty slot and a tombstone on removal, tombstone reuse and growth.
+ */
+#include <CUnit/Basic.h>
+
+#include "hash_table.h"
+#include "hashing.h"
+#include "utilities.h"
+
+#define CTRL_EMPTY   ((int8_t)-128) // Control byte of a never used slot
+#define CTRL_DELETED ((int8_t)-2)   // Control byte of a tombstone
+#define MANY_KEYS    100000
+
+/**
+ * @brief Hashes every key to 0, so all keys share one probe sequence and
+ * fill slots in insertion order from slot 0.
+ *
+ * @param key Unused.
+ * @return 0.
+ */
+static uint64_t hash_collide(void * key);
+
+/**
+ * @brief Finds the slot holding a key pointer.
+ *
+ * @param table Pointer to the table.
+ * @param key Key pointer to look for.
+ * @return Index of the slot, or UINT32_MAX if no slot holds it.
+ */
+static uint32_t slot_of(hash_table_t * table, void * key);
+
+/**
+ * @brief Allocates an int holding a value.
+ *
+ * @param value Value to store.
+ * @return Pointer to the new int.
+ */
+static int * new_int(int value);
+
+static int keys[MANY_KEYS];
+
+void test_hash_table_basic(void)
+{
+    hash_table_t * table = hash_table_new(hash_int, int_comp, free, free);
+    int            probe = 7;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(table);
+    CU_ASSERT_EQUAL(hash_table_size(table), 0);
+    CU_ASSERT_PTR_NULL(hash_table_lookup(table, &probe));
+
+    for (int idx = 0; idx < 100; idx++)
+    {
+        CU_ASSERT_EQUAL(
+            hash_table_insert(table, new_int(idx), new_int(idx * 10)),
+            E_SUCCESS);
+    }
+    CU_ASSERT_EQUAL(hash_table_size(table), 100);
+    CU_ASSERT_EQUAL(*(int *)hash_table_lookup(table, &probe), 70);
+
+    // Replacing frees the passed key and the old value
+    CU_ASSERT_EQUAL(hash_table_insert(table, new_int(7), new_int(-7)),
+                    E_SUCCESS);
+    CU_ASSERT_EQUAL(hash_table_size(table), 100);
+    CU_ASSERT_EQUAL(*(int *)hash_table_lookup(table, &probe), -7);
+
+    CU_ASSERT_EQUAL(hash_table_remove(table, &probe), E_SUCCESS);
+    CU_ASSERT_FALSE(hash_table_contains(table, &probe));
+    CU_ASSERT_NOT_EQUAL(hash_table_remove(table, &probe), E_SUCCESS);
+    CU_ASSERT_EQUAL(hash_table_size(table), 99);
+
+    CU_ASSERT_EQUAL(hash_table_delete(&table), E_SUCCESS);
+    CU_ASSERT_PTR_NULL(table);
+}
+
+void test_hash_table_erase_to_empty(void)
+{
+    hash_table_t * table = hash_table_new(hash_collide, int_comp, NULL, NULL);
+    uint32_t       growth_left = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(table);
+    for (int idx = 0; idx < 3; idx++)
+    {
+        keys[idx] = idx;
+        hash_table_insert(table, &keys[idx], &keys[idx]);
+    }
+    CU_ASSERT_EQUAL_FATAL(slot_of(table, &keys[1]), 1);
+    growth_left = table->growth_left;
+
+    // The run of full slots around slot 1 is shorter than a group, so every
+    // probe that reaches it also sees an empty slot and stops: no tombstone
+    CU_ASSERT_EQUAL(hash_table_remove(table, &keys[1]), E_SUCCESS);
+    CU_ASSERT_EQUAL(table->ctrl[1], CTRL_EMPTY);
+    CU_ASSERT_EQUAL(table->growth_left, growth_left + 1);
+    CU_ASSERT_PTR_EQUAL(hash_table_lookup(table, &keys[2]), &keys[2]);
+    CU_ASSERT_PTR_EQUAL(hash_table_lookup(table, &keys[0]), &keys[0]);
+
+    hash_table_delete(&table);
+}
+
+void test_hash_table_tombstone_reuse(void)
+{
+    hash_table_t * table = hash_table_new(hash_collide, int_comp, NULL, NULL);
+    uint32_t       growth_left = 0;
+    uint32_t       capacity    = 0;
+    int            extra       = 1000;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(table);
+    // 20 colliding keys fill slots 0 to 19 of a 32 slot table
+    for (int idx = 0; idx < 20; idx++)
+    {
+        keys[idx] = idx;
+        hash_table_insert(table, &keys[idx], &keys[idx]);
+    }
+    CU_ASSERT_EQUAL_FATAL(table->capacity, 32);
+    CU_ASSERT_EQUAL_FATAL(slot_of(table, &keys[5]), 5);
+    growth_left = table->growth_left;
+    capacity    = table->capacity;
+
+    // Slot 5 sits in a run of 20 full slots, so some group covering it has
+    // no empty slot and a probe may have passed it: it becomes a tombstone
+    CU_ASSERT_EQUAL(hash_table_remove(table, &keys[5]), E_SUCCESS);
+    CU_ASSERT_EQUAL(table->ctrl[5], CTRL_DELETED);
+    CU_ASSERT_EQUAL(table->growth_left, growth_left);
+    for (int idx = 6; idx < 20; idx++)
+    {
+        CU_ASSERT_PTR_EQUAL(hash_table_lookup(table, &keys[idx]), &keys[idx]);
+    }
+
+    // The next insert on that probe sequence takes the tombstone, using up
+    // none of the table's growth
+    CU_ASSERT_EQUAL(hash_table_insert(table, &extra, &extra), E_SUCCESS);
+    CU_ASSERT_EQUAL(slot_of(table, &extra), 5);
+    CU_ASSERT_EQUAL(table->growth_left, growth_left);
+    CU_ASSERT_EQUAL(table->capacity, capacity);
+    CU_ASSERT_EQUAL(hash_table_size(table), 20);
+
+    hash_table_delete(&table);
+}
+
+void test_hash_table_growth(void)
+{
+    hash_table_t * table = hash_table_new(hash_int, int_comp, NULL, NULL);
+    uint32_t       capacity = 0;
+    uint32_t       missing  = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(table);
+    for (int idx = 0; idx < MANY_KEYS; idx++)
+    {
+        keys[idx] = idx;
+        CU_ASSERT_EQUAL_FATAL(hash_table_insert(table, &keys[idx], &keys[idx]),
+                              E_SUCCESS);
+        if (capacity != table->capacity)
+        {
+            // Capacity only doubles, and the table stays under 7/8 full
+            CU_ASSERT((0 == capacity) || (capacity * 2 == table->capacity));
+            capacity = table->capacity;
+        }
+        CU_ASSERT(table->size <= table->capacity - (table->capacity / 8));
+    }
+    CU_ASSERT_EQUAL(hash_table_size(table), MANY_KEYS);
+    for (int idx = 0; idx < MANY_KEYS; idx++)
+    {
+        missing += (&keys[idx] != hash_table_lookup(table, &keys[idx]));
+    }
+    CU_ASSERT_EQUAL(missing, 0);
+
+    hash_table_delete(&table);
+}
+
+void test_hash_table_reserve(void)
+{
+    hash_table_t * table = hash_table_new(hash_int, int_comp, NULL, NULL);
+    int8_t *       ctrl  = NULL;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(table);
+    CU_ASSERT_EQUAL_FATAL(hash_table_reserve(table, 1000), E_SUCCESS);
+    ctrl = table->ctrl;
+    for (int idx = 0; idx < 1000; idx++)
+    {
+        keys[idx] = idx;
+        hash_table_insert(table, &keys[idx], &keys[idx]);
+    }
+    CU_ASSERT_PTR_EQUAL(table->ctrl, ctrl);
+    CU_ASSERT_EQUAL(hash_table_size(table), 1000);
+
+    hash_table_delete(&table);
+}
+
+void test_hash_table_churn(void)
+{
+    hash_table_t * table = hash_table_new(hash_int, int_comp, NULL, NULL);
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(table);
+    // Few live keys but many removals: tombstones are cleared by rebuilding
+    // at the same size rather than by growing
+    for (int idx = 0; idx < MANY_KEYS; idx++)
+    {
+        keys[idx] = idx;
+        hash_table_insert(table, &keys[idx], &keys[idx]);
+        if (4 <= idx)
+        {
+            CU_ASSERT_EQUAL(hash_table_remove(table, &keys[idx - 4]),
+                            E_SUCCESS);
+        }
+    }
+    CU_ASSERT_EQUAL(hash_table_size(table), 4);
+    CU_ASSERT_EQUAL(table->capacity, HASH_TABLE_MIN_CAPACITY);
+    for (int idx = MANY_KEYS - 4; idx < MANY_KEYS; idx++)
+    {
+        CU_ASSERT_PTR_EQUAL(hash_table_lookup(table, &keys[idx]), &keys[idx]);
+    }
+
+    hash_table_delete(&table);
+}
+
+void test_hash_table_incremental(void)
+{
+    hash_table_t * table = hash_table_new(hash_int, int_comp, NULL, NULL);
+    uint32_t       missing = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(table);
+    CU_ASSERT_EQUAL(hash_table_set_incremental(table, true), E_SUCCESS);
+    for (int idx = 0; idx < MANY_KEYS; idx++)
+    {
+        keys[idx] = idx;
+        // An insert that may start a rebuild only has one step of the spare
+        // control bytes left to set
+        if ((0 < table->capacity) && (0 == table->growth_left))
+        {
+            CU_ASSERT_PTR_NOT_NULL_FATAL(table->spare_ctrl);
+            CU_ASSERT(table->spare_ready + HASH_TABLE_SPARE_STEP
+                      >= table->spare_size);
+        }
+        CU_ASSERT_EQUAL_FATAL(hash_table_insert(table, &keys[idx], &keys[idx]),
+                              E_SUCCESS);
+        // Keys still in the old table must stay visible mid-migration
+        if (0 == (idx % 1000))
+        {
+            for (int check = 0; check <= idx; check += 97)
+            {
+                missing += !hash_table_contains(table, &keys[check]);
+            }
+        }
+    }
+    CU_ASSERT_EQUAL(missing, 0);
+    CU_ASSERT_EQUAL(hash_table_size(table), MANY_KEYS);
+
+    CU_ASSERT_EQUAL(hash_table_set_incremental(table, false), E_SUCCESS);
+    CU_ASSERT_PTR_NULL(table->old);
+    CU_ASSERT_EQUAL(table->size, MANY_KEYS);
+
+    hash_table_delete(&table);
+}
+
+int main(void)
+{
+    int       exit_code = EXIT_FAILURE;
+    CU_pSuite suite     = NULL;
+
+    if (CUE_SUCCESS != CU_initialize_registry())
+    {
+        return CU_get_error();
+    }
+
+    suite = CU_add_suite("hash_table", NULL, NULL);
+    if (NULL == suite)
+    {
+        goto END;
+    }
+
+    if ((NULL == CU_add_test(suite, "basic", test_hash_table_basic)) ||
+        (NULL == CU_add_test(suite,
+                             "erase to empty",
+                             test_hash_table_erase_to_empty)) ||
+        (NULL == CU_add_test(suite,
+                             "tombstone reuse",
+                             test_hash_table_tombstone_reuse)) ||
+        (NULL == CU_add_test(suite, "growth", test_hash_table_growth)) ||
+        (NULL == CU_add_test(suite, "reserve", test_hash_table_reserve)) ||
+        (NULL == CU_add_test(suite, "churn", test_hash_table_churn)) ||
+        (NULL == CU_add_test(suite,
+                             "incremental",
+                             test_hash_table_incremental)))
+    {
+        goto END;
+    }
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    if (0 == CU_get_number_of_failures())
+    {
+        exit_code = EXIT_SUCCESS;
+    }
+
+END:
+    CU_cleanup_registry();
+    return exit_code;
+}
+
+/****************************************************************************/
+/*                 NOTE: STATIC FUNCTIONS LISTED BELOW                      */
+/****************************************************************************/
+
+static uint64_t hash_collide(void * key)
+{
+    (void)key;
+    return 0;
+}
+
+static uint32_t slot_of(hash_table_t * table, void * key)
+{
+    for (uint32_t idx = 0; idx < table->capacity; idx++)
+    {
+        if (key == table->slots[idx].key)
+        {
+            return idx;
+        }
+    }
+    return UINT32_MAX;
+}
+
+static int * new_int(int value)
+{
+    int * new_value = malloc(sizeof(*new_value));
+
+    if (NULL != new_value)
+    {
+        *new_value = value;
+    }
+    return new_value;
+}
+
+/*** end of file ***/
@@ -0,0 +1,330 @@
+/** @file queue_tests.c
+ *
+ * @brief Tests for the lock-free queue, ending with a stress test of many
+ * producers and consumers at once.
+ */
+#include <CUnit/Basic.h>
+#include <pthread.h>
+
+#include "queue.h"
+#include "utilities.h"
+
+#define STRESS_PRODUCERS 16
+#define STRESS_CONSUMERS 16
+#define STRESS_ITEMS     50000 // Items enqueued by each producer
+#define STRESS_TOTAL     (STRESS_PRODUCERS * STRESS_ITEMS)
+
+/**
+ * @brief State shared by the stress test threads.
+ *
+ * @param queue queue under test
+ * @param consumed number of items dequeued so far
+ * @param seen how many times each item was dequeued
+ * @param errors number of ordering errors the consumers found
+ */
+static struct
+{
+    queue_t *    queue;
+    atomic_uint  consumed;
+    atomic_uchar seen[STRESS_TOTAL];
+    atomic_uint  errors;
+} stress;
+
+/**
+ * @brief Packs a producer number and a sequence number into a non-NULL item.
+ *
+ * @param producer Number of the producer.
+ * @param sequence Position of the item among the producer's items.
+ * @return The item.
+ */
+static void * stress_item(uint32_t producer, uint32_t sequence);
+
+/**
+ * @brief Enqueues STRESS_ITEMS items in order, alternating single enqueues
+ * with batches.
+ *
+ * @param arg Number of the producer.
+ * @return NULL.
+ */
+static void * stress_producer(void * arg);
+
+/**
+ * @brief Dequeues until every item has been consumed, checking that items of
+ * each producer arrive in the order they were enqueued.
+ *
+ * @param arg Unused.
+ * @return NULL.
+ */
+static void * stress_consumer(void * arg);
+
+/**
+ * @brief Frees an item allocated by a test.
+ *
+ * @param data Pointer to the item.
+ */
+static void free_item(void * data);
+
+void test_queue_fifo(void)
+{
+    queue_t * queue    = queue_new(NULL);
+    int       values[] = { 1, 2, 3, 4, 5 };
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(queue);
+    CU_ASSERT_TRUE(queue_is_empty(queue));
+    CU_ASSERT_PTR_NULL(queue_dequeue(queue));
+
+    for (int idx = 0; idx < 5; idx++)
+    {
+        CU_ASSERT_EQUAL(queue_enqueue(queue, &values[idx]), E_SUCCESS);
+    }
+    CU_ASSERT_FALSE(queue_is_empty(queue));
+    for (int idx = 0; idx < 5; idx++)
+    {
+        CU_ASSERT_PTR_EQUAL(queue_dequeue(queue), &values[idx]);
+    }
+    CU_ASSERT_TRUE(queue_is_empty(queue));
+    CU_ASSERT_PTR_NULL(queue_dequeue(queue));
+
+    CU_ASSERT_EQUAL(queue_delete(&queue), E_SUCCESS);
+    CU_ASSERT_PTR_NULL(queue);
+}
+
+void test_queue_batch(void)
+{
+    queue_t * queue = queue_new(NULL);
+    int       values[10];
+    void *    items[10];
+    void *    out[10];
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(queue);
+    for (int idx = 0; idx < 10; idx++)
+    {
+        items[idx] = &values[idx];
+    }
+
+    CU_ASSERT_EQUAL(queue_enqueue(queue, items[0]), E_SUCCESS);
+    CU_ASSERT_EQUAL(queue_enqueue_batch(queue, &items[1], 9), E_SUCCESS);
+    CU_ASSERT_EQUAL(queue_dequeue_batch(queue, out, 4), 4);
+    CU_ASSERT_EQUAL(queue_dequeue_batch(queue, &out[4], 10), 6);
+    CU_ASSERT_EQUAL(queue_dequeue_batch(queue, out, 10), 0);
+    for (int idx = 0; idx < 10; idx++)
+    {
+        CU_ASSERT_PTR_EQUAL(out[idx], items[idx]);
+    }
+
+    queue_delete(&queue);
+}
+
+void test_queue_invalid_arguments(void)
+{
+    queue_t * queue    = queue_new(NULL);
+    int       value    = 0;
+    void *    items[2] = { &value, NULL };
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(queue);
+    CU_ASSERT_NOT_EQUAL(queue_enqueue(NULL, &value), E_SUCCESS);
+    CU_ASSERT_NOT_EQUAL(queue_enqueue(queue, NULL), E_SUCCESS);
+    CU_ASSERT_NOT_EQUAL(queue_enqueue_batch(queue, items, 2), E_SUCCESS);
+    CU_ASSERT_TRUE(queue_is_empty(queue));
+    CU_ASSERT_PTR_NULL(queue_dequeue(NULL));
+    CU_ASSERT_EQUAL(queue_dequeue_batch(NULL, items, 2), -1);
+    CU_ASSERT_NOT_EQUAL(queue_delete(NULL), E_SUCCESS);
+
+    queue_delete(&queue);
+}
+
+void test_queue_clear_frees_items(void)
+{
+    queue_t * queue = queue_new(free_item);
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(queue);
+    for (int idx = 0; idx < 100; idx++)
+    {
+        int * value = malloc(sizeof(*value));
+        CU_ASSERT_PTR_NOT_NULL_FATAL(value);
+        *value = idx;
+        CU_ASSERT_EQUAL(queue_enqueue(queue, value), E_SUCCESS);
+    }
+    CU_ASSERT_EQUAL(queue_clear(queue), E_SUCCESS);
+    CU_ASSERT_TRUE(queue_is_empty(queue));
+
+    // Items left at deletion are freed too
+    int * value = malloc(sizeof(*value));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(value);
+    CU_ASSERT_EQUAL(queue_enqueue(queue, value), E_SUCCESS);
+    CU_ASSERT_EQUAL(queue_delete(&queue), E_SUCCESS);
+}
+
+void test_queue_stress(void)
+{
+    pthread_t producers[STRESS_PRODUCERS];
+    pthread_t consumers[STRESS_CONSUMERS];
+
+    stress.queue = queue_new(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(stress.queue);
+    atomic_store(&stress.consumed, 0);
+    atomic_store(&stress.errors, 0);
+    for (uint32_t idx = 0; idx < STRESS_TOTAL; idx++)
+    {
+        atomic_store(&stress.seen[idx], 0);
+    }
+
+    for (uintptr_t idx = 0; idx < STRESS_CONSUMERS; idx++)
+    {
+        CU_ASSERT_FATAL(0 == pthread_create(&consumers[idx],
+                                            NULL,
+                                            stress_consumer,
+                                            NULL));
+    }
+    for (uintptr_t idx = 0; idx < STRESS_PRODUCERS; idx++)
+    {
+        CU_ASSERT_FATAL(0 == pthread_create(&producers[idx],
+                                            NULL,
+                                            stress_producer,
+                                            (void *)idx));
+    }
+    for (int idx = 0; idx < STRESS_PRODUCERS; idx++)
+    {
+        pthread_join(producers[idx], NULL);
+    }
+    for (int idx = 0; idx < STRESS_CONSUMERS; idx++)
+    {
+        pthread_join(consumers[idx], NULL);
+    }
+
+    CU_ASSERT_EQUAL(atomic_load(&stress.consumed), STRESS_TOTAL);
+    CU_ASSERT_EQUAL(atomic_load(&stress.errors), 0);
+    uint32_t missing = 0;
+    for (uint32_t idx = 0; idx < STRESS_TOTAL; idx++)
+    {
+        missing += (1 != atomic_load(&stress.seen[idx]));
+    }
+    CU_ASSERT_EQUAL(missing, 0);
+    CU_ASSERT_TRUE(queue_is_empty(stress.queue));
+
+    queue_delete(&stress.queue);
+}
+
+int main(void)
+{
+    int       exit_code = EXIT_FAILURE;
+    CU_pSuite suite     = NULL;
+
+    if (CUE_SUCCESS != CU_initialize_registry())
+    {
+        return CU_get_error();
+    }
+
+    suite = CU_add_suite("queue", NULL, NULL);
+    if (NULL == suite)
+    {
+        goto END;
+    }
+
+    if ((NULL == CU_add_test(suite, "fifo order", test_queue_fifo)) ||
+        (NULL == CU_add_test(suite, "batches", test_queue_batch)) ||
+        (NULL == CU_add_test(suite,
+                             "invalid arguments",
+                             test_queue_invalid_arguments)) ||
+        (NULL == CU_add_test(suite,
+                             "clear frees items",
+                             test_queue_clear_frees_items)) ||
+        (NULL == CU_add_test(suite, "mpmc stress", test_queue_stress)))
+    {
+        goto END;
+    }
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    if (0 == CU_get_number_of_failures())
+    {
+        exit_code = EXIT_SUCCESS;
+    }
+
+END:
+    CU_cleanup_registry();
+    return exit_code;
+}
+
+/****************************************************************************/
+/*                 NOTE: STATIC FUNCTIONS LISTED BELOW                      */
+/****************************************************************************/
+
+static void * stress_item(uint32_t producer, uint32_t sequence)
+{
+    // Sequence numbers start at 1 so no item is NULL
+    return (void *)(((uintptr_t)producer << 24) | (sequence + 1));
+}
+
+static void * stress_producer(void * arg)
+{
+    uint32_t producer = (uint32_t)(uintptr_t)arg;
+    void *   batch[8];
+    uint32_t sequence = 0;
+
+    while (sequence < STRESS_ITEMS)
+    {
+        if ((sequence % 2) || (STRESS_ITEMS - sequence < 8))
+        {
+            while (E_SUCCESS !=
+                   queue_enqueue(stress.queue, stress_item(producer, sequence)))
+            {
+            }
+            sequence++;
+            continue;
+        }
+
+        for (uint32_t idx = 0; idx < 8; idx++)
+        {
+            batch[idx] = stress_item(producer, sequence + idx);
+        }
+        while (E_SUCCESS != queue_enqueue_batch(stress.queue, batch, 8))
+        {
+        }
+        sequence += 8;
+    }
+
+    return NULL;
+}
+
+static void * stress_consumer(void * arg)
+{
+    (void)arg;
+    uint32_t last[STRESS_PRODUCERS] = { 0 };
+    void *   batch[4];
+
+    while (STRESS_TOTAL > atomic_load(&stress.consumed))
+    {
+        int count = queue_dequeue_batch(stress.queue, batch, 4);
+
+        for (int idx = 0; idx < count; idx++)
+        {
+            uintptr_t item     = (uintptr_t)batch[idx];
+            uint32_t  producer = (uint32_t)(item >> 24);
+            uint32_t  sequence = (uint32_t)(item & 0xffffff);
+
+            // One consumer sees each producer's items in increasing order
+            if ((STRESS_PRODUCERS <= producer) || (sequence <= last[producer]))
+            {
+                atomic_fetch_add(&stress.errors, 1);
+                continue;
+            }
+            last[producer] = sequence--;
+            atomic_fetch_add(&stress.seen[(producer * STRESS_ITEMS) + sequence],
+                             1);
+        }
+        if (0 < count)
+        {
+            atomic_fetch_add(&stress.consumed, (unsigned int)count);
+        }
+    }
+
+    return NULL;
+}
+
+static void free_item(void * data)
+{
+    free(data);
+}
+
+/*** end of file ***/